@@ -0,0 +1,72 @@
+import glob
+import os
+import struct
+import subprocess
+
+Import("env")
+
+# Precompile data/lua/*.lua into stripped bytecode (.luac) before the
+# filesystem image is built. Each .luac starts with a small header holding
+# the hash and size of its source, so the device only uses it while it is
+# current.
+
+PROJECT_DIR = env.subst("$PROJECT_DIR")
+LUA_SRC_DIR = os.path.join(PROJECT_DIR, "lib", "lua")
+SCRIPTS_DIR = os.path.join(PROJECT_DIR, "data", "lua")
+LUAC = os.path.join(env.subst("$BUILD_DIR"), "host_luac", "luac")
+
+# Must match LUAC_CACHE_MAGIC in src/lua_loader.h
+LUAC_CACHE_MAGIC = b"MPL3"
+
+
+def fnv1a32(data):
+    h = 0x811C9DC5
+    for b in bytearray(data):
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def build_host_luac():
+    # Built from the bundled sources so luaconf.h (LUA_32BITS) gives the
+    # same integer/float layout as the firmware
+    sources = [s for s in glob.glob(os.path.join(LUA_SRC_DIR, "*.c"))
+               if os.path.basename(s) not in ("lua.c", "onelua.c")]
+    newest = max(os.path.getmtime(s) for s in sources +
+                 glob.glob(os.path.join(LUA_SRC_DIR, "*.h")))
+    if os.path.exists(LUAC) and os.path.getmtime(LUAC) >= newest:
+        return True
+
+    os.makedirs(os.path.dirname(LUAC), exist_ok=True)
+    print("Building host luac...")
+    cmd = ["gcc", "-std=gnu99", "-O2", "-o", LUAC] + sources + ["-lm"]
+    return subprocess.call(cmd) == 0
+
+
+def compile_scripts(source, target, env):
+    if not build_host_luac():
+        print("Failed to build host luac, scripts will be compiled on device")
+        return
+
+    for script in glob.glob(os.path.join(SCRIPTS_DIR, "*.lua")):
+        output = os.path.splitext(script)[0] + ".luac"
+        with open(script, "rb") as f:
+            text = f.read()
+        source_hash = fnv1a32(text)
+
+        chunk = output + ".tmp"
+        if subprocess.call([LUAC, "-s", "-o", chunk, script]) != 0:
+            print("Failed to compile %s" % script)
+            continue
+
+        with open(chunk, "rb") as f:
+            data = f.read()
+        os.remove(chunk)
+
+        with open(output, "wb") as f:
+            f.write(LUAC_CACHE_MAGIC +
+                    struct.pack("<II", source_hash, len(text)) + data)
+        print("Compiled %s (%d bytes)" % (os.path.relpath(output, PROJECT_DIR),
+                                          len(data)))
+
+
+env.AddPreAction("$BUILD_DIR/${ESP32_FS_IMAGE_NAME}.bin", compile_scripts)
@@ -54,41 +54,25 @@ root:set {
 --     align = lvgl.ALIGN.CENTER
 -- }        
 
-local message_view = root:Object {
-    flex = {
-        flex_direction = "column",
-        flex_wrap = "nowrap",
-        align = lvgl.ALIGN.TOP_LEFT,
-    },
+-- Only the visible rows exist as objects, they are rebound while scrolling
+local message_view = root:VirtualList {
     border_width = 0,
-    h = lvgl.PCT(100),
+    h = lvgl.VER_RES() - 55,
     w = lvgl.PCT(100),
-    pad_all = 0
+    pad_ver = 0,
+    pad_left = 10,
+    pad_right = 0,
+    pad_row = 12,
+    row_height = 28,
+    wrap = true,
+    bind = function(index, row)
+        return messages[index].text
+    end,
 }
 
 function update_message_list()
-    -- label:delete()
-    -- message_view:clear()
-
-    for _, message in ipairs(messages) do
-        local message_item = message_view:Object {
-            flex = {
-                flex_direction = "row",
-                justify = "space_between"
-            },
-            w = lvgl.PCT(100),
-            h = lvgl.SIZE_CONTENT,
-            border_width = 0,
-        }
-        message_item:clear_flag(lvgl.FLAG.SCROLLABLE)
-
-        message_item:Label {
-            text = message.text,
-            h = lvgl.SIZE_CONTENT,
-            w = lvgl.PCT(100),
-
-        }   
-    end
+    message_view.count = #messages
+    message_view:scroll_to_index(#messages)
 end
 
 update_message_list()
@@ -114,9 +98,9 @@ local ta = form:Textarea {
     one_line = true,
     placeholder = "Type a message...",
     w = lvgl.PCT(75),
-    h = 40,
     align = lvgl.ALIGN.LEFT_MID,
 }
+ta:set { h = 40 }
 
 ta:onevent(lvgl.EVENT.KEY, function(obj, code)
     local indev = lvgl.indev.get_act()
@@ -161,12 +145,9 @@ if false then
         duration = 1000,
         repeat_count = lvgl.ANIM_REPEAT_INFINITE,
         path = "ease_in_out",
+        exec_cb = lvgl.prop("size"),
     }
 
-    animPara.exec_cb = function(obj, value)
-        obj:set { size = value }
-    end
-
     obj:Anim(animPara)
 
     -- Return the root object
@@ -37,9 +37,7 @@ function utils.createNotification(parent, message, duration)
         end_value = -20,
         duration = 300,
         path = "ease_out",
-        exec_cb = function(obj, value)
-            obj:set { y = value }
-        end
+        exec_cb = lvgl.prop("y")
     }
     
     -- Auto-destroy after duration
@@ -0,0 +1,140 @@
+import argparse
+import os
+import re
+import sys
+
+# Derive the glyph_id_table of the built-in Montserrat fonts from their cmaps
+# and write it into the font sources, or check that the tables still match:
+#
+#   python3 font_glyph_ids.py [--check] [lv_font_*.c ...]
+#
+# The table maps U+0000..U+00FF to glyph IDs the way get_glyph_dsc_id() in
+# lv_font_fmt_txt.c would find them. Run it again after regenerating a font
+# with lv_font_conv, which drops the table.
+
+PROJECT_DIR = os.path.dirname(os.path.abspath(__file__))
+FONT_DIR = os.path.join(PROJECT_DIR, "lib", "lvgl", "src", "font")
+FONTS = ["lv_font_montserrat_12.c", "lv_font_montserrat_14.c",
+         "lv_font_montserrat_28.c"]
+
+# Must match glyph_id_table_len in the font descriptors
+TABLE_LEN = 256
+
+TABLE_COMMENT = "/*Glyph IDs of U+0000..U+00FF, the same as the cmaps give*/"
+TABLE_RE = re.compile(
+    re.escape(TABLE_COMMENT) +
+    r"\nstatic const uint16_t glyph_id_table\[\] = \{[^}]*\};\n\n")
+
+
+def c_array(source, name):
+    m = re.search(r"static const \w+ %s\[\] = \{([^}]*)\};" % name, source)
+    if not m:
+        raise ValueError("array %s not found" % name)
+    return [int(v, 0) for v in m.group(1).replace("\n", " ").split(",")
+            if v.strip()]
+
+
+def parse_cmaps(source):
+    m = re.search(r"static const lv_font_fmt_txt_cmap_t cmaps\[\] = \{(.*?)\n\};",
+                  source, re.S)
+    if not m:
+        raise ValueError("cmaps not found")
+    cmaps = []
+    for body in re.findall(r"\{([^{}]*)\}", m.group(1)):
+        fields = dict(re.findall(r"\.(\w+) = ([\w]+)", body))
+        cmap = {
+            "start": int(fields["range_start"], 0),
+            "length": int(fields["range_length"], 0),
+            "glyph_id_start": int(fields["glyph_id_start"], 0),
+            "type": fields["type"].replace("LV_FONT_FMT_TXT_CMAP_", ""),
+            "unicode_list": None,
+            "glyph_id_ofs_list": None,
+        }
+        for key in ("unicode_list", "glyph_id_ofs_list"):
+            if fields[key] != "NULL":
+                cmap[key] = c_array(source, fields[key])
+        cmaps.append(cmap)
+    return cmaps
+
+
+# get_glyph_dsc_id() without the table: the first cmap whose range holds the
+# letter decides, even if the letter is missing from its list
+def glyph_id(cmaps, letter):
+    if letter == 0:
+        return 0
+    for cmap in cmaps:
+        rcp = letter - cmap["start"]
+        if rcp < 0 or rcp >= cmap["length"]:
+            continue
+        if cmap["type"] == "FORMAT0_TINY":
+            return cmap["glyph_id_start"] + rcp
+        if cmap["type"] == "FORMAT0_FULL":
+            return cmap["glyph_id_start"] + cmap["glyph_id_ofs_list"][rcp]
+        if rcp not in cmap["unicode_list"]:
+            return 0
+        ofs = cmap["unicode_list"].index(rcp)
+        if cmap["type"] == "SPARSE_TINY":
+            return cmap["glyph_id_start"] + ofs
+        return cmap["glyph_id_start"] + cmap["glyph_id_ofs_list"][ofs]
+    return 0
+
+
+def format_table(ids):
+    rows = [", ".join(str(i) for i in ids[r:r + 16])
+            for r in range(0, len(ids), 16)]
+    return (TABLE_COMMENT + "\nstatic const uint16_t glyph_id_table[] = {\n" +
+            ",\n".join("    " + row for row in rows) + "\n};\n\n")
+
+
+def update(path, check):
+    with open(path) as f:
+        source = f.read()
+    cmaps = parse_cmaps(source)
+    table = format_table([glyph_id(cmaps, cp) for cp in range(TABLE_LEN)])
+
+    current = TABLE_RE.search(source)
+    if check:
+        if not current:
+            print("%s: no glyph_id_table" % path)
+            return False
+        if current.group(0) != table:
+            print("%s: glyph_id_table differs from the cmaps" % path)
+            return False
+        return True
+
+    if current:
+        source = source[:current.start()] + table + source[current.end():]
+    else:
+        kerning = source.index("/*-----------------\n *    KERNING")
+        source = source[:kerning] + table + source[kerning:]
+    if ".glyph_id_table = " not in source:
+        source = source.replace(
+            "    .bitmap_format = 0,\n",
+            "    .bitmap_format = 0,\n"
+            "    .glyph_id_table = glyph_id_table,\n"
+            "    .glyph_id_table_len = %d,\n" % TABLE_LEN, 1)
+    with open(path, "w") as f:
+        f.write(source)
+    print("Wrote the glyph_id_table of %s" % os.path.relpath(path, PROJECT_DIR))
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Generate or check the glyph_id_table of LVGL fonts")
+    parser.add_argument("--check", action="store_true",
+                        help="only check that the tables match the cmaps")
+    parser.add_argument("fonts", nargs="*",
+                        default=[os.path.join(FONT_DIR, f) for f in FONTS])
+    args = parser.parse_args()
+
+    ok = True
+    for path in args.fonts:
+        ok = update(path, args.check) and ok
+    if args.check and ok:
+        print("%d glyph_id_tables match their cmaps" % len(args.fonts))
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
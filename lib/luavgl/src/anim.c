@@ -19,6 +19,10 @@ typedef struct luavgl_anim_s {
   int done_cb;
   int self_ref; /* ref in registry to this anim */
   bool deleted; /* manually deleted from lua */
+
+  /* exec_cb = lvgl.prop(name): the style of lobj is set without calling lua */
+  const struct style_map_s *prop;
+  luavgl_obj_t *lobj; /* kept alive by obj_ref */
 } luavgl_anim_t;
 
 typedef luavgl_anim_t *luavgl_anim_handle_t;
@@ -54,6 +58,17 @@ static void luavgl_anim_exec_cb(void *var, int32_t value)
   luavgl_pcall_int(L, 2, 0);
 }
 
+static void luavgl_anim_prop_exec_cb(void *var, int32_t value)
+{
+  luavgl_anim_t *a = var;
+
+  /* object deleted while the anim runs */
+  if (a->lobj->obj == NULL)
+    return;
+
+  luavgl_obj_set_prop(a->lobj->obj, a->prop, value, 0);
+}
+
 /* callback when anim is deleted by lvgl */
 static void luavgl_anim_delete_cb(lv_anim_t *_a)
 {
@@ -151,7 +166,7 @@ static int luavgl_anim_stop(lua_State *L)
     return 0;
   }
 
-  lv_anim_del(a, luavgl_anim_exec_cb);
+  lv_anim_del(a, a->cfg.exec_cb);
 
   /* work done in luavgl_anim_delete_cb */
   return 0;
@@ -213,9 +228,23 @@ static int luavgl_anim_set(lua_State *L)
   lv_anim_t *cfg = &a->cfg;
 
   lua_getfield(L, 2, "exec_cb");
-  if (!lua_isnoneornil(L, -1)) {
+  if (luavgl_to_prop(L, -1)) {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, a->obj_ref);
+    a->lobj = luavgl_test_obj(L, -1);
+    lua_pop(L, 1);
+    if (a->lobj == NULL) {
+      return luaL_argerror(L, 2, "exec_cb from lvgl.prop() needs an obj");
+    }
+
+    luaL_unref(L, LUA_REGISTRYINDEX, a->exec_cb);
+    a->exec_cb = LUA_NOREF;
+    a->prop = luavgl_to_prop(L, -1);
+    cfg->exec_cb = luavgl_anim_prop_exec_cb;
+  } else if (!lua_isnoneornil(L, -1)) {
     luaL_unref(L, LUA_REGISTRYINDEX, a->exec_cb);
     a->exec_cb = luavgl_check_continuation(L, -1);
+    a->prop = NULL;
+    cfg->exec_cb = luavgl_anim_exec_cb;
   }
   lua_pop(L, 1);
 
@@ -243,6 +272,7 @@ static int luavgl_anim_set(lua_State *L)
  * a = obj:Anim({anim parameters})
  * a = obj:Anim{anim parameters}
  * a = lvgl.Anim(var, anim_para)
+ * a = obj:Anim{exec_cb = lvgl.prop("y"), ...}, animates a style of obj
  *
  * a:start()
  */
@@ -268,6 +298,8 @@ static int luavgl_anim_create(lua_State *L)
   a->aa = NULL;
   a->L = L;
   a->deleted = false;
+  a->prop = NULL;
+  a->lobj = NULL;
 
   lv_anim_t *cfg = &a->cfg;
   lv_anim_init(cfg);
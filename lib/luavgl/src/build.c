@@ -0,0 +1,375 @@
+#include "luavgl.h"
+#include "private.h"
+
+/**
+ * Build a widget tree from a nested table in one call:
+ *
+ * local root, ids = lvgl.build(parent, {
+ *   type = "Object", w = lvgl.PCT(100), flex = {...},
+ *   { type = "Label", text = "hello", id = "title" },
+ *   { type = "Button", on = { [lvgl.EVENT.CLICKED] = function(obj, code) end },
+ *     { type = "Label", text = "OK" },
+ *   },
+ * })
+ *
+ * The array part of a node holds its children. Objects are only added to lua
+ * if they are the root, have an `id`, `user_data` or `on` callbacks; the rest
+ * live as plain lvgl children of their parent. `ids` maps each id to its
+ * object. parent may be omitted.
+ *
+ * Each property name is resolved once per widget type and call, so rows
+ * built from the same keys share the lookups. Styles set on a node are
+ * refreshed once, after all its properties were applied.
+ */
+
+typedef lv_obj_t *(*build_create_t)(lv_obj_t *parent);
+
+static const struct build_type_s {
+  const char *name;
+  build_create_t create;
+  const lv_obj_class_t *clz; /* what create() makes */
+} build_types[] = {
+    {"Object",      lv_obj_create,           &lv_obj_class        },
+#if LV_USE_BUTTON
+    {"Button",      lv_button_create,        &lv_button_class     },
+#endif
+#if LV_USE_CALENDAR
+    {"Calendar",    lv_calendar_create,      &lv_calendar_class   },
+#endif
+#if LV_USE_CHECKBOX
+    {"Checkbox",    lv_checkbox_create,      &lv_checkbox_class   },
+#endif
+#if LV_USE_DROPDOWN
+    {"Dropdown",    lv_dropdown_create,      &lv_dropdown_class   },
+#endif
+#if LV_USE_IMAGE
+    {"Image",       lv_image_create,         &lv_image_class      },
+#endif
+#if LV_USE_KEYBOARD
+    {"Keyboard",    lv_keyboard_create,      &lv_keyboard_class   },
+#endif
+#if LV_USE_LABEL
+    {"Label",       lv_label_create,         &lv_label_class      },
+#endif
+#if LV_USE_LED
+    {"Led",         lv_led_create,           &lv_led_class        },
+#endif
+#if LV_USE_LIST
+    {"List",        lv_list_create,          &lv_list_class       },
+#endif
+#if LV_USE_ROLLER
+    {"Roller",      lv_roller_create,        &lv_roller_class     },
+#endif
+#if LV_USE_TEXTAREA
+    {"Textarea",    lv_textarea_create,      &lv_textarea_class   },
+#endif
+#if LV_USE_LABEL
+    {"VirtualList", luavgl_vlist_create_obj, &luavgl_vlist_class  },
+#endif
+};
+
+#define BUILD_TYPES_LEN (sizeof(build_types) / sizeof(build_types[0]))
+
+/* How a property name of a node is applied */
+enum build_key_kind {
+  BUILD_KEY_UNKNOWN,
+  BUILD_KEY_TYPE,
+  BUILD_KEY_ON,
+  BUILD_KEY_USER_DATA,
+  BUILD_KEY_ID,
+  BUILD_KEY_OPS,   /* luavgl class property */
+  BUILD_KEY_LVGL,  /* lvgl class or style property id */
+  BUILD_KEY_STYLE, /* luavgl style name */
+};
+
+struct build_key_s {
+  enum build_key_kind kind;
+  union {
+    const luavgl_property_ops_t *ops;
+    lv_prop_id_t id;
+    const struct style_map_s *style;
+  };
+};
+
+static const struct build_type_s *build_find_type(const char *name)
+{
+  for (int i = 0; i < BUILD_TYPES_LEN; i++) {
+    if (lv_strcmp(build_types[i].name, name) == 0)
+      return &build_types[i];
+  }
+
+  return NULL;
+}
+
+/* Type of the node at stack[node], checked by build_check_node() */
+static const struct build_type_s *build_node_type(lua_State *L, int node)
+{
+  const struct build_type_s *type = &build_types[0];
+  if (lua_getfield(L, node, "type") == LUA_TSTRING)
+    type = build_find_type(lua_tostring(L, -1));
+  lua_pop(L, 1);
+  return type;
+}
+
+/* Resolve name the way obj_property() does for a set */
+static void build_resolve_key(lua_State *L, const lv_obj_class_t *clz,
+                              const char *name, struct build_key_s *key)
+{
+  static const struct {
+    const char *name;
+    enum build_key_kind kind;
+  } own_keys[] = {
+      {"type",      BUILD_KEY_TYPE     },
+      {"on",        BUILD_KEY_ON       },
+      {"user_data", BUILD_KEY_USER_DATA},
+      {"id",        BUILD_KEY_ID       },
+  };
+
+  for (int i = 0; i < sizeof(own_keys) / sizeof(own_keys[0]); i++) {
+    if (lv_strcmp(name, own_keys[i].name) == 0) {
+      key->kind = own_keys[i].kind;
+      return;
+    }
+  }
+
+  const luavgl_property_ops_t *ops = NULL;
+  lv_prop_id_t id = LV_PROPERTY_ID_INVALID;
+  obj_property_resolve(L, clz, name, &ops, &id);
+  if (ops) {
+    key->kind = BUILD_KEY_OPS;
+    key->ops = ops;
+    return;
+  }
+
+  if (id == LV_PROPERTY_ID_INVALID) {
+    key->style = luavgl_style_find(name);
+    if (key->style) {
+      key->kind = BUILD_KEY_STYLE;
+      return;
+    }
+    id = lv_style_property_get_id(name);
+  }
+
+  key->kind = id != LV_PROPERTY_ID_INVALID ? BUILD_KEY_LVGL : BUILD_KEY_UNKNOWN;
+  key->id = id;
+}
+
+/* Push stack[keys][clz], the names resolved for that type in this call */
+static void build_keys_push(lua_State *L, int keys, const lv_obj_class_t *clz)
+{
+  if (lua_rawgetp(L, keys, clz) != LUA_TTABLE) {
+    lua_pop(L, 1);
+    lua_newtable(L);
+    lua_pushvalue(L, -1);
+    lua_rawsetp(L, keys, clz);
+  }
+}
+
+/**
+ * Check the types and children of the node at stack[node] and below, so an
+ * error is raised before anything is created. Resolves the property names
+ * of each type into stack[keys].
+ */
+static void build_check_node(lua_State *L, int node, int keys)
+{
+  luaL_checkstack(L, 8, "widget tree too deep");
+
+  int t = lua_getfield(L, node, "type");
+  const struct build_type_s *type = &build_types[0];
+  if (t != LUA_TNIL) {
+    type = t == LUA_TSTRING ? build_find_type(lua_tostring(L, -1)) : NULL;
+    if (type == NULL)
+      luaL_error(L, "unknown widget type: %s", luaL_tolstring(L, -1, NULL));
+  }
+  lua_pop(L, 1);
+
+  build_keys_push(L, keys, type->clz);
+  int resolved = lua_gettop(L);
+  lua_pushnil(L);
+  while (lua_next(L, node)) {
+    /* -1: value, -2: key */
+    lua_pop(L, 1);
+    if (lua_type(L, -1) != LUA_TSTRING)
+      continue;
+
+    lua_pushvalue(L, -1);
+    if (lua_rawget(L, resolved) == LUA_TNIL) {
+      struct build_key_s *key = lua_newuserdatauv(L, sizeof(*key), 0);
+      build_resolve_key(L, type->clz, lua_tostring(L, -3), key);
+      lua_pushvalue(L, -3);
+      lua_pushvalue(L, -2);
+      lua_rawset(L, resolved);
+      lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+  }
+  lua_pop(L, 1);
+
+  int n = lua_rawlen(L, node);
+  for (int i = 1; i <= n; i++) {
+    if (lua_rawgeti(L, node, i) != LUA_TTABLE)
+      luaL_error(L, "child %d is not a table", i);
+    build_check_node(L, lua_gettop(L), keys);
+    lua_pop(L, 1);
+  }
+}
+
+/**
+ * Create the node at stack[node] under parent, then its children.
+ * stack[ids] is the id table returned to lua, stack[keys] the names resolved
+ * by build_check_node(). The root node stores its object to root_res as soon
+ * as it is created and leaves its userdata on stack.
+ */
+static void build_node(lua_State *L, lv_obj_t *parent, int node, int ids,
+                       int keys, lv_obj_t **root_res)
+{
+  luaL_checkstack(L, 8, "widget tree too deep");
+
+  const struct build_type_s *type = build_node_type(L, node);
+  lv_obj_t *obj = type->create(parent);
+  if (root_res)
+    *root_res = obj;
+
+  /* Only nodes lua needs to reach get a userdata. */
+  int top = lua_gettop(L);
+  bool lua_visible = root_res || lua_getfield(L, node, "id") != LUA_TNIL ||
+                     lua_getfield(L, node, "user_data") != LUA_TNIL ||
+                     lua_getfield(L, node, "on") != LUA_TNIL;
+  lua_settop(L, top);
+
+  int lobj = 0;
+  if (lua_visible) {
+    luavgl_add_lobj(L, obj)->lua_created = true;
+    lobj = lua_gettop(L);
+  }
+
+  lua_rawgetp(L, keys, type->clz);
+  int resolved = lua_gettop(L);
+
+  /* Creating the object refreshed its styles, apply all properties before
+   * refreshing them again. Creating an object turns refreshing back on. */
+  lv_obj_enable_style_refresh(false);
+
+  lua_pushnil(L);
+  while (lua_next(L, node)) {
+    /* -1: value, -2: key */
+    if (lua_type(L, -2) != LUA_TSTRING) {
+      lua_pop(L, 1);
+      continue;
+    }
+
+    lua_pushvalue(L, -2);
+    lua_rawget(L, resolved);
+    const struct build_key_s *key = lua_touserdata(L, -1);
+    lua_pop(L, 1);
+
+    if (key->kind == BUILD_KEY_ON) {
+      /* on = { [code] = callback }, added as obj:onevent(code, callback) */
+      lua_pushnil(L);
+      while (lua_next(L, -2)) {
+        lua_pushcfunction(L, luavgl_obj_on_event);
+        lua_pushvalue(L, lobj);
+        lua_pushvalue(L, -4); /* code */
+        lua_pushvalue(L, -4); /* callback */
+        lua_call(L, 3, 0);
+        lua_pop(L, 1);
+      }
+    } else if (key->kind == BUILD_KEY_USER_DATA) {
+      lua_pushvalue(L, -1);
+      lua_setuservalue(L, lobj);
+    } else if (key->kind == BUILD_KEY_ID) {
+      if (lua_type(L, -1) == LUA_TSTRING) {
+        lua_pushvalue(L, -1);
+        lua_pushvalue(L, lobj);
+        lua_rawset(L, ids);
+      }
+    } else if (key->kind == BUILD_KEY_UNKNOWN) {
+      LV_LOG_WARN("unknown property %s for %s", lua_tostring(L, -2),
+                  type->name);
+    } else if (key->kind != BUILD_KEY_TYPE) {
+      /* Setters expect the name at -2 and the value at -1 */
+      int before = lua_gettop(L);
+      lua_pushvalue(L, -2);
+      lua_pushvalue(L, -2);
+      if (key->kind == BUILD_KEY_OPS) {
+        key->ops->ops(L, obj, true);
+      } else if (key->kind == BUILD_KEY_LVGL) {
+        obj_property_lvgl(L, obj, key->id, true, lua_tostring(L, -2));
+      } else {
+        luavgl_obj_set_style_value(L, obj, key->style, LV_STATE_DEFAULT);
+      }
+      lua_settop(L, before);
+    }
+
+    lua_pop(L, 1); /* keep the key to continue */
+  }
+
+  lv_obj_enable_style_refresh(true);
+  lv_obj_refresh_style(obj, LV_PART_ANY, LV_STYLE_PROP_ANY);
+
+  /* Children in the array part */
+  int n = lua_rawlen(L, node);
+  for (int i = 1; i <= n; i++) {
+    lua_rawgeti(L, node, i);
+    build_node(L, obj, lua_gettop(L), ids, keys, NULL);
+    lua_pop(L, 1);
+  }
+
+  /* Leave the root userdata on stack for the caller. */
+  lua_settop(L, root_res ? top + 1 : top);
+}
+
+/* build_tree(tree, ids, keys, parent, root_res) */
+static int build_tree(lua_State *L)
+{
+  lv_obj_t *parent = lua_touserdata(L, 4);
+  lv_obj_t **root_res = lua_touserdata(L, 5);
+  lua_settop(L, 3);
+  build_node(L, parent, 1, 2, 3, root_res);
+  return 1;
+}
+
+/**
+ * lvgl.build([parent,] tree) returns root, ids
+ */
+static int luavgl_build(lua_State *L)
+{
+  lv_obj_t *parent = luavgl_context(L)->root;
+  if (!lua_istable(L, 1)) {
+    if (!lua_isnoneornil(L, 1))
+      parent = luavgl_to_obj(L, 1);
+    lua_remove(L, 1);
+  }
+
+  luaL_checktype(L, 1, LUA_TTABLE);
+  lua_settop(L, 1);
+  lua_newtable(L); /* 2: ids */
+  lua_newtable(L); /* 3: resolved names */
+  build_check_node(L, 1, 3);
+
+  /* A property or callback may still raise an error halfway, delete the
+   * objects created so far before passing it on. */
+  lv_obj_t *root = NULL;
+  lua_pushcfunction(L, build_tree);
+  lua_pushvalue(L, 1);
+  lua_pushvalue(L, 2);
+  lua_pushvalue(L, 3);
+  lua_pushlightuserdata(L, parent);
+  lua_pushlightuserdata(L, &root);
+  if (lua_pcall(L, 5, 1, 0) != LUA_OK) {
+    lv_obj_enable_style_refresh(true);
+    if (root != NULL) {
+      lua_pushlightuserdata(L, root);
+      if (lua_rawget(L, LUA_REGISTRYINDEX) == LUA_TUSERDATA) {
+        luavgl_obj_delete(L);
+      } else {
+        lua_pop(L, 1);
+        lv_obj_delete(root);
+      }
+    }
+    return lua_error(L);
+  }
+
+  lua_pushvalue(L, 2);
+  return 2;
+}
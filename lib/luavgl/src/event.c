@@ -1,42 +1,158 @@
 #include "luavgl.h"
 #include "private.h"
 
-static void luavgl_obj_event_cb(lv_event_t *e)
+/* SCROLL and PRESSING callbacks added with obj:onevent(code, cb, true) get
+ * only the latest event of each lv_timer_handler() run. They are called from
+ * an lv_timer after the input was processed, so lvgl.indev.get_act() is nil
+ * there and a PRESSING may arrive after RELEASED. */
+#ifndef LUAVGL_EVENT_COALESCE
+#define LUAVGL_EVENT_COALESCE 1
+#endif
+
+static struct event_callback_s *event_pending_head;
+static lv_timer_t *event_flush_timer;
+
+static void luavgl_event_call(struct event_callback_s *event,
+                              lv_event_code_t code)
 {
-  struct event_callback_s *event = e->user_data;
-  if (event == NULL)
+  lua_State *L = event->L;
+  if (L == NULL || event->ref == LUA_NOREF) {
+    /* nobody cares this event, something went wrong but can be ignored. */
     return;
+  }
 
-  lua_State *L = event->L;
   int top = lua_gettop(L);
-  lv_obj_t *obj = e->current_target;
+  lua_checkstack(L, 4);
 
-  lua_pushlightuserdata(L, obj);
-  lua_rawget(L, LUA_REGISTRYINDEX);
-  luavgl_obj_t *lobj = luavgl_to_lobj(L, -1);
+  /* The default pcall wants its message handler under the function, push it
+   * first rather than inserting and removing it around the call. */
+  bool fast = event->pcall == luavgl_pcall;
+  if (fast)
+    lua_pushcfunction(L, msghandler);
+
+  lua_rawgeti(L, LUA_REGISTRYINDEX, event->ref);
+  lua_rawgeti(L, LUA_REGISTRYINDEX, event->obj_ref);
+  luavgl_obj_t *lobj = lua_touserdata(L, -1);
   if (lobj == NULL || lobj->obj == NULL) {
     lua_settop(L, top);
     return;
   }
 
-  int ref = event->ref;
-  if (ref == LUA_NOREF) {
-    /* nobody cares this event, something went wrong but can be ignored. */
-    lua_settop(L, top);
+  lua_pushinteger(L, code);
+
+  /* args: obj, code */
+  if (fast) {
+    if (lua_pcall(L, 2, 0, top + 1) != LUA_OK)
+      LV_LOG_ERROR("crashed\n%s", lua_tostring(L, -1));
+  } else {
+    event->pcall(L, 2, 0);
+  }
+
+  lua_settop(L, top);
+}
+
+static void luavgl_event_unlink(struct event_callback_s *event)
+{
+  if (!event->pending)
     return;
+
+  struct event_callback_s **p = &event_pending_head;
+  while (*p != event)
+    p = &(*p)->next_pending;
+
+  *p = event->next_pending;
+  event->next_pending = NULL;
+  event->pending = false;
+}
+
+static void luavgl_event_flush_cb(lv_timer_t *t)
+{
+  LV_UNUSED(t);
+
+  /* Callbacks may add, remove or delete, take one at a time off the list */
+  while (event_pending_head) {
+    struct event_callback_s *event = event_pending_head;
+    event_pending_head = event->next_pending;
+    event->next_pending = NULL;
+    event->pending = false;
+    luavgl_event_call(event, event->code);
   }
 
-  lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
-  lua_pushlightuserdata(L, obj);
-  lua_rawget(L, LUA_REGISTRYINDEX);
+  lv_timer_pause(event_flush_timer);
+}
 
-  lua_pushinteger(L, e->code);
+static bool luavgl_event_coalesce(struct event_callback_s *event)
+{
+#if LUAVGL_EVENT_COALESCE
+  if (!event->coalesce)
+    return false;
 
-  /* args: obj, code */
-  luavgl_pcall_int(L, 2, 0);
+  if (event->code != LV_EVENT_SCROLL && event->code != LV_EVENT_PRESSING)
+    return false;
+
+  if (event->pending)
+    return true;
+
+  if (event_flush_timer == NULL) {
+    event_flush_timer = lv_timer_create(luavgl_event_flush_cb, 0, NULL);
+    if (event_flush_timer == NULL)
+      return false;
+  }
+
+  event->pending = true;
+  event->next_pending = event_pending_head;
+  event_pending_head = event;
+  lv_timer_resume(event_flush_timer);
+  lv_timer_ready(event_flush_timer);
+  return true;
+#else
+  LV_UNUSED(event);
+  return false;
+#endif
+}
+
+static void luavgl_obj_event_cb(lv_event_t *e)
+{
+  struct event_callback_s *event = e->user_data;
+  if (event == NULL)
+    return;
+
+  if (luavgl_event_coalesce(event))
+    return;
+
+  luavgl_event_call(event, e->code);
+}
+
+/* Drop a callback, event stays in lobj->events for reuse */
+static void luavgl_event_release(lua_State *L, struct event_callback_s *event)
+{
+  luavgl_event_unlink(event);
+  luaL_unref(L, LUA_REGISTRYINDEX, event->ref);
+  luaL_unref(L, LUA_REGISTRYINDEX, event->obj_ref);
+  event->dsc = NULL;
+  event->L = NULL;
+  event->ref = LUA_NOREF;
+  event->obj_ref = LUA_NOREF;
+  event->code = LV_EVENT_LAST;
+  event->coalesce = false;
 }
 
-/* obj:onevent(luavgl.EVENT.PRESSED, function(code, value) -- end) */
+/* Keep pending events of an object lvgl deleted from being delivered */
+static void luavgl_event_unlink_all(luavgl_obj_t *lobj)
+{
+  int size = lv_array_size(&lobj->events);
+  struct event_callback_s **events = lv_array_front(&lobj->events);
+  for (int i = 0; i < size; i++) {
+    if (events[i] != NULL)
+      luavgl_event_unlink(events[i]);
+  }
+}
+
+/**
+ * obj:onevent(luavgl.EVENT.PRESSED, function(code, value) -- end)
+ * obj:onevent(luavgl.EVENT.SCROLL, function(code, value) -- end, true)
+ * The optional 3rd parameter coalesces SCROLL and PRESSING.
+ */
 static int luavgl_obj_on_event(lua_State *L)
 {
   luavgl_obj_t *lobj = luavgl_to_lobj(L, 1);
@@ -62,13 +178,8 @@ static int luavgl_obj_on_event(lua_State *L)
     for (int i = 0; i < size; i++) {
       event = events[i];
       if (event->code == code) {
-        events[i] = NULL; /* Remove it from array */
         lv_result_t res = lv_obj_remove_event_dsc(lobj->obj, event->dsc);
-        luaL_unref(L, LUA_REGISTRYINDEX, event->ref);
-        event->dsc = NULL;
-        event->L = NULL;
-        event->ref = LUA_NOREF;
-        event->code = LV_EVENT_LAST;
+        luavgl_event_release(L, event);
         if (res != LV_RESULT_OK) {
           return luaL_error(L, "Failed to remove event dsc: %d\n", res);
         }
@@ -83,8 +194,9 @@ static int luavgl_obj_on_event(lua_State *L)
   /* Check if the event code already exists, only one callback per code. */
   for (int i = 0; i < size; i++) {
     if (events[i]->code == code) {
-      luaL_unref(L, LUA_REGISTRYINDEX, event->ref);
       event = events[i];
+      lv_obj_remove_event_dsc(obj, event->dsc);
+      luavgl_event_release(L, event);
       break;
     }
 
@@ -109,10 +221,15 @@ static int luavgl_obj_on_event(lua_State *L)
 
   event->code = code;
   event->L = L;
+  event->pcall = luavgl_context(L)->pcall;
   event->ref = luavgl_check_continuation(L, 3);
+  event->coalesce = lua_toboolean(L, 4);
+  lua_pushvalue(L, 1);
+  event->obj_ref = luaL_ref(L, LUA_REGISTRYINDEX);
   event->dsc = lv_obj_add_event_cb(obj, luavgl_obj_event_cb, code, event);
   if (event->dsc == NULL) {
-    lv_free(event);
+    /* keep it in lobj->events as a removed one */
+    luavgl_event_release(L, event);
     return luaL_error(L, "Failed to add event callback");
   }
 
@@ -168,17 +285,16 @@ static void luavgl_obj_remove_event_all(lua_State *L, luavgl_obj_t *lobj)
 
     events[i] = NULL;
 
-    if (event->dsc == NULL) {
-      continue;
-    }
+    if (event->dsc != NULL) {
+      lv_result_t res = lv_obj_remove_event_dsc(lobj->obj, event->dsc);
+      if (res != LV_RESULT_OK) {
+        LV_LOG_WARN("Failed to remove event dsc: %d", res);
+        /* Ignore this error, remove from it anyway */
+      }
 
-    lv_result_t res = lv_obj_remove_event_dsc(lobj->obj, event->dsc);
-    if (res != LV_RESULT_OK) {
-      LV_LOG_WARN("Failed to remove event dsc: %d", res);
-      /* Ignore this error, remove from it anyway */
+      luavgl_event_release(L, event);
     }
 
-    luaL_unref(L, LUA_REGISTRYINDEX, event->ref);
     lv_free(event);
   }
 
@@ -13,13 +13,16 @@
 #include "timer.c"
 #include "util.c"
 
+#include "build.c" /* after obj.c, uses the widget create functions */
 #include "rotable.c"
 
 static const struct luaL_Reg luavgl_methods[] = {
     {"Timer", luavgl_timer_create}, /* timer.c */
     {"Font",  luavgl_font_create }, /* font.c */
     {"Style", luavgl_style_create}, /* style.c */
+    {"prop",  luavgl_prop        }, /* style.c */
     {"Anim",  luavgl_anim_create }, /* anim.c */
+    {"build", luavgl_build       }, /* build.c */
 
     {NULL,    NULL               },
 };
@@ -83,12 +86,17 @@ static int root_gc(lua_State *L)
   return 0;
 }
 
+static void root_delete_cb(lv_event_t *e);
+
 static int root_clean(lua_State *L)
 {
   LV_LOG_INFO("enter");
   luavgl_ctx_t *ctx = luavgl_context(L);
-  if (ctx->root)
+  if (ctx->root) {
     lv_obj_clean(ctx->root);
+    /* root outlives the state and ctx */
+    lv_obj_remove_event_cb_with_user_data(ctx->root, root_delete_cb, ctx);
+  }
   return 0;
 }
 
@@ -148,10 +156,9 @@ LUALIB_API int luaopen_lvgl(lua_State *L)
   luavgl_palette_init(L);
   luavgl_constants_init(L);
 
-  /* Methods to create widget locate in widgets table, check `luavgl_obj_init`
-   */
-  luaL_getmetatable(L, "widgets");
-  lua_setmetatable(L, -2);
+  /* Constants and the methods to create widget (widgets table, check
+   * `luavgl_obj_init`) are found through the metatable set by
+   * `luavgl_constants_init` */
 
 #ifdef LUAVGL_EXPOSE_WIDGET_API
   const luaL_Reg *reg;
@@ -52,9 +52,14 @@ typedef struct {
 
 struct event_callback_s {
   lua_State *L;
-  int ref; /* ref to callback */
+  int ref;     /* ref to callback */
+  int obj_ref; /* ref to lobj, saves the registry[obj] lookup per event */
+  luavgl_pcall_t pcall;
   lv_event_code_t code;
   lv_event_dsc_t *dsc;
+  bool coalesce; /* deliver only the latest SCROLL/PRESSING per frame */
+  bool pending;  /* coalesced event waiting for the flush timer */
+  struct event_callback_s *next_pending;
 };
 
 typedef struct luavgl_obj_s {
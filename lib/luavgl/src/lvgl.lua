@@ -422,6 +422,25 @@ end
 function lvgl.Roller(parent, property)
 end
 
+---
+--- Create VirtualList Widget on parent
+--- @param parent? Object | nil
+--- @param property? VirtualListStyle
+--- @return VirtualList
+function lvgl.VirtualList(parent, property)
+end
+
+---
+--- Create a whole widget tree in one call. Children go in the array part of
+--- each node. Only the root and nodes with id, user_data or on get a lua
+--- object, the rest are plain lvgl children.
+--- @param parent? Object | nil
+--- @param tree BuildNode
+--- @return Object root
+--- @return table<string, Object> ids
+function lvgl.build(parent, tree)
+end
+
 ---
 --- Create Timer
 --- @param p TimerPara
@@ -459,6 +478,13 @@ end
 function lvgl.Style(p)
 end
 
+---
+--- Resolve an integer style name once, for obj:setp() and anim exec_cb
+--- @param name string style name like "y", "size" or "bg_opa"
+--- @return StyleHandle
+function lvgl.prop(name)
+end
+
 ---
 --- Basic lvgl object
 --- @class Object
@@ -541,6 +567,13 @@ end
 --- @return Roller
 function obj:Roller(parent, property)
 end
+
+---
+--- Create VirtualList Widget on parent
+--- @param property? VirtualListStyle
+--- @return VirtualList
+function obj:VirtualList(property)
+end
 ---
 --- Set object property
 --- @param p StyleProp
@@ -557,6 +590,15 @@ end
 function obj:set_style(p, state)
 end
 
+---
+--- Set one integer style without a table, e.g. in an animation callback
+--- @param prop StyleHandle from lvgl.prop()
+--- @param value integer
+--- @param state? ObjState
+---
+function obj:setp(prop, value, state)
+end
+
 ---
 --- Set object property
 --- @param p AlignToPara
@@ -782,8 +824,9 @@ end
 --- set object event callback
 --- @param code ObjEventCode
 --- @param cb EventCallback
+--- @param coalesce? boolean SCROLL/PRESSING only: call cb once per frame with the latest event, after input processing
 --- @return nil
-function obj:onevent(code, cb)
+function obj:onevent(code, cb, coalesce)
 end
 
 ---
@@ -1137,6 +1180,24 @@ end
 function roller:get_options_cnt()
 end
 
+---
+--- VirtualList widget, only the visible rows are created as labels
+---@class VirtualList: Object
+---
+local virtual_list = {}
+
+--- Rebind all visible rows, use it after changing data in place
+--- @return nil
+function virtual_list:refresh()
+end
+
+--- Scroll until the row of index is visible
+--- @param index integer
+--- @param anim? boolean
+--- @return nil
+function virtual_list:scroll_to_index(index, anim)
+end
+
 ---
 --- Anim
 ---@class Anim
@@ -1416,6 +1477,21 @@ end
 --- @field selected table | integer
 --- @field visible_cnt integer
 
+--- @alias VirtualListBind fun(index:integer, row:Label): string | nil
+
+--- @class VirtualListStyle :StyleProp
+--- @field count integer number of rows in the data source
+--- @field row_height integer height of every row, the least height of a row if wrap is set
+--- @field wrap boolean wrap the text of rows, each row is as high as its text plus pad_row
+--- @field bind VirtualListBind return the text for row index, or style row directly
+
+--- lvgl.build node, other fields are properties of the widget
+--- @class BuildNode :StyleProp
+--- @field type? "Object" | "Button" | "Label" | "Image" | "Checkbox" | "Dropdown" | "Textarea" | "Keyboard" | "Led" | "List" | "Roller" | "Calendar" | "VirtualList"
+--- @field id? string key of this object in the returned ids table
+--- @field user_data? any
+--- @field on? table<integer, EventCallback> callbacks by event code
+
 ---
 --- Anim(for object) parameter
 --- @alias AnimExecCb fun(obj:any, value:integer): nil
@@ -1432,7 +1508,7 @@ end
 --- @field playback_time integer
 --- @field early_apply boolean set start_value right now or not. default: true
 --- @field path string |  "linear" |  "ease_in" |  "ease_out" |  "ease_in_out" |  "overshoot" |  "bounce" |  "step"
---- @field exec_cb AnimExecCb
+--- @field exec_cb AnimExecCb | StyleHandle a handle animates that style of the object without calling lua
 --- @field done_cb AnimDoneCb
 
 
@@ -1448,6 +1524,7 @@ end
 
 
 ---
+--- @alias StyleHandle lightuserdata
 --- @alias ImgSrc string | lightuserdata
 
 --- @alias flexAlignOptions "flex-start" | "flex-end" | "center" | "space-between" | "space-around" | "space-evenly"
@@ -12,6 +12,7 @@ static int luavgl_obj_delete(lua_State *L);
 static int luavgl_obj_clean(lua_State *L);
 
 static const int obj_meta_key;
+static const int obj_property_cache_key;
 
 static void obj_delete_cb(lv_event_t *e)
 {
@@ -26,8 +27,11 @@ static void obj_delete_cb(lv_event_t *e)
   lua_setuservalue(L, -2);
 
   luavgl_obj_t *lobj = luavgl_to_lobj(L, -1);
-  if (lobj->lua_created)
+  if (lobj->lua_created) {
+    /* Deleted by lvgl while lua still holds it */
+    luavgl_event_unlink_all(lobj);
     goto pop_exit;
+  }
 
   /* Clean its children firstly */
   luavgl_obj_clean(L);
@@ -38,11 +42,12 @@ static void obj_delete_cb(lv_event_t *e)
   struct event_callback_s **events = lv_array_front(&lobj->events);
   for (int i = 0; i < size; i++) {
     event = events[i];
-    if (event == NULL || event->dsc == NULL) {
+    if (event == NULL) {
       continue;
     }
 
-    luaL_unref(L, LUA_REGISTRYINDEX, event->ref);
+    if (event->dsc != NULL)
+      luavgl_event_release(L, event);
     lv_free(event);
   }
 
@@ -68,6 +73,29 @@ static int luavgl_obj_create(lua_State *L)
   return luavgl_obj_create_helper(L, lv_obj_create);
 }
 
+/**
+ * Delete the lua objects below obj. Children lua doesn't know, like the plain
+ * nodes of lvgl.build(), may still have lua objects below them.
+ */
+static void luavgl_obj_delete_children(lua_State *L, lv_obj_t *obj)
+{
+  uint32_t cnt = lv_obj_get_child_cnt(obj);
+
+  for (int i = cnt - 1; i >= 0; i--) {
+    lv_obj_t *child = lv_obj_get_child(obj, i);
+    lua_checkstack(L, 2);
+    lua_pushlightuserdata(L, child);
+    lua_rawget(L, LUA_REGISTRYINDEX);
+    if (lua_isnoneornil(L, -1)) {
+      lua_pop(L, 1);
+      luavgl_obj_delete_children(L, child);
+      continue;
+    }
+
+    luavgl_obj_delete(L);
+  }
+}
+
 static int luavgl_obj_delete(lua_State *L)
 {
   luavgl_obj_t *lobj;
@@ -85,19 +113,7 @@ static int luavgl_obj_delete(lua_State *L)
     return 0;
   }
 
-  uint32_t cnt = lv_obj_get_child_cnt(lobj->obj);
-
-  for (int i = cnt - 1; i >= 0; i--) {
-    lv_obj_t *child = lv_obj_get_child(lobj->obj, i);
-    lua_checkstack(L, 2);
-    lua_pushlightuserdata(L, child);
-    lua_rawget(L, LUA_REGISTRYINDEX);
-    if (lua_isnoneornil(L, -1)) {
-      continue;
-    }
-
-    luavgl_obj_delete(L);
-  }
+  luavgl_obj_delete_children(L, lobj->obj);
 
   luavgl_obj_remove_event_all(L, lobj);
 
@@ -675,23 +691,42 @@ static int obj_property_lvgl(lua_State *L, lv_obj_t *obj, lv_prop_id_t id,
 }
 
 /**
- * Keep stack unchanged, get the ops for specified property name
- * stack layout:
- * 1: obj,
- * -2 property name, -1: property value if set is true
- * Return negative value if not found.
+ * Push registry[cache_key][clz], the resolved property cache of this class.
+ * Keys are property names, values tell how the name was resolved:
+ *  lightuserdata: luavgl_property_ops_t from a class __property table
+ *  integer: lvgl class property id
+ *  false: not a class property, go to style fallback
  */
-int obj_property(lua_State *L, lv_obj_t *obj)
+static void obj_property_cache_push(lua_State *L, const lv_obj_class_t *clz)
 {
-  /* -2 must be property name. */
-  luaL_argcheck(L, lua_type(L, -2) == LUA_TSTRING, -2,
-                "property name must be string");
+  if (lua_rawgetp(L, LUA_REGISTRYINDEX, &obj_property_cache_key) !=
+      LUA_TTABLE) {
+    lua_pop(L, 1);
+    lua_newtable(L);
+    lua_pushvalue(L, -1);
+    lua_rawsetp(L, LUA_REGISTRYINDEX, &obj_property_cache_key);
+  }
 
-  bool set = lua_type(L, -1) != LUA_TNIL;
+  if (lua_rawgetp(L, -1, clz) != LUA_TTABLE) {
+    lua_pop(L, 1);
+    lua_newtable(L);
+    lua_pushvalue(L, -1);
+    lua_rawsetp(L, -3, clz);
+  }
+
+  lua_remove(L, -2);
+}
+
+/**
+ * Walk the class hierarchy to find who handles property name.
+ * Stack is unchanged. Result is encoded the same way as the cache value.
+ */
+static void obj_property_resolve(lua_State *L, const lv_obj_class_t *clz,
+                                 const char *name,
+                                 const luavgl_property_ops_t **ops_out,
+                                 lv_prop_id_t *id_out)
+{
   int top = lua_gettop(L);
-  const char *name = luaL_checkstring(L, -2);
-  const lv_obj_class_t *clz = obj->class_p;
-  lv_prop_id_t id = LV_PROPERTY_ID_INVALID;
 
   for (; clz; clz = clz->base_class) {
     int t = luavgl_obj_getmetatable(L, clz);
@@ -704,12 +739,11 @@ int obj_property(lua_State *L, lv_obj_t *obj)
       if (t == LUA_TLIGHTUSERDATA) {
         const luavgl_table_t *table = lua_touserdata(L, -1);
         const luavgl_property_ops_t *ops = table->array;
-        /* @todo, use bsearch and force property table in order. */
         for (int i = 0; i < table->len; i++) {
           if (lv_strcmp(ops[i].name, name) == 0) {
             lua_settop(L, top);
-            /* Stack: 1, obj, -2, property name, -1, value if set is true */
-            return ops[i].ops(L, obj, set);
+            *ops_out = &ops[i];
+            return;
           }
         }
       }
@@ -719,11 +753,63 @@ int obj_property(lua_State *L, lv_obj_t *obj)
     lua_settop(L, top);
 
     /* Try lvgl base class */
-    id = lv_obj_class_property_get_id(clz, name);
+    lv_prop_id_t id = lv_obj_class_property_get_id(clz, name);
     if (id != LV_PROPERTY_ID_INVALID) {
-      return obj_property_lvgl(L, obj, id, set, name);
+      *id_out = id;
+      return;
     }
   }
+}
+
+/**
+ * Keep stack unchanged, get the ops for specified property name
+ * stack layout:
+ * 1: obj,
+ * -2 property name, -1: property value if set is true
+ * Return negative value if not found.
+ */
+int obj_property(lua_State *L, lv_obj_t *obj)
+{
+  /* -2 must be property name. */
+  luaL_argcheck(L, lua_type(L, -2) == LUA_TSTRING, -2,
+                "property name must be string");
+
+  bool set = lua_type(L, -1) != LUA_TNIL;
+  const char *name = luaL_checkstring(L, -2);
+  const luavgl_property_ops_t *ops = NULL;
+  lv_prop_id_t id = LV_PROPERTY_ID_INVALID;
+
+  /* The class hierarchy walk is cached per class, keyed by the name string. */
+  obj_property_cache_push(L, obj->class_p);
+  lua_pushvalue(L, -3);
+  int t = lua_rawget(L, -2);
+  if (t == LUA_TLIGHTUSERDATA) {
+    ops = lua_touserdata(L, -1);
+  } else if (t == LUA_TNUMBER) {
+    id = lua_tointeger(L, -1);
+  } else if (t == LUA_TNIL) {
+    lua_pop(L, 1);
+    obj_property_resolve(L, obj->class_p, name, &ops, &id);
+    lua_pushvalue(L, -3);
+    if (ops)
+      lua_pushlightuserdata(L, (void *)ops);
+    else if (id != LV_PROPERTY_ID_INVALID)
+      lua_pushinteger(L, id);
+    else
+      lua_pushboolean(L, 0);
+    lua_rawset(L, -3);
+    lua_pushnil(L); /* keep the same stack depth as a cache hit */
+  }
+  lua_pop(L, 2);
+
+  if (ops) {
+    /* Stack: 1, obj, -2, property name, -1, value if set is true */
+    return ops->ops(L, obj, set);
+  }
+
+  if (id != LV_PROPERTY_ID_INVALID) {
+    return obj_property_lvgl(L, obj, id, set, name);
+  }
 
   /* Try style, only set method supported. */
   if (set && luavgl_obj_set_style_kv(L, obj, LV_STATE_DEFAULT) == 0) {
@@ -887,6 +973,7 @@ static const rotable_Reg luavgl_obj_methods[] = {
     {"get",                      LUA_TFUNCTION,      {luavgl_obj_get_property}            },
 
     {"set_style",                LUA_TFUNCTION,      {luavgl_obj_set_style}               },
+    {"setp",                     LUA_TFUNCTION,      {luavgl_obj_setp}                    },
     {"align_to",                 LUA_TFUNCTION,      {luavgl_obj_align_to}                },
     {"delete",                   LUA_TFUNCTION,      {luavgl_obj_delete}                  },
     {"clean",                    LUA_TFUNCTION,      {luavgl_obj_clean}                   },
@@ -32,32 +32,30 @@ static int luavgl_palette_darken(lua_State *L)
 }
 
 static const rotable_Reg palette_constants[] = {
-    {"RED",         0,             {.integer = LV_PALETTE_RED}        },
-    {"PINK",        0,             {.integer = LV_PALETTE_PINK}       },
-    {"PURPLE",      0,             {.integer = LV_PALETTE_PURPLE}     },
-    {"DEEP_PURPLE", 0,             {.integer = LV_PALETTE_DEEP_PURPLE}},
-    {"INDIGO",      0,             {.integer = LV_PALETTE_INDIGO}     },
+    {"AMBER",       0,             {.integer = LV_PALETTE_AMBER}      },
     {"BLUE",        0,             {.integer = LV_PALETTE_BLUE}       },
-    {"LIGHT_BLUE",  0,             {.integer = LV_PALETTE_LIGHT_BLUE} },
+    {"BLUE_GREY",   0,             {.integer = LV_PALETTE_BLUE_GREY}  },
+    {"BROWN",       0,             {.integer = LV_PALETTE_BROWN}      },
     {"CYAN",        0,             {.integer = LV_PALETTE_CYAN}       },
-    {"TEAL",        0,             {.integer = LV_PALETTE_TEAL}       },
-    {"GREEN",       0,             {.integer = LV_PALETTE_GREEN}      },
-    {"LIGHT_GREEN", 0,             {.integer = LV_PALETTE_LIGHT_GREEN}},
-    {"LIME",        0,             {.integer = LV_PALETTE_LIME}       },
-    {"YELLOW",      0,             {.integer = LV_PALETTE_YELLOW}     },
-    {"AMBER",       0,             {.integer = LV_PALETTE_AMBER}      },
-    {"ORANGE",      0,             {.integer = LV_PALETTE_ORANGE}     },
     {"DEEP_ORANGE", 0,             {.integer = LV_PALETTE_DEEP_ORANGE}},
-    {"BROWN",       0,             {.integer = LV_PALETTE_BROWN}      },
-    {"BLUE_GREY",   0,             {.integer = LV_PALETTE_BLUE_GREY}  },
+    {"DEEP_PURPLE", 0,             {.integer = LV_PALETTE_DEEP_PURPLE}},
+    {"GREEN",       0,             {.integer = LV_PALETTE_GREEN}      },
     {"GREY",        0,             {.integer = LV_PALETTE_GREY}       },
+    {"INDIGO",      0,             {.integer = LV_PALETTE_INDIGO}     },
     {"LAST",        0,             {.integer = LV_PALETTE_LAST}       },
+    {"LIGHT_BLUE",  0,             {.integer = LV_PALETTE_LIGHT_BLUE} },
+    {"LIGHT_GREEN", 0,             {.integer = LV_PALETTE_LIGHT_GREEN}},
+    {"LIME",        0,             {.integer = LV_PALETTE_LIME}       },
     {"NONE",        0,             {.integer = LV_PALETTE_NONE}       },
-
-    {"main",        LUA_TFUNCTION, {luavgl_palette_main}              },
-    {"lighten",     LUA_TFUNCTION, {luavgl_palette_lighten}           },
+    {"ORANGE",      0,             {.integer = LV_PALETTE_ORANGE}     },
+    {"PINK",        0,             {.integer = LV_PALETTE_PINK}       },
+    {"PURPLE",      0,             {.integer = LV_PALETTE_PURPLE}     },
+    {"RED",         0,             {.integer = LV_PALETTE_RED}        },
+    {"TEAL",        0,             {.integer = LV_PALETTE_TEAL}       },
+    {"YELLOW",      0,             {.integer = LV_PALETTE_YELLOW}     },
     {"darken",      LUA_TFUNCTION, {luavgl_palette_darken}            },
-
+    {"lighten",     LUA_TFUNCTION, {luavgl_palette_lighten}           },
+    {"main",        LUA_TFUNCTION, {luavgl_palette_main}              },
     {0,             0,             {0}                                },
 };
 
@@ -8,6 +8,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 
 static void dumpstack(lua_State *L);
 static void dumptable(lua_State *L, int index);
@@ -19,9 +20,21 @@ int luavgl_obj_setmetatable(lua_State *L, int idx, const lv_obj_class_t *clz);
 static void luavgl_obj_remove_event_all(lua_State *L, luavgl_obj_t *obj);
 
 /* util functions */
+LUALIB_API void *luavgl_test_obj(lua_State *L, int ud);
 static void luavgl_check_callable(lua_State *L, int index);
 static int luavgl_check_continuation(lua_State *L, int index);
 
 static int luavgl_obj_set_style_kv(lua_State *L, lv_obj_t *obj, int selector);
 
+/* style names resolved once, by lvgl.prop() or lvgl.build() */
+struct style_map_s;
+static const struct style_map_s *luavgl_style_find(const char *name);
+static int luavgl_obj_set_style_value(lua_State *L, lv_obj_t *obj,
+                                      const struct style_map_s *p,
+                                      int selector);
+static const struct style_map_s *luavgl_to_prop(lua_State *L, int idx);
+static void luavgl_obj_set_prop(lv_obj_t *obj, const struct style_map_s *p,
+                                int32_t v, int selector);
+
 static int luavgl_pcall_int(lua_State *L, int nargs, int nresult);
+static int msghandler(lua_State *L);
@@ -153,6 +153,94 @@ static const struct style_map_s {
 
 #define STYLE_MAP_LEN (sizeof(g_style_map) / sizeof(g_style_map[0]))
 
+/* Size of the direct-mapped cache from Lua string pointer to map entry. */
+#ifndef LUAVGL_STYLE_CACHE_SIZE
+#define LUAVGL_STYLE_CACHE_SIZE 32
+#endif
+
+/* Look names up by scanning g_style_map, like luavgl did before the sorted
+ * index. Only to compare against, e.g. in the simulator's style_set_bench. */
+#ifndef LUAVGL_STYLE_LINEAR_SCAN
+#define LUAVGL_STYLE_LINEAR_SCAN 0
+#endif
+
+/* g_style_map is grouped by purpose, keep a name-sorted index beside it so
+ * lookups can use binary search. Built once by luavgl_style_init(). */
+static uint8_t g_style_order[STYLE_MAP_LEN];
+static bool g_style_order_ready;
+
+/* Lua short strings are interned, so the same key usually comes back with
+ * the same pointer. The name is still compared on hit because the string
+ * may have been collected and its memory reused. */
+static struct {
+  const char *key;
+  const struct style_map_s *p;
+} g_style_cache[LUAVGL_STYLE_CACHE_SIZE];
+
+static void luavgl_style_sort_map(void)
+{
+  LV_ASSERT(STYLE_MAP_LEN <= 256);
+
+  if (g_style_order_ready)
+    return;
+
+  /* insertion sort, the map is small and this runs once */
+  for (int i = 0; i < STYLE_MAP_LEN; i++) {
+    int j = i;
+    while (j > 0 && lv_strcmp(g_style_map[g_style_order[j - 1]].name,
+                              g_style_map[i].name) > 0) {
+      g_style_order[j] = g_style_order[j - 1];
+      j--;
+    }
+    g_style_order[j] = i;
+  }
+
+  g_style_order_ready = true;
+}
+
+static const struct style_map_s *luavgl_style_find(const char *name)
+{
+  if (name == NULL)
+    return NULL;
+
+#if LUAVGL_STYLE_LINEAR_SCAN
+  for (int i = 0; i < STYLE_MAP_LEN; i++) {
+    if (lv_strcmp(name, g_style_map[i].name) == 0)
+      return &g_style_map[i];
+  }
+  return NULL;
+#endif
+
+  uintptr_t slot = ((uintptr_t)name >> 3) % LUAVGL_STYLE_CACHE_SIZE;
+  const struct style_map_s *p = g_style_cache[slot].p;
+  if (g_style_cache[slot].key == name && lv_strcmp(name, p->name) == 0)
+    return p;
+
+  int lo = 0, hi = STYLE_MAP_LEN - 1;
+  p = NULL;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    const struct style_map_s *m = &g_style_map[g_style_order[mid]];
+    int cmp = lv_strcmp(name, m->name);
+    if (cmp == 0) {
+      p = m;
+      break;
+    }
+
+    if (cmp < 0)
+      hi = mid - 1;
+    else
+      lo = mid + 1;
+  }
+
+  if (p == NULL)
+    return NULL;
+
+  g_style_cache[slot].key = name;
+  g_style_cache[slot].p = p;
+  return p;
+}
+
 /**
  * lv_style
  */
@@ -347,60 +435,15 @@ static inline bool luavgl_is_style_inherit(lua_State *L)
 }
 
 /**
- * internal used API, called from style:set()
- * key: stack[-2]
- * value: stack[-1]
+ * Set a resolved style map entry, expanding the combined styles like size
+ * or pad_all. Styles taking a table are ignored here.
  *
- * @return 0 if succeed, -1 if failed.
+ * @return false if the entry is not a known style.
  */
-static int luavgl_set_style_kv(lua_State *L, style_set_cb_t cb, void *args)
+static bool luavgl_style_apply(const struct style_map_s *p,
+                               lv_style_value_t value, style_set_cb_t cb,
+                               void *args)
 {
-  const char *key = lua_tostring(L, -2);
-  if (key == NULL) {
-    LV_LOG_WARN("Null key, ignored");
-    return -1;
-  }
-
-  /* map name to style value. */
-  lv_style_value_t value = {0};
-  const struct style_map_s *p = NULL;
-  for (int i = 0; i < STYLE_MAP_LEN; i++) {
-    if (lv_strcmp(key, g_style_map[i].name) == 0) {
-      p = &g_style_map[i];
-      break;
-    }
-  }
-
-  if (p == NULL) /* not found */
-    return -1;
-
-  style_type_t type = p->type & 0x0f;
-  int v;
-
-  if (!luavgl_is_style_inherit(L)) {
-    /* get normal values */
-    switch (type) {
-    case STYLE_TYPE_INT:
-      v = luavgl_tointeger(L, -1);
-      value.num = v;
-      break;
-    case STYLE_TYPE_COLOR:
-      value.color = luavgl_tocolor(L, -1);
-      break;
-    case STYLE_TYPE_POINTER:
-      value.ptr = lua_touserdata(L, -1);
-      break;
-    case STYLE_TYPE_IMGSRC:
-      value.ptr = luavgl_toimgsrc(L, -1);
-      break;
-    case STYLE_TYPE_TABLE:
-      break;
-    default:
-      /* error, unkown type */
-      return luaL_error(L, "unknown style");
-    }
-  }
-
   lv_style_prop_t prop = p->prop;
 
 #if LV_VERSION_CHECK(9, 0, 0)
@@ -471,23 +514,89 @@ static int luavgl_set_style_kv(lua_State *L, style_set_cb_t cb, void *args)
       cb(LV_STYLE_FLEX_GROW, value, args);
       break;
 
-    case _LV_STYLE_FLEX: {
-      /* value is all on table */
-      luavgl_set_flex_layout_kv(L, cb, args);
-      break;
-    }
     default:
       break;
     }
   } else if ((prop & mask) <= LV_STYLE_LAST_BUILT_IN_PROP) {
     cb(prop & mask, value, args);
   } else {
-    return luaL_error(L, "unknown style");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Set the style p resolved to from the value at stack[-1]
+ *
+ * @return 0 if succeed.
+ */
+static int luavgl_set_style_value(lua_State *L, const struct style_map_s *p,
+                                  style_set_cb_t cb, void *args)
+{
+  lv_style_value_t value = {0};
+  style_type_t type = p->type & 0x0f;
+  int v;
+
+  if (!luavgl_is_style_inherit(L)) {
+    /* get normal values */
+    switch (type) {
+    case STYLE_TYPE_INT:
+      v = luavgl_tointeger(L, -1);
+      value.num = v;
+      break;
+    case STYLE_TYPE_COLOR:
+      value.color = luavgl_tocolor(L, -1);
+      break;
+    case STYLE_TYPE_POINTER:
+      value.ptr = lua_touserdata(L, -1);
+      break;
+    case STYLE_TYPE_IMGSRC:
+      value.ptr = luavgl_toimgsrc(L, -1);
+      break;
+    case STYLE_TYPE_TABLE:
+      break;
+    default:
+      /* error, unkown type */
+      return luaL_error(L, "unknown style");
+    }
+  }
+
+  if ((int)p->prop == _LV_STYLE_FLEX) {
+    /* value is all on table */
+    luavgl_set_flex_layout_kv(L, cb, args);
+    return 0;
   }
 
+  if (!luavgl_style_apply(p, value, cb, args))
+    return luaL_error(L, "unknown style");
+
   return 0;
 }
 
+/**
+ * internal used API, called from style:set()
+ * key: stack[-2]
+ * value: stack[-1]
+ *
+ * @return 0 if succeed, -1 if failed.
+ */
+static int luavgl_set_style_kv(lua_State *L, style_set_cb_t cb, void *args)
+{
+  const char *key = lua_tostring(L, -2);
+  if (key == NULL) {
+    LV_LOG_WARN("Null key, ignored");
+    return -1;
+  }
+
+  /* map name to style value. */
+  const struct style_map_s *p = luavgl_style_find(key);
+  if (p == NULL) /* not found */
+    return -1;
+
+  return luavgl_set_style_value(L, p, cb, args);
+}
+
 /**
  * style:set({x = 0, y = 0, bg_opa = 123})
  */
@@ -568,12 +677,10 @@ static int luavgl_style_remove_prop(lua_State *L)
   luavgl_style_t *s = luavgl_check_style(L, 1);
   const char *name = lua_tostring(L, 2);
 
-  for (int i = 0; i < STYLE_MAP_LEN; i++) {
-    const struct style_map_s *p = &g_style_map[i];
-    if (lv_strcmp(name, p->name) == 0) {
-      lv_style_remove_prop(&s->style, p->prop);
-      return 0;
-    }
+  const struct style_map_s *p = luavgl_style_find(name);
+  if (p != NULL) {
+    lv_style_remove_prop(&s->style, p->prop);
+    return 0;
   }
 
   return luaL_error(L, "unknown prop name: %s", name);
@@ -643,6 +750,91 @@ static int luavgl_obj_set_style_kv(lua_State *L, lv_obj_t *obj, int selector)
 #endif
 }
 
+/* Set the style p from the value at stack[-1], e.g. a name lvgl.build()
+ * resolved once for all its nodes */
+static int luavgl_obj_set_style_value(lua_State *L, lv_obj_t *obj,
+                                      const struct style_map_s *p,
+                                      int selector)
+{
+  struct obj_style_s info = {
+      .obj = obj,
+      .selector = selector,
+  };
+
+#if LV_VERSION_CHECK(8, 3, 0)
+  bool inherit = luavgl_is_style_inherit(L);
+
+  return luavgl_set_style_value(
+      L, p, inherit ? obj_style_inherit_set_cb : obj_style_set_cb, &info);
+#else
+  return luavgl_set_style_value(L, p, obj_style_set_cb, &info);
+#endif
+}
+
+/**
+ * Resolved integer style, see lvgl.prop(). Nil if idx is not one.
+ */
+static const struct style_map_s *luavgl_to_prop(lua_State *L, int idx)
+{
+  const struct style_map_s *p = lua_touserdata(L, idx);
+  if (lua_type(L, idx) != LUA_TLIGHTUSERDATA || p < g_style_map ||
+      p >= g_style_map + STYLE_MAP_LEN)
+    return NULL;
+
+  return p;
+}
+
+static const struct style_map_s *luavgl_check_prop(lua_State *L, int idx)
+{
+  const struct style_map_s *p = luavgl_to_prop(L, idx);
+  if (p == NULL)
+    luaL_argerror(L, idx, "expect a handle from lvgl.prop()");
+  return p;
+}
+
+static void luavgl_obj_set_prop(lv_obj_t *obj, const struct style_map_s *p,
+                                int32_t v, int selector)
+{
+  struct obj_style_s info = {
+      .obj = obj,
+      .selector = selector,
+  };
+
+  lv_style_value_t value = {.num = v};
+  luavgl_style_apply(p, value, obj_style_set_cb, &info);
+}
+
+/**
+ * Y = lvgl.prop("y")
+ * Resolve an integer style name once, for obj:setp() and anim exec_cb.
+ */
+static int luavgl_prop(lua_State *L)
+{
+  const char *name = luaL_checkstring(L, 1);
+  const struct style_map_s *p = luavgl_style_find(name);
+  if (p == NULL || (p->type & 0x0f) != STYLE_TYPE_INT ||
+      (int)p->prop == _LV_STYLE_FLEX)
+    return luaL_error(L, "not an integer style: %s", name);
+
+  lua_pushlightuserdata(L, (void *)p);
+  return 1;
+}
+
+/**
+ * obj:setp(Y, 10, selector)
+ * Same as obj:set_style({y = 10}, selector) without a table or name lookup.
+ */
+static int luavgl_obj_setp(lua_State *L)
+{
+  lv_obj_t *obj = luavgl_to_obj(L, 1);
+  const struct style_map_s *p = luavgl_check_prop(L, 2);
+  int32_t v = luavgl_tointeger(L, 3);
+  int selector = luaL_optinteger(L, 4, 0);
+
+  luavgl_obj_set_prop(obj, p, v, selector);
+  return 0;
+}
+
 /**
  * obj:set_style({x = 0, y = 0, bg_opa = 123}, 0)
  */
@@ -743,6 +935,8 @@ static const rotable_Reg luavgl_style_methods[] = {
 
 static void luavgl_style_init(lua_State *L)
 {
+  luavgl_style_sort_map();
+
   luaL_newmetatable(L, "lv_style");
 
   lua_pushcfunction(L, luavgl_style_gc);
@@ -0,0 +1,667 @@
+#include "luavgl.h"
+#include "private.h"
+
+/**
+ * A scrollable list that only creates label rows for the visible part of the
+ * data. By default rows have a fixed height and show one line, so the data
+ * index of any scroll position is a division away. A spacer child provides
+ * the full scroll range.
+ *
+ * lvgl.VirtualList(parent, {
+ *   row_height = 24,
+ *   count = #messages,
+ *   bind = function(index, row) return messages[index].text end,
+ * })
+ *
+ * bind() is called when a row shows a new index. If it returns a string, the
+ * row label text is set to it. The row label may also be styled directly.
+ *
+ * With wrap = true rows wrap their text and are as high as it needs plus the
+ * list's pad_row, at least row_height. A row's height is measured when it is bound, rows not shown yet
+ * count as row_height. The heights take 2 bytes per item and are summed in
+ * blocks, so finding the row at a scroll position stays cheap. When rows
+ * above the ones on screen get their real height, the list scrolls by the
+ * difference so the content doesn't jump.
+ */
+
+#define VLIST_UNBOUND UINT32_MAX
+#define VLIST_BLOCK   64 /* items per summed block of heights */
+
+typedef struct {
+  lv_obj_t obj;
+  lua_State *L;
+  int bind_ref;
+  uint32_t count;
+  int32_t row_height;
+  bool wrap;
+  bool updating; /* placing rows, ignore the scroll events it causes */
+  lv_obj_t *spacer;
+  uint32_t pool_size;
+  lv_obj_t **rows;    /* row labels, slot i shows indexes where idx % n == i */
+  uint32_t *row_idx; /* data index bound to each row, VLIST_UNBOUND if none */
+
+  /* wrap only, heights are NULL if they couldn't be allocated */
+  uint16_t *heights;   /* measured height of each item, 0 if not measured */
+  int32_t *block_h;    /* sum of the heights of each VLIST_BLOCK items */
+  uint32_t height_cap; /* items heights has room for */
+  int32_t wrap_width;  /* content width the heights were measured at */
+} luavgl_vlist_t;
+
+static void luavgl_vlist_constructor(const lv_obj_class_t *class_p,
+                                     lv_obj_t *obj);
+static void luavgl_vlist_destructor(const lv_obj_class_t *class_p,
+                                    lv_obj_t *obj);
+static void luavgl_vlist_event(const lv_obj_class_t *class_p, lv_event_t *e);
+
+static const lv_obj_class_t luavgl_vlist_class = {
+    .base_class = &lv_obj_class,
+    .constructor_cb = luavgl_vlist_constructor,
+    .destructor_cb = luavgl_vlist_destructor,
+    .event_cb = luavgl_vlist_event,
+    .width_def = LV_PCT(100),
+    .height_def = LV_PCT(100),
+    .instance_size = sizeof(luavgl_vlist_t),
+    .name = "virtual_list",
+};
+
+static lv_obj_t *luavgl_vlist_create_obj(lv_obj_t *parent)
+{
+  lv_obj_t *obj = lv_obj_class_create_obj(&luavgl_vlist_class, parent);
+  lv_obj_class_init_obj(obj);
+  return obj;
+}
+
+static void luavgl_vlist_constructor(const lv_obj_class_t *class_p,
+                                     lv_obj_t *obj)
+{
+  LV_UNUSED(class_p);
+  luavgl_vlist_t *v = (luavgl_vlist_t *)obj;
+
+  v->L = NULL;
+  v->bind_ref = LUA_NOREF;
+  v->count = 0;
+  v->row_height = 24;
+  v->wrap = false;
+  v->updating = false;
+  v->pool_size = 0;
+  v->rows = NULL;
+  v->row_idx = NULL;
+  v->heights = NULL;
+  v->block_h = NULL;
+  v->height_cap = 0;
+  v->wrap_width = 0;
+
+  v->spacer = lv_obj_create(obj);
+  lv_obj_remove_style_all(v->spacer);
+  lv_obj_remove_flag(v->spacer, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_set_size(v->spacer, 1, 0);
+
+  lv_obj_set_scroll_dir(obj, LV_DIR_VER);
+}
+
+static void luavgl_vlist_destructor(const lv_obj_class_t *class_p,
+                                    lv_obj_t *obj)
+{
+  LV_UNUSED(class_p);
+  luavgl_vlist_t *v = (luavgl_vlist_t *)obj;
+
+  if (v->L != NULL)
+    luaL_unref(v->L, LUA_REGISTRYINDEX, v->bind_ref);
+  v->bind_ref = LUA_NOREF;
+
+  /* Row objects are children, lvgl deletes them. */
+  lv_free(v->rows);
+  lv_free(v->row_idx);
+  v->rows = NULL;
+  v->row_idx = NULL;
+  v->pool_size = 0;
+
+  lv_free(v->heights);
+  lv_free(v->block_h);
+  v->heights = NULL;
+  v->block_h = NULL;
+  v->height_cap = 0;
+}
+
+static bool luavgl_vlist_varies(luavgl_vlist_t *v)
+{
+  return v->wrap && v->heights != NULL;
+}
+
+static int32_t luavgl_vlist_item_h(luavgl_vlist_t *v, uint32_t index)
+{
+  if (!luavgl_vlist_varies(v) || v->heights[index] == 0)
+    return v->row_height;
+
+  return v->heights[index];
+}
+
+/* Sum the heights again from block on, e.g. after the count changed */
+static void luavgl_vlist_sum_blocks(luavgl_vlist_t *v, uint32_t block)
+{
+  if (!luavgl_vlist_varies(v))
+    return;
+
+  uint32_t blocks = (v->count + VLIST_BLOCK - 1) / VLIST_BLOCK;
+  for (uint32_t b = block; b < blocks; b++) {
+    uint32_t end = LV_MIN((b + 1) * VLIST_BLOCK, v->count);
+    int32_t sum = 0;
+    for (uint32_t i = b * VLIST_BLOCK; i < end; i++) {
+      sum += luavgl_vlist_item_h(v, i);
+    }
+    v->block_h[b] = sum;
+  }
+}
+
+/* Top of an item in the scrolled content, index may be count for the end */
+static int32_t luavgl_vlist_item_y(luavgl_vlist_t *v, uint32_t index)
+{
+  if (!luavgl_vlist_varies(v))
+    return index * v->row_height;
+
+  int32_t y = 0;
+  uint32_t b;
+  for (b = 0; b < index / VLIST_BLOCK; b++) {
+    y += v->block_h[b];
+  }
+
+  for (uint32_t i = b * VLIST_BLOCK; i < index; i++) {
+    y += luavgl_vlist_item_h(v, i);
+  }
+
+  return y;
+}
+
+/* Index of the item at y, count if y is below the last one */
+static uint32_t luavgl_vlist_index_at(luavgl_vlist_t *v, int32_t y)
+{
+  if (y <= 0)
+    return 0;
+
+  if (!luavgl_vlist_varies(v))
+    return y / v->row_height;
+
+  uint32_t blocks = (v->count + VLIST_BLOCK - 1) / VLIST_BLOCK;
+  uint32_t b = 0;
+  while (b < blocks && y >= v->block_h[b]) {
+    y -= v->block_h[b];
+    b++;
+  }
+
+  uint32_t i = b * VLIST_BLOCK;
+  while (i < v->count && y >= luavgl_vlist_item_h(v, i)) {
+    y -= luavgl_vlist_item_h(v, i);
+    i++;
+  }
+
+  return LV_MIN(i, v->count);
+}
+
+static void luavgl_vlist_set_item_h(luavgl_vlist_t *v, uint32_t index,
+                                    int32_t h)
+{
+  h = LV_CLAMP(v->row_height, h, UINT16_MAX);
+  int32_t old = luavgl_vlist_item_h(v, index);
+  v->heights[index] = h;
+  v->block_h[index / VLIST_BLOCK] += h - old;
+}
+
+/* Make room for the heights of count items, false if there's no memory */
+static bool luavgl_vlist_reserve_heights(luavgl_vlist_t *v, uint32_t count)
+{
+  if (count <= v->height_cap && v->heights != NULL)
+    return true;
+
+  uint32_t cap = LV_MAX(count, v->height_cap * 2);
+  cap = (cap + VLIST_BLOCK - 1) / VLIST_BLOCK * VLIST_BLOCK;
+  if (cap == 0)
+    cap = VLIST_BLOCK;
+
+  uint16_t *heights = lv_realloc(v->heights, cap * sizeof(*heights));
+  if (heights != NULL)
+    v->heights = heights;
+  int32_t *block_h = lv_realloc(v->block_h, cap / VLIST_BLOCK * sizeof(*block_h));
+  if (block_h != NULL)
+    v->block_h = block_h;
+
+  if (heights == NULL || block_h == NULL) {
+    LV_LOG_WARN("no memory for %" LV_PRIu32 " row heights, rows get row_height",
+                cap);
+    lv_free(v->heights);
+    lv_free(v->block_h);
+    v->heights = NULL;
+    v->block_h = NULL;
+    v->height_cap = 0;
+    return false;
+  }
+
+  lv_memzero(&heights[v->height_cap],
+             (cap - v->height_cap) * sizeof(*heights));
+  v->height_cap = cap;
+  return true;
+}
+
+/* Forget the measured heights, e.g. because rows wrap at another width */
+static void luavgl_vlist_reset_heights(luavgl_vlist_t *v)
+{
+  v->wrap_width = lv_obj_get_content_width(&v->obj);
+  if (v->heights == NULL)
+    return;
+
+  lv_memzero(v->heights, v->count * sizeof(*v->heights));
+  luavgl_vlist_sum_blocks(v, 0);
+}
+
+/* Height a bound row needs for its text and the gap below, 0 if the list has
+ * no width yet */
+static int32_t luavgl_vlist_measure(luavgl_vlist_t *v, lv_obj_t *row)
+{
+  int32_t border = lv_obj_get_style_border_width(row, LV_PART_MAIN);
+  int32_t w = v->wrap_width - lv_obj_get_style_pad_left(row, LV_PART_MAIN) -
+              lv_obj_get_style_pad_right(row, LV_PART_MAIN) - 2 * border;
+  if (w <= 0)
+    return 0;
+
+  lv_point_t size;
+  lv_text_get_size(&size, lv_label_get_text(row),
+                   lv_obj_get_style_text_font(row, LV_PART_MAIN),
+                   lv_obj_get_style_text_letter_space(row, LV_PART_MAIN),
+                   lv_obj_get_style_text_line_space(row, LV_PART_MAIN), w,
+                   LV_TEXT_FLAG_NONE);
+
+  return size.y + lv_obj_get_style_pad_top(row, LV_PART_MAIN) +
+         lv_obj_get_style_pad_bottom(row, LV_PART_MAIN) + 2 * border +
+         lv_obj_get_style_pad_row(&v->obj, LV_PART_MAIN);
+}
+
+static void luavgl_vlist_bind_row(luavgl_vlist_t *v, lv_obj_t *row,
+                                  uint32_t index)
+{
+  lua_State *L = v->L;
+  if (L == NULL || v->bind_ref == LUA_NOREF) {
+    lv_label_set_text_static(row, "");
+    return;
+  }
+
+  int top = lua_gettop(L);
+  lua_rawgeti(L, LUA_REGISTRYINDEX, v->bind_ref);
+  lua_pushinteger(L, index + 1); /* lua index starts from 1 */
+
+  /* Rows are created in C, add them to lua on first use. */
+  lua_pushlightuserdata(L, row);
+  if (lua_rawget(L, LUA_REGISTRYINDEX) == LUA_TNIL) {
+    lua_pop(L, 1);
+    luavgl_add_lobj(L, row);
+  }
+
+  if (luavgl_pcall_int(L, 2, 1) == LUA_OK && lua_type(L, -1) == LUA_TSTRING) {
+    lv_label_set_text(row, lua_tostring(L, -1));
+  }
+
+  lua_settop(L, top);
+}
+
+/**
+ * Place rows at the current scroll position. Only rows whose data index
+ * changed are rebound, unless force is set.
+ * @return how far the first row that was already shown moved down, because
+ *         rows above it got their measured height
+ */
+static int32_t luavgl_vlist_place(luavgl_vlist_t *v, bool force)
+{
+  uint32_t n = v->pool_size;
+  if (n == 0)
+    return 0;
+
+  bool varies = luavgl_vlist_varies(v);
+  int32_t scroll_y = lv_obj_get_scroll_y(&v->obj);
+  int32_t bottom = scroll_y + lv_obj_get_content_height(&v->obj);
+  uint32_t first = luavgl_vlist_index_at(v, scroll_y);
+
+  uint32_t anchor = VLIST_UNBOUND;
+  int32_t anchor_y = 0;
+  for (uint32_t index = first; varies && !force && index < first + n &&
+                               index < v->count;
+       index++) {
+    if (v->row_idx[index % n] == index) {
+      anchor = index;
+      anchor_y = luavgl_vlist_item_y(v, index);
+      break;
+    }
+  }
+
+  uint32_t index = first;
+  int32_t y = luavgl_vlist_item_y(v, first);
+  for (; index < first + n && index < v->count && y < bottom; index++) {
+    uint32_t slot = index % n;
+    lv_obj_t *row = v->rows[slot];
+
+    if (force || v->row_idx[slot] != index) {
+      v->row_idx[slot] = index;
+      luavgl_vlist_bind_row(v, row, index);
+      if (varies) {
+        int32_t h = luavgl_vlist_measure(v, row);
+        if (h > 0)
+          luavgl_vlist_set_item_h(v, index, h);
+      }
+    }
+
+    int32_t h = luavgl_vlist_item_h(v, index);
+    if (lv_obj_has_flag(row, LV_OBJ_FLAG_HIDDEN))
+      lv_obj_remove_flag(row, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_y(row, y);
+    if (varies)
+      lv_obj_set_height(row, h);
+    y += h;
+  }
+
+  /* Rows past the data or the viewport keep their index, they are not
+   * rebound if it shows up again. */
+  for (uint32_t i = index - first; i < n; i++) {
+    lv_obj_t *row = v->rows[(first + i) % n];
+    if (!lv_obj_has_flag(row, LV_OBJ_FLAG_HIDDEN))
+      lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+  }
+
+  if (!varies)
+    return 0;
+
+  lv_obj_set_height(v->spacer, luavgl_vlist_item_y(v, v->count));
+  if (anchor == VLIST_UNBOUND)
+    return 0;
+
+  return luavgl_vlist_item_y(v, anchor) - anchor_y;
+}
+
+static void luavgl_vlist_update(luavgl_vlist_t *v, bool force)
+{
+  if (v->updating)
+    return;
+
+  v->updating = true;
+  int32_t shift = luavgl_vlist_place(v, force);
+  if (shift != 0) {
+    /* Keep the rows that were shown in place, then fill the viewport again */
+    lv_obj_scroll_by_raw(&v->obj, 0, -shift);
+    luavgl_vlist_place(v, false);
+  }
+  v->updating = false;
+}
+
+/**
+ * Size the row pool to the viewport, one extra row covers partial rows at the
+ * top and bottom edge.
+ */
+static bool luavgl_vlist_resize_pool(luavgl_vlist_t *v)
+{
+  lv_obj_t *obj = &v->obj;
+  int32_t h = lv_obj_get_content_height(obj);
+  uint32_t n = h > 0 ? (h + v->row_height - 1) / v->row_height + 1 : 0;
+  if (n == v->pool_size)
+    return false;
+
+  for (uint32_t i = n; i < v->pool_size; i++) {
+    lv_obj_delete(v->rows[i]);
+  }
+
+  lv_obj_t **rows = lv_realloc(v->rows, n * sizeof(*rows));
+  uint32_t *row_idx = lv_realloc(v->row_idx, n * sizeof(*row_idx));
+  if (n && (rows == NULL || row_idx == NULL)) {
+    LV_LOG_ERROR("no memory for %" LV_PRIu32 " rows", n);
+    if (rows)
+      v->rows = rows;
+    if (row_idx)
+      v->row_idx = row_idx;
+    v->pool_size = LV_MIN(n, v->pool_size);
+    return true;
+  }
+
+  for (uint32_t i = v->pool_size; i < n; i++) {
+    lv_obj_t *row = lv_label_create(obj);
+    lv_label_set_long_mode(row, v->wrap ? LV_LABEL_LONG_WRAP
+                                        : LV_LABEL_LONG_DOT);
+    lv_obj_set_size(row, LV_PCT(100), v->row_height);
+    lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_EVENT_BUBBLE);
+    rows[i] = row;
+  }
+
+  v->rows = rows;
+  v->row_idx = row_idx;
+  v->pool_size = n;
+
+  /* slot of an index depends on n, rebind everything */
+  for (uint32_t i = 0; i < n; i++) {
+    v->row_idx[i] = VLIST_UNBOUND;
+  }
+
+  luavgl_vlist_update(v, true);
+  return true;
+}
+
+static void luavgl_vlist_event(const lv_obj_class_t *class_p, lv_event_t *e)
+{
+  LV_UNUSED(class_p);
+
+  lv_result_t res = lv_obj_event_base(&luavgl_vlist_class, e);
+  if (res != LV_RESULT_OK)
+    return;
+
+  lv_event_code_t code = lv_event_get_code(e);
+  luavgl_vlist_t *v = (luavgl_vlist_t *)lv_event_get_current_target(e);
+
+  /* Ignore events bubbled up from rows. */
+  if (lv_event_get_target(e) != &v->obj)
+    return;
+
+  if (code == LV_EVENT_SCROLL) {
+    luavgl_vlist_update(v, false);
+  } else if (code == LV_EVENT_SIZE_CHANGED ||
+             code == LV_EVENT_STYLE_CHANGED) {
+    /* Wrapped rows need to be measured again at a new width */
+    bool remeasure =
+        v->wrap && lv_obj_get_content_width(&v->obj) != v->wrap_width;
+    if (remeasure)
+      luavgl_vlist_reset_heights(v);
+    if (!luavgl_vlist_resize_pool(v) && remeasure)
+      luavgl_vlist_update(v, true);
+  }
+}
+
+static void luavgl_vlist_set_count(luavgl_vlist_t *v, uint32_t count)
+{
+  uint32_t old = v->count;
+  if (v->wrap) {
+    if (count < old && v->heights != NULL)
+      lv_memzero(&v->heights[count], (old - count) * sizeof(*v->heights));
+    else if (count > old)
+      luavgl_vlist_reserve_heights(v, count);
+  }
+
+  v->count = count;
+  luavgl_vlist_sum_blocks(v, LV_MIN(old, count) / VLIST_BLOCK);
+  lv_obj_set_height(v->spacer, luavgl_vlist_item_y(v, count));
+  lv_obj_update_layout(&v->obj);
+  luavgl_vlist_update(v, true);
+}
+
+static int luavgl_vlist_create(lua_State *L)
+{
+  return luavgl_obj_create_helper(L, luavgl_vlist_create_obj);
+}
+
+static luavgl_vlist_t *luavgl_check_vlist(lua_State *L, int idx)
+{
+  lv_obj_t *obj = luavgl_to_obj(L, idx);
+  if (!lv_obj_has_class(obj, &luavgl_vlist_class)) {
+    luaL_argerror(L, idx, "expect virtual list");
+    return NULL;
+  }
+
+  return (luavgl_vlist_t *)obj;
+}
+
+static int _vlist_count(lua_State *L, lv_obj_t *obj, bool set)
+{
+  luavgl_vlist_t *v = (luavgl_vlist_t *)obj;
+  if (set) {
+    lua_Integer count = luavgl_tointeger(L, -1);
+    luavgl_vlist_set_count(v, count > 0 ? count : 0);
+    return 0;
+  }
+
+  lua_pushinteger(L, v->count);
+  return 1;
+}
+
+static int _vlist_row_height(lua_State *L, lv_obj_t *obj, bool set)
+{
+  luavgl_vlist_t *v = (luavgl_vlist_t *)obj;
+  if (set) {
+    int32_t h = luavgl_tointeger(L, -1);
+    if (h <= 0)
+      return luaL_error(L, "row_height must be positive");
+
+    v->row_height = h;
+    for (uint32_t i = 0; i < v->pool_size; i++) {
+      lv_obj_set_height(v->rows[i], h);
+    }
+    /* the least height of wrapped rows changed too */
+    luavgl_vlist_reset_heights(v);
+    luavgl_vlist_resize_pool(v);
+    luavgl_vlist_set_count(v, v->count);
+    return 0;
+  }
+
+  lua_pushinteger(L, v->row_height);
+  return 1;
+}
+
+static int _vlist_wrap(lua_State *L, lv_obj_t *obj, bool set)
+{
+  luavgl_vlist_t *v = (luavgl_vlist_t *)obj;
+  if (!set) {
+    lua_pushboolean(L, v->wrap);
+    return 1;
+  }
+
+  bool wrap = lua_toboolean(L, -1);
+  if (wrap == v->wrap)
+    return 0;
+
+  v->wrap = wrap;
+  if (wrap) {
+    luavgl_vlist_reserve_heights(v, v->count);
+    luavgl_vlist_reset_heights(v);
+  } else {
+    lv_free(v->heights);
+    lv_free(v->block_h);
+    v->heights = NULL;
+    v->block_h = NULL;
+    v->height_cap = 0;
+  }
+
+  for (uint32_t i = 0; i < v->pool_size; i++) {
+    lv_label_set_long_mode(v->rows[i],
+                           wrap ? LV_LABEL_LONG_WRAP : LV_LABEL_LONG_DOT);
+    lv_obj_set_height(v->rows[i], v->row_height);
+  }
+
+  luavgl_vlist_set_count(v, v->count);
+  return 0;
+}
+
+static int _vlist_bind(lua_State *L, lv_obj_t *obj, bool set)
+{
+  luavgl_vlist_t *v = (luavgl_vlist_t *)obj;
+  if (!set)
+    return luaL_error(L, "bind is write only");
+
+  if (v->L != NULL)
+    luaL_unref(v->L, LUA_REGISTRYINDEX, v->bind_ref);
+
+  luavgl_check_callable(L, -1);
+  lua_pushvalue(L, -1);
+  v->L = L;
+  v->bind_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+  luavgl_vlist_update(v, true);
+  return 0;
+}
+
+static const luavgl_property_ops_t vlist_property_ops[] = {
+    {.name = "bind",       .ops = _vlist_bind      },
+    {.name = "count",      .ops = _vlist_count     },
+    {.name = "row_height", .ops = _vlist_row_height},
+    {.name = "wrap",       .ops = _vlist_wrap      },
+};
+
+static const luavgl_table_t vlist_property_table = {
+    .len = sizeof(vlist_property_ops) / sizeof(vlist_property_ops[0]),
+    .array = vlist_property_ops,
+};
+
+/**
+ * list:refresh() rebinds all visible rows, use it after data changed in place.
+ */
+static int luavgl_vlist_refresh(lua_State *L)
+{
+  luavgl_vlist_t *v = luavgl_check_vlist(L, 1);
+  luavgl_vlist_update(v, true);
+  return 0;
+}
+
+/* Scroll the item into view, false if it's visible already */
+static bool luavgl_vlist_scroll_to(luavgl_vlist_t *v, uint32_t index,
+                                   bool anim)
+{
+  /* Bring the row to the bottom if it's below the viewport. */
+  int32_t y = luavgl_vlist_item_y(v, index);
+  int32_t row_h = luavgl_vlist_item_h(v, index);
+  int32_t h = lv_obj_get_content_height(&v->obj);
+  int32_t scroll_y = lv_obj_get_scroll_y(&v->obj);
+  if (y + row_h > scroll_y + h)
+    y = y + row_h - h;
+  else if (y >= scroll_y)
+    return false;
+
+  lv_obj_scroll_to_y(&v->obj, y > 0 ? y : 0, anim ? LV_ANIM_ON : LV_ANIM_OFF);
+  return true;
+}
+
+/**
+ * list:scroll_to_index(index, anim)
+ */
+static int luavgl_vlist_scroll_to_index(lua_State *L)
+{
+  luavgl_vlist_t *v = luavgl_check_vlist(L, 1);
+  lua_Integer index = luavgl_tointeger(L, 2);
+  bool anim = lua_toboolean(L, 3);
+
+  if (index > (lua_Integer)v->count)
+    index = v->count;
+  if (index < 1)
+    return 0;
+
+  if (luavgl_vlist_scroll_to(v, index - 1, anim) && !anim &&
+      luavgl_vlist_varies(v)) {
+    /* The row is measured once shown, it may need more room */
+    lv_obj_update_layout(&v->obj);
+    luavgl_vlist_scroll_to(v, index - 1, false);
+  }
+
+  return 0;
+}
+
+static const rotable_Reg luavgl_vlist_methods[] = {
+    {"refresh",         LUA_TFUNCTION,      {luavgl_vlist_refresh}       },
+    {"scroll_to_index", LUA_TFUNCTION,      {luavgl_vlist_scroll_to_index}},
+
+    {"__property",      LUA_TLIGHTUSERDATA, {.ptr = &vlist_property_table}},
+    {0,                 0,                  {0}                          },
+};
+
+static void luavgl_vlist_init(lua_State *L)
+{
+  luavgl_obj_newmetatable(L, &luavgl_vlist_class, "lv_virtual_list",
+                          luavgl_vlist_methods);
+  lua_pop(L, 1);
+}
@@ -45,6 +45,10 @@
 #include "button.c"
 #endif
 
+#if LV_USE_LABEL
+#include "vlist.c"
+#endif
+
 static int luavgl_obj_create(lua_State *L);
 
 static const luaL_Reg widget_create_methods[] = {
@@ -93,6 +97,10 @@ static const luaL_Reg widget_create_methods[] = {
 #if LV_USE_TEXTAREA
     {"Button",   luavgl_button_create  },
 #endif
+
+#if LV_USE_LABEL
+    {"VirtualList", luavgl_vlist_create  },
+#endif
     {NULL,       NULL                  }
 };
 
@@ -141,4 +149,8 @@ static void luavgl_widgets_init(lua_State *L)
 #if LV_USE_DROPDOWN
   luavgl_button_init(L);
 #endif
+
+#if LV_USE_LABEL
+  luavgl_vlist_init(L);
+#endif
 }
@@ -75,6 +75,11 @@
 /*Default display refresh, input device read and animation step period.*/
 #define LV_DEF_REFR_PERIOD  33      /*[ms]*/
 
+/*Cost of refreshing one more invalidated area, expressed in pixels (area setup, flush call, address window).
+ *Two invalidated areas are joined if their bounding box is smaller than their summed size plus this cost.
+ *0: join only overlapping areas*/
+#define LV_INV_AREA_JOIN_COST 512
+
 /*Default Dot Per Inch. Used to initialize default sizes such as widgets sized, style paddings.
  *(Not so important, you can adjust it to modify default sizes and spaces)*/
 #define LV_DPI_DEF 130     /*[px/inch]*/
@@ -91,12 +96,24 @@
  * - LV_OS_WINDOWS
  * - LV_OS_MQX
  * - LV_OS_CUSTOM */
-#define LV_USE_OS   LV_OS_NONE
+/*The host simulator builds with `LV_USE_OS=LV_OS_PTHREAD`*/
+#ifndef LV_USE_OS
+    #define LV_USE_OS   LV_OS_FREERTOS
+#endif
 
 #if LV_USE_OS == LV_OS_CUSTOM
     #define LV_OS_CUSTOM_INCLUDE <stdint.h>
 #endif
 
+#if LV_USE_OS == LV_OS_FREERTOS
+    /*Pin the draw threads to the cores in turn: one software draw unit per core*/
+    #define LV_FREERTOS_PIN_THREADS     1
+
+    /*The loop task sleeps on its task notification (`schedulerSleep()`),
+     *so LVGL's render waits use semaphores instead*/
+    #define USE_FREERTOS_TASK_NOTIFY    0
+#endif
+
 /*========================
  * RENDERING CONFIGURATION
  *========================*/
@@ -149,7 +166,9 @@
 	/* Set the number of draw unit.
      * > 1 requires an operating system enabled in `LV_USE_OS`
      * > 1 means multiple threads will render the screen in parallel */
-    #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+    #ifndef LV_DRAW_SW_DRAW_UNIT_CNT
+        #define LV_DRAW_SW_DRAW_UNIT_CNT    2
+    #endif
 
     /* Use Arm-2D to accelerate the sw render */
     #define LV_USE_DRAW_ARM2D_SYNC      0
@@ -174,7 +193,15 @@
         #define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
     #endif
 
-    #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_NONE
+    /* LV_DRAW_SW_ASM_SWAR: RGB565 blending with portable vector code, several pixels per operation.
+     * Its speedup was measured on the host only. GCC lowers the vector types to scalar code on Xtensa,
+     * so the gain on the ESP32-S3 is unverified.
+     * A target specific file (e.g. ESP32-S3 PIE) can replace single operations, see `lv_blend_swar.h`:
+     * #define LV_DRAW_SW_SWAR_CUSTOM_INCLUDE "my_blend_pie.h"
+     * The host blend test builds its scalar reference with `LV_USE_DRAW_SW_ASM=LV_DRAW_SW_ASM_NONE`. */
+    #ifndef LV_USE_DRAW_SW_ASM
+        #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_SWAR
+    #endif
 
     #if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_CUSTOM
         #define  LV_DRAW_SW_ASM_CUSTOM_INCLUDE ""
@@ -346,6 +373,14 @@
  *The main logic is like `LV_CACHE_DEF_SIZE` but for image headers.*/
 #define LV_IMAGE_HEADER_CACHE_DEF_CNT 0
 
+/*Size of the glyph cache in bytes.
+ *Letters of fonts in the built-in format are kept unpacked as A8 bitmaps with their metrics,
+ *so drawing them again doesn't look up and decompress the glyph. 0 disables the cache.
+ *See `lv_glyph_cache_set_allocator()` to put the bitmaps in external RAM.*/
+#ifndef LV_GLYPH_CACHE_SIZE
+#define LV_GLYPH_CACHE_SIZE (32 * 1024U)
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #define LV_GRADIENT_MAX_STOPS   2
@@ -600,6 +635,7 @@
 #if LV_USE_LABEL
     #define LV_LABEL_TEXT_SELECTION 1 /*Enable selecting text of the label*/
     #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
+    #define LV_LABEL_LINE_CACHE 1  /*Keep the line breaks of labels to re-measure only the edited lines and draw without breaking the text again*/
     #define LV_LABEL_WAIT_CHAR_COUNT 3  /*The count of wait chart*/
 #endif
 
@@ -74,6 +74,11 @@
 /*Default display refresh, input device read and animation step period.*/
 #define LV_DEF_REFR_PERIOD  33      /*[ms]*/
 
+/*Cost of refreshing one more invalidated area, expressed in pixels (area setup, flush call, address window).
+ *Two invalidated areas are joined if their bounding box is smaller than their summed size plus this cost.
+ *0: join only overlapping areas*/
+#define LV_INV_AREA_JOIN_COST 0
+
 /*Default Dot Per Inch. Used to initialize default sizes such as widgets sized, style paddings.
  *(Not so important, you can adjust it to modify default sizes and spaces)*/
 #define LV_DPI_DEF 130     /*[px/inch]*/
@@ -345,6 +350,12 @@
  *The main logic is like `LV_CACHE_DEF_SIZE` but for image headers.*/
 #define LV_IMAGE_HEADER_CACHE_DEF_CNT 0
 
+/*Size of the glyph cache in bytes.
+ *Letters of fonts in the built-in format are kept unpacked as A8 bitmaps with their metrics,
+ *so drawing them again doesn't look up and decompress the glyph. 0 disables the cache.
+ *See `lv_glyph_cache_set_allocator()` to put the bitmaps in external RAM.*/
+#define LV_GLYPH_CACHE_SIZE 0
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #define LV_GRADIENT_MAX_STOPS   2
@@ -599,6 +610,7 @@
 #if LV_USE_LABEL
     #define LV_LABEL_TEXT_SELECTION 1 /*Enable selecting text of the label*/
     #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
+    #define LV_LABEL_LINE_CACHE 0  /*Keep the line breaks of labels to re-measure only the edited lines and draw without breaking the text again*/
     #define LV_LABEL_WAIT_CHAR_COUNT 3  /*The count of wait chart*/
 #endif
 
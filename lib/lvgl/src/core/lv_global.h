@@ -27,6 +27,7 @@ extern "C" {
 #include "../misc/lv_log.h"
 #include "../misc/lv_style.h"
 #include "../misc/lv_timer.h"
+#include "../misc/cache/lv_glyph_cache.h"
 #include "../osal/lv_os.h"
 #include "../others/sysmon/lv_sysmon.h"
 #include "../stdlib/builtin/lv_tlsf.h"
@@ -121,6 +122,13 @@ typedef struct lv_global_t {
     lv_cache_t * img_cache;
     lv_cache_t * img_header_cache;
 
+    lv_cache_t * glyph_cache;
+    lv_glyph_cache_malloc_cb_t glyph_cache_malloc;
+    lv_glyph_cache_free_cb_t glyph_cache_free;
+    uint32_t glyph_cache_hits;
+    uint32_t glyph_cache_misses;
+    uint32_t glyph_cache_evictions;
+
     lv_draw_global_info_t draw_info;
 #if defined(LV_DRAW_SW_SHADOW_CACHE_SIZE) && LV_DRAW_SW_SHADOW_CACHE_SIZE > 0
     lv_draw_sw_shadow_cache_t sw_shadow_cache;
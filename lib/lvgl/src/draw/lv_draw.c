@@ -182,7 +182,7 @@ bool lv_draw_dispatch_layer(lv_display_t * disp, lv_layer_t * layer)
     lv_draw_task_t * t = layer->draw_task_head;
     while(t) {
         lv_draw_task_t * t_next = t->next;
-        if(t->state == LV_DRAW_TASK_STATE_READY) {
+        if(LV_ATOMIC_LOAD(&t->state) == LV_DRAW_TASK_STATE_READY) {
             if(t_prev) t_prev->next = t->next;      /*Remove it by assigning the next task to the previous*/
             else layer->draw_task_head = t_next;    /*If it was the head, set the next as head*/
 
@@ -238,7 +238,7 @@ bool lv_draw_dispatch_layer(lv_display_t * disp, lv_layer_t * layer)
         /*Find a draw task with TYPE_LAYER in the layer where the src is this layer*/
         lv_draw_task_t * t_src = layer->parent->draw_task_head;
         while(t_src) {
-            if(t_src->type == LV_DRAW_TASK_TYPE_LAYER && t_src->state == LV_DRAW_TASK_STATE_WAITING) {
+            if(t_src->type == LV_DRAW_TASK_TYPE_LAYER && LV_ATOMIC_LOAD(&t_src->state) == LV_DRAW_TASK_STATE_WAITING) {
                 lv_draw_image_dsc_t * draw_dsc = t_src->draw_dsc;
                 if(draw_dsc->src == layer) {
                     t_src->state = LV_DRAW_TASK_STATE_QUEUED;
@@ -292,7 +292,7 @@ lv_draw_task_t * lv_draw_get_next_available_task(lv_layer_t * layer, lv_draw_tas
         int32_t hor_res = lv_display_get_horizontal_resolution(lv_refr_get_disp_refreshing());
         int32_t ver_res = lv_display_get_vertical_resolution(lv_refr_get_disp_refreshing());
         lv_draw_task_t * t = layer->draw_task_head;
-        if(t->state != LV_DRAW_TASK_STATE_QUEUED &&
+        if(LV_ATOMIC_LOAD(&t->state) != LV_DRAW_TASK_STATE_QUEUED &&
            t->area.x1 <= 0 && t->area.x2 >= hor_res - 1 &&
            t->area.y1 <= 0 && t->area.y2 >= ver_res - 1) {
             LV_PROFILER_END;
@@ -303,7 +303,7 @@ lv_draw_task_t * lv_draw_get_next_available_task(lv_layer_t * layer, lv_draw_tas
     lv_draw_task_t * t = t_prev ? t_prev->next : layer->draw_task_head;
     while(t) {
         /*Find a queued and independent task*/
-        if(t->state == LV_DRAW_TASK_STATE_QUEUED &&
+        if(LV_ATOMIC_LOAD(&t->state) == LV_DRAW_TASK_STATE_QUEUED &&
            (t->preferred_draw_unit_id == LV_DRAW_UNIT_NONE || t->preferred_draw_unit_id == draw_unit_id) &&
            is_independent(layer, t)) {
             LV_PROFILER_END;
@@ -326,7 +326,8 @@ uint32_t lv_draw_get_dependent_count(lv_draw_task_t * t_check)
 
     lv_draw_task_t * t = t_check->next;
     while(t) {
-        if((t->state == LV_DRAW_TASK_STATE_QUEUED || t->state == LV_DRAW_TASK_STATE_WAITING) &&
+        int state = LV_ATOMIC_LOAD(&t->state);
+        if((state == LV_DRAW_TASK_STATE_QUEUED || state == LV_DRAW_TASK_STATE_WAITING) &&
            lv_area_is_on(&t_check->area, &t->area)) {
             cnt++;
         }
@@ -431,7 +432,7 @@ static bool is_independent(lv_layer_t * layer, lv_draw_task_t * t_check)
 
     /*If t_check is outside of the older tasks then it's independent*/
     while(t && t != t_check) {
-        if(t->state != LV_DRAW_TASK_STATE_READY) {
+        if(LV_ATOMIC_LOAD(&t->state) != LV_DRAW_TASK_STATE_READY) {
             lv_area_t a;
             if(lv_area_intersect(&a, &t->_real_area, &t_check->_real_area)) {
                 LV_PROFILER_END;
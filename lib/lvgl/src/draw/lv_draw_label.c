@@ -20,6 +20,7 @@
 #include "../stdlib/lv_mem.h"
 #include "../stdlib/lv_string.h"
 #include "../core/lv_global.h"
+#include "../misc/cache/lv_glyph_cache.h"
 
 /*********************
  *      DEFINES
@@ -38,6 +39,10 @@
  **********************/
 static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,  const lv_point_t * pos,
                         const lv_font_t * font, uint32_t letter, lv_draw_glyph_cb_t cb);
+static uint32_t get_line_end(const lv_draw_label_dsc_t * dsc, const lv_text_lines_t * lines, uint32_t line_id,
+                             uint32_t line_start, int32_t w);
+static int32_t get_line_width(const lv_draw_label_dsc_t * dsc, const lv_text_lines_t * lines, uint32_t line_id,
+                              uint32_t line_start, uint32_t line_end);
 
 /**********************
  *  STATIC VARIABLES
@@ -162,10 +167,19 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
 
     lv_bidi_calculate_align(&align, &base_dir, dsc->text);
 
+    const lv_text_lines_t * lines = dsc->lines;
+    if(lines && !lv_text_lines_matches(lines, font, dsc->letter_space, lv_area_get_width(coords), dsc->flag)) {
+        lines = NULL;
+    }
+
     if((dsc->flag & LV_TEXT_FLAG_EXPAND) == 0) {
         /*Normally use the label's width as width*/
         w = lv_area_get_width(coords);
     }
+    else if(lines) {
+        /*The lines break only at new lines, so the longest one is the width*/
+        w = lines->width;
+    }
     else {
         /*If EXPAND is enabled then not limit the text's width to the object's width*/
         lv_point_t p;
@@ -189,10 +203,11 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
     pos.y += y_ofs;
 
     uint32_t line_start     = 0;
+    uint32_t line_id        = 0;
     int32_t last_line_start = -1;
 
-    /*Check the hint to use the cached info*/
-    if(dsc->hint && y_ofs == 0 && coords->y1 < 0) {
+    /*Check the hint to use the cached info. With known lines it's not needed.*/
+    if(dsc->hint && lines == NULL && y_ofs == 0 && coords->y1 < 0) {
         /*If the label changed too much recalculate the hint.*/
         if(LV_ABS(dsc->hint->coord_y - coords->y1) > LV_LABEL_HINT_UPDATE_TH - 2 * line_height) {
             dsc->hint->line_start = -1;
@@ -206,14 +221,14 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
         pos.y += dsc->hint->y;
     }
 
-    uint32_t line_end = line_start + lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL,
-                                                           dsc->flag);
+    uint32_t line_end = get_line_end(dsc, lines, line_id, line_start, w);
 
     /*Go the first visible line*/
     while(pos.y + line_height_font < draw_unit->clip_area->y1) {
         /*Go to next line*/
         line_start = line_end;
-        line_end += lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        line_id++;
+        line_end = get_line_end(dsc, lines, line_id, line_start, w);
         pos.y += line_height;
 
         /*Save at the threshold coordinate*/
@@ -228,14 +243,14 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
 
     /*Align to middle*/
     if(align == LV_TEXT_ALIGN_CENTER) {
-        line_width = lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+        line_width = get_line_width(dsc, lines, line_id, line_start, line_end);
 
         pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
     }
     /*Align to the right*/
     else if(align == LV_TEXT_ALIGN_RIGHT) {
-        line_width = lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+        line_width = get_line_width(dsc, lines, line_id, line_start, line_end);
         pos.x += lv_area_get_width(coords) - line_width;
     }
 
@@ -346,20 +361,19 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
 #endif
         /*Go to next line*/
         line_start = line_end;
-        line_end += lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        line_id++;
+        line_end = get_line_end(dsc, lines, line_id, line_start, w);
 
         pos.x = coords->x1;
         /*Align to middle*/
         if(align == LV_TEXT_ALIGN_CENTER) {
-            line_width =
-                lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+            line_width = get_line_width(dsc, lines, line_id, line_start, line_end);
 
             pos.x += (lv_area_get_width(coords) - line_width) / 2;
         }
         /*Align to the right*/
         else if(align == LV_TEXT_ALIGN_RIGHT) {
-            line_width =
-                lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+            line_width = get_line_width(dsc, lines, line_id, line_start, line_end);
             pos.x += lv_area_get_width(coords) - line_width;
         }
 
@@ -387,14 +401,24 @@ static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,
         return;
 
     LV_PROFILER_BEGIN;
-    bool g_ret = lv_font_get_glyph_dsc(font, &g, letter, '\0');
-    if(g_ret == false) {
-        /*Add warning if the dsc is not found*/
-        LV_LOG_WARN("lv_draw_letter: glyph dsc. not found for U+%" LV_PRIX32, letter);
+
+    /*Take the metrics and the unpacked bitmap from the glyph cache if the font can be cached*/
+    lv_cache_entry_t * cache_entry = lv_glyph_cache_acquire(font, letter);
+    const lv_glyph_cache_data_t * cached = cache_entry ? lv_cache_entry_get_data(cache_entry) : NULL;
+    if(cached) {
+        g = cached->g;
+    }
+    else {
+        bool g_ret = lv_font_get_glyph_dsc(font, &g, letter, '\0');
+        if(g_ret == false) {
+            /*Add warning if the dsc is not found*/
+            LV_LOG_WARN("lv_draw_letter: glyph dsc. not found for U+%" LV_PRIX32, letter);
+        }
     }
 
     /*Don't draw anything if the character is empty. E.g. space*/
     if((g.box_h == 0) || (g.box_w == 0)) {
+        if(cache_entry) lv_glyph_cache_release(cache_entry);
         LV_PROFILER_END;
         return;
     }
@@ -408,11 +432,16 @@ static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,
     /*If the letter is completely out of mask don't draw it*/
     if(lv_area_is_out(&letter_coords, draw_unit->clip_area, 0) &&
        lv_area_is_out(dsc->bg_coords, draw_unit->clip_area, 0)) {
+        if(cache_entry) lv_glyph_cache_release(cache_entry);
         LV_PROFILER_END;
         return;
     }
 
-    if(g.resolved_font) {
+    if(cached) {
+        dsc->glyph_data = cached->draw_buf;
+        dsc->format = cached->draw_buf ? g.format : LV_FONT_GLYPH_FORMAT_NONE;
+    }
+    else if(g.resolved_font) {
         lv_draw_buf_t * draw_buf = NULL;
         if(LV_FONT_GLYPH_FORMAT_NONE < g.format && g.format < LV_FONT_GLYPH_FORMAT_IMAGE) {
             /*Only check draw buf for bitmap glyph*/
@@ -440,7 +469,33 @@ static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,
     dsc->g = &g;
     cb(draw_unit, dsc, NULL, NULL);
 
-    lv_font_glyph_release_draw_data(&g);
+    if(cache_entry) lv_glyph_cache_release(cache_entry);
+    else lv_font_glyph_release_draw_data(&g);
 
     LV_PROFILER_END;
 }
+
+/**
+ * Get the end of a line from the known lines or by breaking the text
+ */
+static uint32_t get_line_end(const lv_draw_label_dsc_t * dsc, const lv_text_lines_t * lines, uint32_t line_id,
+                             uint32_t line_start, int32_t w)
+{
+    if(lines) {
+        if(line_id >= lv_text_lines_get_count(lines)) return line_start;
+        return lv_text_lines_get_start(lines, line_id + 1);
+    }
+
+    return line_start + lv_text_get_next_line(&dsc->text[line_start], dsc->font, dsc->letter_space, w, NULL, dsc->flag);
+}
+
+static int32_t get_line_width(const lv_draw_label_dsc_t * dsc, const lv_text_lines_t * lines, uint32_t line_id,
+                              uint32_t line_start, uint32_t line_end)
+{
+    if(lines) {
+        if(line_id >= lv_text_lines_get_count(lines)) return 0;
+        return lv_text_lines_get_width(lines, line_id);
+    }
+
+    return lv_text_get_width(&dsc->text[line_start], line_end - line_start, dsc->font, dsc->letter_space);
+}
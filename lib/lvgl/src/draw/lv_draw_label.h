@@ -54,6 +54,10 @@ typedef struct {
      * 0: `text` is const and it's pointer will be valid during rendering.*/
     uint8_t text_local : 1;
     lv_draw_label_hint_t * hint;
+    /**
+     * Line breaks of `text` to draw without breaking the lines again, or NULL.
+     * Used only if they were broken with the same font, letter space, width and flags.*/
+    const lv_text_lines_t * lines;
 } lv_draw_label_dsc_t;
 
 /**
@@ -0,0 +1,343 @@
+/**
+ * @file lv_blend_swar.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lv_blend_swar.h"
+
+#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_SWAR
+
+#include "../lv_draw_sw_blend_private.h"
+#include "../../../../misc/lv_color.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*Pixels handled by one vector operation. A group is 64 bits of RGB565 and its masks are tested as one word.*/
+#define LANES   4
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*One RGB565 pixel (or channel, or mix value) per 32-bit lane*/
+typedef uint32_t px_t __attribute__((vector_size(LANES * 4)));
+
+/*The four RGB565 pixels of a group as one word*/
+typedef uint64_t group_word_t __attribute__((aligned(2), may_alias));
+
+/*The group functions are inlined into the row loops so full groups work on constant lengths*/
+#define SWAR_INLINE inline __attribute__((always_inline))
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static SWAR_INLINE void color_group(uint16_t * dest, const lv_opa_t * mask, px_t color, uint32_t opa, int32_t n);
+static SWAR_INLINE void rgb565_group(uint16_t * dest, const uint16_t * src, const lv_opa_t * mask, uint32_t opa,
+                                     int32_t n);
+static SWAR_INLINE void blend_color_mask(lv_draw_sw_blend_fill_dsc_t * dsc, uint32_t opa);
+static SWAR_INLINE void blend_rgb565(lv_draw_sw_blend_image_dsc_t * dsc, uint32_t opa);
+
+static SWAR_INLINE px_t load_u16(const uint16_t * buf, int32_t n);
+static SWAR_INLINE uint64_t load_u64(const uint16_t * buf);
+static SWAR_INLINE void store_u64(uint16_t * buf, uint64_t v);
+static SWAR_INLINE px_t load_u8(const uint8_t * buf, int32_t n);
+static SWAR_INLINE void store_u16(uint16_t * buf, px_t v, int32_t n);
+static SWAR_INLINE uint32_t mask_word(const lv_opa_t * mask, int32_t n);
+static SWAR_INLINE px_t mix_16_16(px_t fg, px_t bg, px_t mix);
+static SWAR_INLINE px_t xrgb8888_to_rgb565(const uint8_t * buf, int32_t n);
+static inline void * drawbuf_next_row(const void * buf, uint32_t stride);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM lv_color_blend_to_rgb565_with_opa_swar(lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    px_t color = (px_t){0} + lv_color_to_u16(dsc->color);
+    px_t opa = (px_t){0} + dsc->opa;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    int32_t dest_stride = dsc->dest_stride;
+
+    /*Backgrounds are mostly flat: while a group repeats the last one, reuse its result.
+     *The groups are compared and stored as 64-bit words.*/
+    uint64_t last_dest = 0;
+    uint64_t last_res = 0;
+    bool cached = false;
+
+    int32_t y;
+    int32_t x;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x <= w - LANES; x += LANES) {
+            uint64_t dest64 = load_u64(&dest_buf_u16[x]);
+            if(!cached || dest64 != last_dest) {
+                px_t res = mix_16_16(color, load_u16(&dest_buf_u16[x], LANES), opa);
+                store_u16(&dest_buf_u16[x], res, LANES);
+                last_dest = dest64;
+                last_res = load_u64(&dest_buf_u16[x]);
+                cached = true;
+            }
+            else {
+                store_u64(&dest_buf_u16[x], last_res);
+            }
+        }
+
+        if(x < w) {
+            px_t dest = load_u16(&dest_buf_u16[x], w - x);
+            store_u16(&dest_buf_u16[x], mix_16_16(color, dest, opa), w - x);
+        }
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+    }
+
+    return LV_RESULT_OK;
+}
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM lv_color_blend_to_rgb565_with_mask_swar(lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    blend_color_mask(dsc, LV_OPA_COVER);
+    return LV_RESULT_OK;
+}
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM lv_color_blend_to_rgb565_mix_mask_opa_swar(lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    blend_color_mask(dsc, dsc->opa);
+    return LV_RESULT_OK;
+}
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM lv_rgb565_blend_normal_to_rgb565_with_opa_swar(lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    blend_rgb565(dsc, dsc->opa);
+    return LV_RESULT_OK;
+}
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM lv_rgb565_blend_normal_to_rgb565_with_mask_swar(lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    blend_rgb565(dsc, LV_OPA_COVER);
+    return LV_RESULT_OK;
+}
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM lv_rgb565_blend_normal_to_rgb565_mix_mask_opa_swar(lv_draw_sw_blend_image_dsc_t *
+                                                                                      dsc)
+{
+    blend_rgb565(dsc, dsc->opa);
+    return LV_RESULT_OK;
+}
+
+lv_result_t LV_ATTRIBUTE_FAST_MEM lv_rgb888_blend_normal_to_rgb565_swar(lv_draw_sw_blend_image_dsc_t * dsc,
+                                                                         uint32_t src_px_size)
+{
+    /*3 byte pixels are gathered byte by byte, the scalar loop does that as well*/
+    if(src_px_size != 4) return LV_RESULT_INVALID;
+
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    int32_t dest_stride = dsc->dest_stride;
+    const uint8_t * src_buf_u8 = dsc->src_buf;
+    int32_t src_stride = dsc->src_stride;
+
+    int32_t y;
+    int32_t x;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x <= w - LANES; x += LANES) {
+            store_u16(&dest_buf_u16[x], xrgb8888_to_rgb565(&src_buf_u8[x * 4], LANES), LANES);
+        }
+        if(x < w) store_u16(&dest_buf_u16[x], xrgb8888_to_rgb565(&src_buf_u8[x * 4], w - x), w - x);
+
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+        src_buf_u8 += src_stride;
+    }
+
+    return LV_RESULT_OK;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*`opa` is LV_OPA_COVER for the variants where the scalar code ignores the opacity*/
+
+static SWAR_INLINE void blend_color_mask(lv_draw_sw_blend_fill_dsc_t * dsc, uint32_t opa)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    px_t color = (px_t){0} + lv_color_to_u16(dsc->color);
+    const lv_opa_t * mask = dsc->mask_buf;
+    int32_t mask_stride = dsc->mask_stride;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    int32_t dest_stride = dsc->dest_stride;
+
+    int32_t y;
+    int32_t x;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x <= w - LANES; x += LANES) {
+            color_group(&dest_buf_u16[x], &mask[x], color, opa, LANES);
+        }
+        if(x < w) color_group(&dest_buf_u16[x], &mask[x], color, opa, w - x);
+
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+        mask += mask_stride;
+    }
+}
+
+static SWAR_INLINE void blend_rgb565(lv_draw_sw_blend_image_dsc_t * dsc, uint32_t opa)
+{
+    int32_t w = dsc->dest_w;
+    int32_t h = dsc->dest_h;
+    uint16_t * dest_buf_u16 = dsc->dest_buf;
+    int32_t dest_stride = dsc->dest_stride;
+    const uint16_t * src_buf_u16 = dsc->src_buf;
+    int32_t src_stride = dsc->src_stride;
+    const lv_opa_t * mask_buf = dsc->mask_buf;
+    int32_t mask_stride = dsc->mask_stride;
+
+    int32_t y;
+    int32_t x;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x <= w - LANES; x += LANES) {
+            rgb565_group(&dest_buf_u16[x], &src_buf_u16[x], mask_buf ? &mask_buf[x] : NULL, opa, LANES);
+        }
+        if(x < w) rgb565_group(&dest_buf_u16[x], &src_buf_u16[x], mask_buf ? &mask_buf[x] : NULL, opa, w - x);
+
+        dest_buf_u16 = drawbuf_next_row(dest_buf_u16, dest_stride);
+        src_buf_u16 = drawbuf_next_row(src_buf_u16, src_stride);
+        if(mask_buf) mask_buf += mask_stride;
+    }
+}
+
+static SWAR_INLINE void color_group(uint16_t * dest, const lv_opa_t * mask, px_t color, uint32_t opa, int32_t n)
+{
+    uint32_t m32 = mask_word(mask, n);
+    if(m32 == 0) return;
+    if(m32 == 0xFFFFFFFF && opa >= LV_OPA_MAX) {
+        store_u16(dest, color, n);
+        return;
+    }
+
+    px_t mix = load_u8(mask, n);
+    if(opa < LV_OPA_MAX) mix = (mix * opa) >> 8;
+    store_u16(dest, mix_16_16(color, load_u16(dest, n), mix), n);
+}
+
+static SWAR_INLINE void rgb565_group(uint16_t * dest, const uint16_t * src, const lv_opa_t * mask, uint32_t opa,
+                                     int32_t n)
+{
+    px_t mix = (px_t){0} + opa;
+    if(mask) {
+        uint32_t m32 = mask_word(mask, n);
+        if(m32 == 0) return;
+        if(m32 == 0xFFFFFFFF && opa >= LV_OPA_MAX) {
+            store_u16(dest, load_u16(src, n), n);
+            return;
+        }
+
+        mix = load_u8(mask, n);
+        if(opa < LV_OPA_MAX) mix = (mix * opa) >> 8;
+    }
+
+    store_u16(dest, mix_16_16(load_u16(src, n), load_u16(dest, n), mix), n);
+}
+
+static SWAR_INLINE px_t load_u16(const uint16_t * buf, int32_t n)
+{
+    px_t v = {0};
+    int32_t i;
+    for(i = 0; i < n; i++) v[i] = buf[i];
+    return v;
+}
+
+static SWAR_INLINE px_t load_u8(const uint8_t * buf, int32_t n)
+{
+    px_t v = {0};
+    int32_t i;
+    for(i = 0; i < n; i++) v[i] = buf[i];
+    return v;
+}
+
+static SWAR_INLINE void store_u16(uint16_t * buf, px_t v, int32_t n)
+{
+    int32_t i;
+    for(i = 0; i < n; i++) buf[i] = (uint16_t)v[i];
+}
+
+/*A whole group as one word, for comparing and copying results*/
+static SWAR_INLINE uint64_t load_u64(const uint16_t * buf)
+{
+    return *(const group_word_t *)buf;
+}
+
+static SWAR_INLINE void store_u64(uint16_t * buf, uint64_t v)
+{
+    *(group_word_t *)buf = v;
+}
+
+/**
+ * The mask values of a group packed in a word: 0 if all are transparent,
+ * 0xFFFFFFFF if all are opaque. Missing pixels of a short group count as opaque.
+ */
+static SWAR_INLINE uint32_t mask_word(const lv_opa_t * mask, int32_t n)
+{
+    uint32_t m32 = 0;
+    int32_t i;
+    for(i = 0; i < n; i++) m32 |= (uint32_t)mask[i] << (i * 8);
+
+    if(n < LANES && m32 != 0) m32 |= 0xFFFFFFFF << (n * 8);
+    return m32;
+}
+
+/**
+ * lv_color_16_16_mix() on every lane. Its early returns (mix 0 and 255, equal colors)
+ * give the same result as the formula, so no lane needs a branch.
+ * Only the lower 16 bits of the result are valid.
+ */
+static SWAR_INLINE px_t mix_16_16(px_t fg, px_t bg, px_t mix)
+{
+    mix = (mix + 4) >> 3;
+    fg = (fg | (fg << 16)) & 0x7E0F81F;
+    bg = (bg | (bg << 16)) & 0x7E0F81F;
+    px_t res = ((((fg - bg) * mix) >> 5) + bg) & 0x7E0F81F;
+    return (res >> 16) | res;
+}
+
+/**
+ * Convert XRGB8888 pixels. Aligned pixels are loaded as words and split with shifts.
+ */
+static SWAR_INLINE px_t xrgb8888_to_rgb565(const uint8_t * buf, int32_t n)
+{
+    px_t v = {0};
+    int32_t i;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if(((lv_uintptr_t)buf & 0x3) == 0) {
+        for(i = 0; i < n; i++) v[i] = ((const uint32_t *)buf)[i];
+    }
+    else
+#endif
+    {
+        for(i = 0; i < n; i++) v[i] = buf[i * 4] | (buf[i * 4 + 1] << 8) | (buf[i * 4 + 2] << 16);
+    }
+
+    return ((v >> 8) & 0xF800) + ((v >> 5) & 0x07E0) + ((v >> 3) & 0x001F);
+}
+
+static inline void * drawbuf_next_row(const void * buf, uint32_t stride)
+{
+    return (void *)((uint8_t *)buf + stride);
+}
+
+#endif /*LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_SWAR*/
@@ -0,0 +1,110 @@
+/**
+ * @file lv_blend_swar.h
+ *
+ * RGB565 blending with GCC vector extensions, several pixels per operation.
+ * The results are bit exact with the scalar code of `lv_draw_sw_blend_to_rgb565.c`.
+ * Only the cases where the scalar code is slower are replaced: color fills with opacity
+ * or mask, RGB565 images with opacity or mask and XRGB8888 conversion. Plain fills and
+ * copies are already word sized, 24 bit mixing is inlined there.
+ *
+ * `LV_DRAW_SW_SWAR_CUSTOM_INCLUDE` is included first: a target specific
+ * implementation (e.g. ESP32-S3 PIE) can define any of the macros below and
+ * the rest still use this backend.
+ */
+
+#ifndef LV_BLEND_SWAR_H
+#define LV_BLEND_SWAR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../../../lv_conf_internal.h"
+
+#if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_SWAR
+
+#include "../../../../misc/lv_types.h"
+
+#ifdef LV_DRAW_SW_SWAR_CUSTOM_INCLUDE
+#include LV_DRAW_SW_SWAR_CUSTOM_INCLUDE
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc) \
+    lv_color_blend_to_rgb565_with_opa_swar(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc) \
+    lv_color_blend_to_rgb565_with_mask_swar(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc) \
+    lv_color_blend_to_rgb565_mix_mask_opa_swar(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)  \
+    lv_rgb565_blend_normal_to_rgb565_with_opa_swar(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_MASK(dsc)  \
+    lv_rgb565_blend_normal_to_rgb565_with_mask_swar(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_MIX_MASK_OPA(dsc)  \
+    lv_rgb565_blend_normal_to_rgb565_mix_mask_opa_swar(dsc)
+#endif
+
+#ifndef LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565
+#define LV_DRAW_SW_RGB888_BLEND_NORMAL_TO_RGB565(dsc, src_px_size)  \
+    lv_rgb888_blend_normal_to_rgb565_swar(dsc, src_px_size)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+lv_result_t lv_color_blend_to_rgb565_with_opa_swar(lv_draw_sw_blend_fill_dsc_t * dsc);
+
+lv_result_t lv_color_blend_to_rgb565_with_mask_swar(lv_draw_sw_blend_fill_dsc_t * dsc);
+
+lv_result_t lv_color_blend_to_rgb565_mix_mask_opa_swar(lv_draw_sw_blend_fill_dsc_t * dsc);
+
+lv_result_t lv_rgb565_blend_normal_to_rgb565_with_opa_swar(lv_draw_sw_blend_image_dsc_t * dsc);
+
+lv_result_t lv_rgb565_blend_normal_to_rgb565_with_mask_swar(lv_draw_sw_blend_image_dsc_t * dsc);
+
+lv_result_t lv_rgb565_blend_normal_to_rgb565_mix_mask_opa_swar(lv_draw_sw_blend_image_dsc_t * dsc);
+
+/**
+ * Convert XRGB8888 images; returns LV_RESULT_INVALID for RGB888 which the scalar code handles
+ */
+lv_result_t lv_rgb888_blend_normal_to_rgb565_swar(lv_draw_sw_blend_image_dsc_t * dsc, uint32_t src_px_size);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_SWAR*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_BLEND_SWAR_H*/
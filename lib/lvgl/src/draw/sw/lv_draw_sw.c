@@ -343,8 +343,8 @@ static inline void execute_drawing_unit(lv_draw_sw_unit_t * u)
 {
     execute_drawing(u);
 
-    u->task_act->state = LV_DRAW_TASK_STATE_READY;
-    u->task_act = NULL;
+    LV_ATOMIC_STORE(&u->task_act->state, LV_DRAW_TASK_STATE_READY);
+    LV_ATOMIC_STORE(&u->task_act, NULL);
 
     /*The draw unit is free now. Request a new dispatching as it can get a new task*/
     lv_draw_dispatch_request();
@@ -394,7 +394,7 @@ static int32_t dispatch(lv_draw_unit_t * draw_unit, lv_layer_t * layer)
     lv_draw_sw_unit_t * draw_sw_unit = (lv_draw_sw_unit_t *) draw_unit;
 
     /*Return immediately if it's busy with draw task*/
-    if(draw_sw_unit->task_act) {
+    if(LV_ATOMIC_LOAD(&draw_sw_unit->task_act)) {
         LV_PROFILER_END;
         return 0;
     }
@@ -415,11 +415,11 @@ static int32_t dispatch(lv_draw_unit_t * draw_unit, lv_layer_t * layer)
     t->state = LV_DRAW_TASK_STATE_IN_PROGRESS;
     draw_sw_unit->base_unit.target_layer = layer;
     draw_sw_unit->base_unit.clip_area = &t->clip_area;
-    draw_sw_unit->task_act = t;
+    LV_ATOMIC_STORE(&draw_sw_unit->task_act, t);
 
 #if LV_USE_OS
     /*Let the render thread work*/
-    if(draw_sw_unit->inited) lv_thread_sync_signal(&draw_sw_unit->sync);
+    if(LV_ATOMIC_LOAD(&draw_sw_unit->inited)) lv_thread_sync_signal(&draw_sw_unit->sync);
 #else
     execute_drawing_unit(draw_sw_unit);
 #endif
@@ -433,10 +433,10 @@ static void render_thread_cb(void * ptr)
     lv_draw_sw_unit_t * u = ptr;
 
     lv_thread_sync_init(&u->sync);
-    u->inited = true;
+    LV_ATOMIC_STORE(&u->inited, true);
 
     while(1) {
-        while(u->task_act == NULL) {
+        while(LV_ATOMIC_LOAD(&u->task_act) == NULL) {
             if(u->exit_status) {
                 break;
             }
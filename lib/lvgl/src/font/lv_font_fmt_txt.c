@@ -220,6 +220,8 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
 
+    if(letter < fdsc->glyph_id_table_len) return fdsc->glyph_id_table[letter];
+
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
 
@@ -183,6 +183,16 @@ typedef struct {
      * from `lv_font_fmt_txt_bitmap_format_t`
      */
     uint16_t bitmap_format  : 2;
+
+    /**
+     * Optional glyph IDs of the code points `0 .. glyph_id_table_len - 1` (0: not in the font).
+     * Letters in this range are found with one index instead of searching the cmaps.
+     * Must agree with `cmaps`. Can be NULL.
+     */
+    const uint16_t * glyph_id_table;
+
+    /** Number of code points in `glyph_id_table` */
+    uint16_t glyph_id_table_len;
 } lv_font_fmt_txt_dsc_t;
 
 /**********************
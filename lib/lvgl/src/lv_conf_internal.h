@@ -27,6 +27,7 @@
 #define LV_DRAW_SW_ASM_NONE         0
 #define LV_DRAW_SW_ASM_NEON         1
 #define LV_DRAW_SW_ASM_HELIUM       2
+#define LV_DRAW_SW_ASM_SWAR         3
 #define LV_DRAW_SW_ASM_CUSTOM       255
 
 /* Handle special Kconfig options */
@@ -227,6 +228,17 @@
     #endif
 #endif
 
+/*Cost of refreshing one more invalidated area, expressed in pixels (area setup, flush call, address window).
+ *Two invalidated areas are joined if their bounding box is smaller than their summed size plus this cost.
+ *0: join only overlapping areas*/
+#ifndef LV_INV_AREA_JOIN_COST
+    #ifdef CONFIG_LV_INV_AREA_JOIN_COST
+        #define LV_INV_AREA_JOIN_COST CONFIG_LV_INV_AREA_JOIN_COST
+    #else
+        #define LV_INV_AREA_JOIN_COST 0
+    #endif
+#endif
+
 /*Default Dot Per Inch. Used to initialize default sizes such as widgets sized, style paddings.
  *(Not so important, you can adjust it to modify default sizes and spaces)*/
 #ifndef LV_DPI_DEF
@@ -1026,6 +1038,18 @@
     #endif
 #endif
 
+/*Size of the glyph cache in bytes.
+ *Letters of fonts in the built-in format are kept unpacked as A8 bitmaps with their metrics,
+ *so drawing them again doesn't look up and decompress the glyph. 0 disables the cache.
+ *See `lv_glyph_cache_set_allocator()` to put the bitmaps in external RAM.*/
+#ifndef LV_GLYPH_CACHE_SIZE
+    #ifdef CONFIG_LV_GLYPH_CACHE_SIZE
+        #define LV_GLYPH_CACHE_SIZE CONFIG_LV_GLYPH_CACHE_SIZE
+    #else
+        #define LV_GLYPH_CACHE_SIZE 0
+    #endif
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #ifndef LV_GRADIENT_MAX_STOPS
@@ -1932,6 +1956,13 @@
             #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
         #endif
     #endif
+    #ifndef LV_LABEL_LINE_CACHE
+        #ifdef CONFIG_LV_LABEL_LINE_CACHE
+            #define LV_LABEL_LINE_CACHE CONFIG_LV_LABEL_LINE_CACHE
+        #else
+            #define LV_LABEL_LINE_CACHE 0  /*Keep the line breaks of labels to re-measure only the edited lines and draw without breaking the text again*/
+        #endif
+    #endif
     #ifndef LV_LABEL_WAIT_CHAR_COUNT
         #ifdef CONFIG_LV_LABEL_WAIT_CHAR_COUNT
             #define LV_LABEL_WAIT_CHAR_COUNT CONFIG_LV_LABEL_WAIT_CHAR_COUNT
@@ -224,6 +224,7 @@ void lv_init(void)
 #endif
 
     lv_image_decoder_init(LV_CACHE_DEF_SIZE, LV_IMAGE_HEADER_CACHE_DEF_CNT);
+    lv_glyph_cache_init(LV_GLYPH_CACHE_SIZE);
     lv_bin_decoder_init();  /*LVGL built-in binary image decoder*/
 
 #if LV_USE_DRAW_VG_LITE
@@ -379,6 +380,8 @@ void lv_deinit(void)
     lv_theme_mono_deinit();
 #endif
 
+    lv_glyph_cache_deinit();
+
     lv_image_decoder_deinit();
 
     lv_refr_deinit();
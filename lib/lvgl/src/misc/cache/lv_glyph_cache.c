@@ -0,0 +1,245 @@
+/**
+* @file lv_glyph_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lv_glyph_cache.h"
+#include "lv_cache.h"
+#include "../lv_assert.h"
+#include "../lv_log.h"
+#include "../../core/lv_global.h"
+#include "../../draw/lv_draw_buf_private.h"
+#include "../../font/lv_font_fmt_txt.h"
+#include "../../stdlib/lv_mem.h"
+#include "../lv_math.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define CACHE_NAME  "GLYPH"
+
+#define glyph_cache_p (LV_GLOBAL_DEFAULT()->glyph_cache)
+#define glyph_cache_hits (LV_GLOBAL_DEFAULT()->glyph_cache_hits)
+#define glyph_cache_misses (LV_GLOBAL_DEFAULT()->glyph_cache_misses)
+#define glyph_cache_evictions (LV_GLOBAL_DEFAULT()->glyph_cache_evictions)
+#define glyph_cache_malloc (LV_GLOBAL_DEFAULT()->glyph_cache_malloc)
+#define glyph_cache_free (LV_GLOBAL_DEFAULT()->glyph_cache_free)
+
+/*Offset of the pixels after the draw buffer header in a bitmap block*/
+#define BITMAP_OFS  LV_ALIGN_UP(sizeof(lv_draw_buf_t), LV_DRAW_BUF_ALIGN)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static lv_cache_compare_res_t glyph_cache_compare_cb(const lv_glyph_cache_data_t * lhs,
+                                                     const lv_glyph_cache_data_t * rhs);
+static bool glyph_cache_create_cb(lv_glyph_cache_data_t * entry, void * user_data);
+static void glyph_cache_free_cb(lv_glyph_cache_data_t * entry, void * user_data);
+static void * default_malloc(size_t size);
+static bool has_bitmap(const lv_font_glyph_dsc_t * g);
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_result_t lv_glyph_cache_init(uint32_t size)
+{
+    if(glyph_cache_p != NULL) {
+        return LV_RESULT_OK;
+    }
+
+    if(glyph_cache_malloc == NULL) {
+        glyph_cache_malloc = default_malloc;
+        glyph_cache_free = lv_free;
+    }
+
+    glyph_cache_p = lv_cache_create(&lv_cache_class_lru_rb_size,
+    sizeof(lv_glyph_cache_data_t), size, (lv_cache_ops_t) {
+        .compare_cb = (lv_cache_compare_cb_t) glyph_cache_compare_cb,
+        .create_cb = (lv_cache_create_cb_t) glyph_cache_create_cb,
+        .free_cb = (lv_cache_free_cb_t) glyph_cache_free_cb,
+    });
+
+    lv_cache_set_name(glyph_cache_p, CACHE_NAME);
+    return glyph_cache_p != NULL ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+void lv_glyph_cache_deinit(void)
+{
+    if(glyph_cache_p == NULL) return;
+
+    lv_cache_destroy(glyph_cache_p, NULL);
+    glyph_cache_p = NULL;
+}
+
+void lv_glyph_cache_resize(uint32_t new_size, bool evict_now)
+{
+    lv_cache_set_max_size(glyph_cache_p, new_size, NULL);
+    if(evict_now) {
+        lv_cache_reserve(glyph_cache_p, new_size, NULL);
+    }
+}
+
+void lv_glyph_cache_set_allocator(lv_glyph_cache_malloc_cb_t malloc_cb, lv_glyph_cache_free_cb_t free_cb)
+{
+    LV_ASSERT_NULL(malloc_cb);
+    LV_ASSERT_NULL(free_cb);
+
+    /*The dropped glyphs are freed with the old allocator*/
+    if(glyph_cache_p) lv_cache_drop_all(glyph_cache_p, NULL);
+
+    glyph_cache_malloc = malloc_cb;
+    glyph_cache_free = free_cb;
+}
+
+void lv_glyph_cache_drop(const lv_font_t * font)
+{
+    if(glyph_cache_p == NULL) return;
+
+    /*The cache can't be searched by font, so drop all glyphs if the font may have some*/
+    if(font == NULL || font->get_glyph_bitmap == lv_font_get_bitmap_fmt_txt) {
+        lv_cache_drop_all(glyph_cache_p, NULL);
+    }
+}
+
+bool lv_glyph_cache_is_enabled(void)
+{
+    return glyph_cache_p != NULL && lv_cache_is_enabled(glyph_cache_p);
+}
+
+void lv_glyph_cache_get_stats(lv_glyph_cache_stats_t * stats)
+{
+    LV_ASSERT_NULL(stats);
+
+    stats->hits = LV_ATOMIC_LOAD(&glyph_cache_hits);
+    stats->misses = LV_ATOMIC_LOAD(&glyph_cache_misses);
+    stats->evictions = LV_ATOMIC_LOAD(&glyph_cache_evictions);
+    stats->size = glyph_cache_p ? lv_cache_get_size(glyph_cache_p, NULL) : 0;
+    stats->max_size = glyph_cache_p ? lv_cache_get_max_size(glyph_cache_p, NULL) : 0;
+}
+
+lv_cache_entry_t * lv_glyph_cache_acquire(const lv_font_t * font, uint32_t letter)
+{
+    if(!lv_glyph_cache_is_enabled()) return NULL;
+
+    /*Only the built-in format unpacks into A8 bitmaps that stay valid*/
+    if(font->get_glyph_bitmap != lv_font_get_bitmap_fmt_txt) return NULL;
+
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    lv_glyph_cache_data_t search_key = {
+        .font = font,
+        .letter = letter,
+        .bpp = fdsc->bpp,
+    };
+
+    lv_cache_entry_t * entry = lv_cache_acquire(glyph_cache_p, &search_key, NULL);
+    if(entry) {
+        LV_ATOMIC_ADD(&glyph_cache_hits, 1);
+        return entry;
+    }
+
+    /*The size of a new entry is charged when it's added, so look up the metrics first*/
+    lv_font_glyph_dsc_t * g = &search_key.g;
+    if(!lv_font_get_glyph_dsc(font, g, letter, '\0')) {
+        LV_LOG_WARN("glyph dsc. not found for U+%" LV_PRIX32, letter);
+    }
+
+    search_key.slot.size = sizeof(lv_glyph_cache_data_t);
+    if(has_bitmap(g)) {
+        /*A fallback font in an other format keeps drawing uncached*/
+        if(g->resolved_font->get_glyph_bitmap != lv_font_get_bitmap_fmt_txt) return NULL;
+        search_key.slot.size += BITMAP_OFS + lv_draw_buf_width_to_stride(g->box_w, LV_COLOR_FORMAT_A8) * g->box_h;
+    }
+
+    /*Another draw unit may have added it meanwhile, then that one is returned*/
+    return lv_cache_acquire_or_create(glyph_cache_p, &search_key, NULL);
+}
+
+void lv_glyph_cache_release(lv_cache_entry_t * entry)
+{
+    lv_cache_release(glyph_cache_p, entry, NULL);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_cache_compare_res_t glyph_cache_compare_cb(const lv_glyph_cache_data_t * lhs,
+                                                     const lv_glyph_cache_data_t * rhs)
+{
+    if(lhs->font != rhs->font) {
+        return lhs->font > rhs->font ? 1 : -1;
+    }
+    if(lhs->letter != rhs->letter) {
+        return lhs->letter > rhs->letter ? 1 : -1;
+    }
+    if(lhs->bpp != rhs->bpp) {
+        return lhs->bpp > rhs->bpp ? 1 : -1;
+    }
+    return 0;
+}
+
+static bool glyph_cache_create_cb(lv_glyph_cache_data_t * entry, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    /*The metrics and the size are set in the key already*/
+    lv_font_glyph_dsc_t * g = &entry->g;
+    entry->draw_buf = NULL;
+
+    if(has_bitmap(g)) {
+        uint32_t stride = lv_draw_buf_width_to_stride(g->box_w, LV_COLOR_FORMAT_A8);
+        uint32_t data_size = stride * g->box_h;
+        uint8_t * block = glyph_cache_malloc(BITMAP_OFS + data_size);
+        if(block == NULL) return false;
+
+        lv_draw_buf_t * draw_buf = (lv_draw_buf_t *)block;
+        lv_draw_buf_init(draw_buf, g->box_w, g->box_h, LV_COLOR_FORMAT_A8, stride, block + BITMAP_OFS, data_size);
+        if(lv_font_get_glyph_bitmap(g, draw_buf) != NULL) entry->draw_buf = draw_buf;
+        else glyph_cache_free(block);
+    }
+
+    LV_ATOMIC_ADD(&glyph_cache_misses, 1);
+    return true;
+}
+
+static void glyph_cache_free_cb(lv_glyph_cache_data_t * entry, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    if(entry->draw_buf) glyph_cache_free(entry->draw_buf);
+    LV_ATOMIC_ADD(&glyph_cache_evictions, 1);
+}
+
+static void * default_malloc(size_t size)
+{
+    return lv_malloc(size);
+}
+
+static bool has_bitmap(const lv_font_glyph_dsc_t * g)
+{
+    return g->resolved_font && g->box_w && g->box_h &&
+           LV_FONT_GLYPH_FORMAT_NONE < g->format && g->format < LV_FONT_GLYPH_FORMAT_IMAGE;
+}
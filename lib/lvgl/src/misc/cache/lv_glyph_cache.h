@@ -0,0 +1,130 @@
+/**
+* @file lv_glyph_cache.h
+ *
+ */
+
+#ifndef LV_GLYPH_CACHE_H
+#define LV_GLYPH_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "../../lv_conf_internal.h"
+#include "../lv_types.h"
+#include "../../font/lv_font.h"
+#include "lv_cache_private.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    lv_cache_slot_size_t slot;  /**< Bytes charged to the cache: the bitmap and the entry */
+
+    const lv_font_t * font;     /**< Font asked for the letter */
+    uint32_t letter;            /**< Unicode code point */
+    uint8_t bpp;                /**< Bits per pixel of the font's bitmaps */
+
+    lv_font_glyph_dsc_t g;      /**< Metrics, `resolved_font` may be a fallback of `font` */
+    lv_draw_buf_t * draw_buf;   /**< A8 bitmap ready to blend, NULL if the glyph is empty */
+} lv_glyph_cache_data_t;
+
+typedef struct {
+    uint32_t hits;              /**< Glyphs drawn from the cache */
+    uint32_t misses;            /**< Glyphs looked up and unpacked into the cache */
+    uint32_t evictions;         /**< Glyphs removed to make room or dropped */
+    uint32_t size;              /**< Bytes in use */
+    uint32_t max_size;          /**< Byte budget */
+} lv_glyph_cache_stats_t;
+
+typedef void * (*lv_glyph_cache_malloc_cb_t)(size_t size);
+typedef void (*lv_glyph_cache_free_cb_t)(void * p);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the glyph cache. Only fonts in LVGL's built-in format are cached.
+ * @param  size     budget of the cache in bytes, 0 to disable it.
+ * @return LV_RESULT_OK: initialization succeeded, LV_RESULT_INVALID: failed.
+ */
+lv_result_t lv_glyph_cache_init(uint32_t size);
+
+/**
+ * Delete the glyph cache and all cached glyphs.
+ */
+void lv_glyph_cache_deinit(void);
+
+/**
+ * Resize the glyph cache.
+ * If set to 0, the cache will be disabled.
+ * @param new_size  new budget of the cache in bytes.
+ * @param evict_now true: evict the glyphs over the new budget now, false: when new glyphs are added.
+ */
+void lv_glyph_cache_resize(uint32_t new_size, bool evict_now);
+
+/**
+ * Allocate the cached bitmaps with other functions than `lv_malloc`/`lv_free`, e.g. from external RAM.
+ * The glyphs cached so far are dropped.
+ * @param malloc_cb allocate a block, return NULL on failure
+ * @param free_cb   free a block of `malloc_cb`
+ */
+void lv_glyph_cache_set_allocator(lv_glyph_cache_malloc_cb_t malloc_cb, lv_glyph_cache_free_cb_t free_cb);
+
+/**
+ * Drop the cached glyphs of a font, e.g. before deleting it. Use NULL to drop all glyphs.
+ * @param font      pointer to a font
+ */
+void lv_glyph_cache_drop(const lv_font_t * font);
+
+/**
+ * Return true if the glyph cache is enabled.
+ * @return true: enabled, false: disabled.
+ */
+bool lv_glyph_cache_is_enabled(void);
+
+/**
+ * Get the hit and miss counters and the memory use of the glyph cache.
+ * @param stats     store the statistics here
+ */
+void lv_glyph_cache_get_stats(lv_glyph_cache_stats_t * stats);
+
+/**
+ * Get the metrics and the A8 bitmap of a letter, unpacking it into the cache if needed.
+ * Can be called from the draw threads.
+ * @param font      the font of the text
+ * @param letter    Unicode code point
+ * @return          the entry holding an `lv_glyph_cache_data_t`, or NULL if the font can't be cached
+ *                  or the cache is disabled. Release it with `lv_glyph_cache_release()`.
+ */
+lv_cache_entry_t * lv_glyph_cache_acquire(const lv_font_t * font, uint32_t letter);
+
+/**
+ * Release an entry of `lv_glyph_cache_acquire()`.
+ * @param entry     the entry to release
+ */
+void lv_glyph_cache_release(lv_cache_entry_t * entry);
+
+/*************************
+ *    GLOBAL VARIABLES
+ *************************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_GLYPH_CACHE_H*/
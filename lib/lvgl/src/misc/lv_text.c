@@ -19,6 +19,7 @@
  *      DEFINES
  *********************/
 #define NO_BREAK_FOUND UINT32_MAX
+#define LINES_DEF_CAPACITY 8
 
 /**********************
  *      TYPEDEFS
@@ -27,6 +28,11 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static bool lines_has_key(const lv_text_lines_t * lines, const lv_font_t * font, int32_t letter_space,
+                          int32_t max_width, lv_text_flag_t flag);
+static uint32_t lines_lower_bound(const lv_text_lines_t * lines, uint32_t byte_id);
+static bool lines_push(lv_text_line_t ** buf, uint32_t * cnt, uint32_t * capacity, uint32_t start, int32_t width);
+
 
 #if LV_TXT_ENC == LV_TXT_ENC_UTF8
     static uint8_t lv_text_utf8_size(const char * str);
@@ -369,6 +375,205 @@ int32_t lv_text_get_width(const char * txt, uint32_t length, const lv_font_t * f
     return width;
 }
 
+void lv_text_lines_init(lv_text_lines_t * lines)
+{
+    lv_memzero(lines, sizeof(lv_text_lines_t));
+}
+
+void lv_text_lines_deinit(lv_text_lines_t * lines)
+{
+    lv_free(lines->lines);
+    lv_memzero(lines, sizeof(lv_text_lines_t));
+}
+
+void lv_text_lines_invalidate(lv_text_lines_t * lines)
+{
+    lines->valid = 0;
+    lines->edited = 0;
+}
+
+void lv_text_lines_edit(lv_text_lines_t * lines, uint32_t byte_pos, uint32_t removed, uint32_t inserted)
+{
+    if(!lines->valid) return;
+
+    uint32_t end = byte_pos + removed;
+    if(!lines->edited) {
+        lines->edit_start = byte_pos;
+        lines->edit_end = end;
+        lines->edit_delta = 0;
+        lines->edited = 1;
+    }
+    else {
+        /*Merge with the earlier edits. The bytes after them are already moved by `edit_delta`*/
+        if(byte_pos < lines->edit_start) lines->edit_start = byte_pos;
+        if(end > lines->edit_end + lines->edit_delta) lines->edit_end = end - lines->edit_delta;
+    }
+
+    lines->edit_delta += (int32_t)inserted - (int32_t)removed;
+}
+
+void lv_text_lines_update(lv_text_lines_t * lines, const char * txt, const lv_font_t * font, int32_t letter_space,
+                          int32_t max_width, lv_text_flag_t flag)
+{
+    LV_ASSERT_NULL(txt);
+    LV_ASSERT_NULL(font);
+
+    if(flag & (LV_TEXT_FLAG_EXPAND | LV_TEXT_FLAG_FIT)) max_width = LV_COORD_MAX;
+
+    uint32_t keep = 0;          /*Lines before the edits, they stay as they are*/
+    uint32_t old_i = 0;         /*The next old line after the edits, it might be reused*/
+    uint32_t old_cnt = 0;
+    uint32_t edit_end = 0;      /*End of the edits in the new text*/
+    int32_t delta = 0;
+
+    if(lines->valid && lines_has_key(lines, font, letter_space, max_width, flag)) {
+        if(!lines->edited) return;
+
+        old_cnt = lines->line_cnt;
+#if LV_TXT_LINE_BREAK_LONG_LEN == 0
+        /*A line depends on the text until the start of the line after the next one, as the first word
+         *there might fit into it. So the 3 lines before the edit are broken again too.*/
+        keep = lines_lower_bound(lines, lines->edit_start);
+        keep = keep > 3 ? keep - 3 : 0;
+#endif
+        old_i = lines_lower_bound(lines, lines->edit_end);
+        delta = lines->edit_delta;
+        edit_end = lines->edit_end + delta;
+    }
+    else {
+        lines->font = font;
+        lines->letter_space = letter_space;
+        lines->max_width = max_width;
+        lines->flag = flag;
+    }
+
+    lines->valid = 0;
+    lines->edited = 0;
+
+    /*Break the lines from the last kept one until a line starts where an old one did after the edits.
+     *The text is the same from there, so the rest of the old lines are reused.*/
+    lv_text_line_t * new_lines = NULL;
+    uint32_t new_cnt = 0;
+    uint32_t new_capacity = 0;
+    uint32_t line_start = keep < old_cnt ? lines->lines[keep].start : 0;
+    bool reuse = false;
+    while(1) {
+        if(line_start >= edit_end) {
+            while(old_i < old_cnt && lines->lines[old_i].start + delta < line_start) old_i++;
+            if(old_i < old_cnt && lines->lines[old_i].start + delta == line_start) {
+                reuse = true;
+                break;
+            }
+        }
+
+        if(txt[line_start] == '\0') break;
+
+        uint32_t line_end = line_start + lv_text_get_next_line(&txt[line_start], font, letter_space, max_width, NULL,
+                                                               flag);
+        int32_t line_w = lv_text_get_width(&txt[line_start], line_end - line_start, font, letter_space);
+        if(!lines_push(&new_lines, &new_cnt, &new_capacity, line_start, line_w)) {
+            lv_free(new_lines);
+            return;
+        }
+        line_start = line_end;
+    }
+
+    if(!reuse) {
+        /*Close the lines with the terminating '\0'*/
+        if(!lines_push(&new_lines, &new_cnt, &new_capacity, line_start, 0)) {
+            lv_free(new_lines);
+            return;
+        }
+        old_i = old_cnt;
+    }
+
+    uint32_t tail_cnt = old_cnt - old_i;
+    if(keep == 0 && tail_cnt == 0) {
+        lv_free(lines->lines);
+        lines->lines = new_lines;
+        lines->line_cnt = new_cnt;
+        lines->line_capacity = new_capacity;
+    }
+    else {
+        uint32_t cnt = keep + new_cnt + tail_cnt;
+        if(cnt > lines->line_capacity) {
+            uint32_t capacity = cnt + cnt / 2;
+            lv_text_line_t * buf = lv_realloc(lines->lines, capacity * sizeof(lv_text_line_t));
+            LV_ASSERT_MALLOC(buf);
+            if(buf == NULL) {
+                lv_free(new_lines);
+                return;
+            }
+            lines->lines = buf;
+            lines->line_capacity = capacity;
+        }
+
+        lv_memmove(&lines->lines[keep + new_cnt], &lines->lines[old_i], tail_cnt * sizeof(lv_text_line_t));
+        lv_memcpy(&lines->lines[keep], new_lines, new_cnt * sizeof(lv_text_line_t));
+        lv_free(new_lines);
+
+        uint32_t i;
+        for(i = keep + new_cnt; i < cnt; i++) {
+            lines->lines[i].start += delta;
+        }
+        lines->line_cnt = cnt;
+    }
+
+    uint32_t i;
+    lines->width = 0;
+    for(i = 0; i + 1 < lines->line_cnt; i++) {
+        lines->width = LV_MAX(lines->width, lines->lines[i].width);
+    }
+
+    lines->valid = 1;
+}
+
+bool lv_text_lines_matches(const lv_text_lines_t * lines, const lv_font_t * font, int32_t letter_space,
+                           int32_t max_width, lv_text_flag_t flag)
+{
+    if(!lines->valid || lines->edited) return false;
+
+    if(flag & (LV_TEXT_FLAG_EXPAND | LV_TEXT_FLAG_FIT)) max_width = LV_COORD_MAX;
+    return lines_has_key(lines, font, letter_space, max_width, flag);
+}
+
+void lv_text_lines_get_size(const lv_text_lines_t * lines, const char * txt, int32_t line_space,
+                            lv_point_t * size_res)
+{
+    uint32_t line_cnt = lv_text_lines_get_count(lines);
+    int32_t letter_height = lv_font_get_line_height(lines->font);
+
+    size_res->x = lines->width;
+    size_res->y = line_cnt * (letter_height + line_space);
+
+    /*Make the text one line taller if the last character is '\n' or '\r'*/
+    uint32_t len = lv_text_lines_get_start(lines, line_cnt);
+    if(len != 0 && (txt[len - 1] == '\n' || txt[len - 1] == '\r')) {
+        size_res->y += letter_height + line_space;
+    }
+
+    /*Correction with the last line space or set the height manually if the text is empty*/
+    if(size_res->y == 0)
+        size_res->y = letter_height;
+    else
+        size_res->y -= line_space;
+}
+
+uint32_t lv_text_lines_get_count(const lv_text_lines_t * lines)
+{
+    return lines->line_cnt ? lines->line_cnt - 1 : 0;
+}
+
+uint32_t lv_text_lines_find(const lv_text_lines_t * lines, uint32_t byte_id)
+{
+    uint32_t line_cnt = lv_text_lines_get_count(lines);
+    if(line_cnt == 0) return 0;
+
+    uint32_t id = lines_lower_bound(lines, byte_id + 1);
+    if(id > 0) id--;
+    return LV_MIN(id, line_cnt - 1);
+}
+
 void lv_text_ins(char * txt_buf, uint32_t pos, const char * ins_txt)
 {
     if(txt_buf == NULL || ins_txt == NULL) return;
@@ -454,6 +659,50 @@ void lv_text_encoded_letter_next_2(const char * txt, uint32_t * letter, uint32_t
     *letter_next = *letter != '\0' ? lv_text_encoded_next(&txt[*ofs], NULL) : 0;
 }
 
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static bool lines_has_key(const lv_text_lines_t * lines, const lv_font_t * font, int32_t letter_space,
+                          int32_t max_width, lv_text_flag_t flag)
+{
+    return lines->font == font && lines->letter_space == letter_space &&
+           lines->max_width == max_width && lines->flag == flag;
+}
+
+/**
+ * Get the number of lines starting before a byte
+ */
+static uint32_t lines_lower_bound(const lv_text_lines_t * lines, uint32_t byte_id)
+{
+    uint32_t min = 0;
+    uint32_t max = lines->line_cnt;
+    while(min < max) {
+        uint32_t mid = min + (max - min) / 2;
+        if(lines->lines[mid].start < byte_id) min = mid + 1;
+        else max = mid;
+    }
+
+    return min;
+}
+
+static bool lines_push(lv_text_line_t ** buf, uint32_t * cnt, uint32_t * capacity, uint32_t start, int32_t width)
+{
+    if(*cnt == *capacity) {
+        uint32_t new_capacity = *capacity ? *capacity * 2 : LINES_DEF_CAPACITY;
+        lv_text_line_t * new_buf = lv_realloc(*buf, new_capacity * sizeof(lv_text_line_t));
+        LV_ASSERT_MALLOC(new_buf);
+        if(new_buf == NULL) return false;
+        *buf = new_buf;
+        *capacity = new_capacity;
+    }
+
+    (*buf)[*cnt].start = start;
+    (*buf)[*cnt].width = width;
+    (*cnt)++;
+    return true;
+}
+
 #if LV_TXT_ENC == LV_TXT_ENC_UTF8
 /*******************************
  *   UTF-8 ENCODER/DECODER
@@ -24,6 +24,31 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+typedef struct {
+    uint32_t start;             /**< Byte index of the first letter of the line */
+    int32_t width;              /**< Width of the line, as `lv_text_get_width()` measures it */
+} lv_text_line_t;
+
+/**
+ * Line breaks of a text, kept to re-measure only the lines around an edit.
+ * The key is the font, the letter space, the max. width and the flags the lines were broken with.
+ */
+struct lv_text_lines_t {
+    lv_text_line_t * lines;     /**< The lines and one more at the terminating '\0' */
+    uint32_t line_cnt;          /**< Number of items in `lines`, 0 if there are none yet */
+    uint32_t line_capacity;     /**< Number of items `lines` has room for */
+    const lv_font_t * font;
+    int32_t letter_space;
+    int32_t max_width;          /**< LV_COORD_MAX if the flags make the lines break only at new lines */
+    lv_text_flag_t flag;
+    int32_t width;              /**< Width of the longest line */
+    uint32_t edit_start;        /**< First byte changed since the last update */
+    uint32_t edit_end;          /**< End of the changed bytes in the text of the last update */
+    int32_t edit_delta;         /**< Bytes added since the last update */
+    uint8_t valid : 1;          /**< 1: the lines belong to the text of the last update */
+    uint8_t edited : 1;         /**< 1: the text was edited since the last update */
+};
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -44,6 +69,105 @@ extern "C" {
 uint32_t lv_text_get_next_line(const char * txt, const lv_font_t * font, int32_t letter_space,
                                int32_t max_width, int32_t * used_width, lv_text_flag_t flag);
 
+/**
+ * Initialize an empty line cache.
+ * @param lines     pointer to a line cache
+ */
+void lv_text_lines_init(lv_text_lines_t * lines);
+
+/**
+ * Free the memory of a line cache.
+ * @param lines     pointer to a line cache
+ */
+void lv_text_lines_deinit(lv_text_lines_t * lines);
+
+/**
+ * Mark the lines as invalid, e.g. when the whole text is replaced. The next update breaks all lines.
+ * @param lines     pointer to a line cache
+ */
+void lv_text_lines_invalidate(lv_text_lines_t * lines);
+
+/**
+ * Record an edit of the text. The next update re-measures only the lines around the edits.
+ * @param lines     pointer to a line cache
+ * @param byte_pos  byte index of the edit
+ * @param removed   number of bytes removed at `byte_pos`
+ * @param inserted  number of bytes inserted at `byte_pos`
+ */
+void lv_text_lines_edit(lv_text_lines_t * lines, uint32_t byte_pos, uint32_t removed, uint32_t inserted);
+
+/**
+ * Bring the lines up to date with a text. If the key changed all lines are broken again,
+ * else only the lines around the recorded edits are.
+ * @param lines         pointer to a line cache
+ * @param txt           the '\0' terminated text
+ * @param font          pointer to the font of the text
+ * @param letter_space  letter space of the text
+ * @param max_width     max width of the lines, as for `lv_text_get_size()`
+ * @param flag          settings for the text from ::lv_text_flag_t
+ */
+void lv_text_lines_update(lv_text_lines_t * lines, const char * txt, const lv_font_t * font, int32_t letter_space,
+                          int32_t max_width, lv_text_flag_t flag);
+
+/**
+ * Check if the lines are up to date and were broken with the given settings.
+ * @param lines         pointer to a line cache
+ * @param font          pointer to the font of the text
+ * @param letter_space  letter space of the text
+ * @param max_width     max width of the lines
+ * @param flag          settings for the text from ::lv_text_flag_t
+ * @return              true: the lines can be used instead of breaking the text
+ */
+bool lv_text_lines_matches(const lv_text_lines_t * lines, const lv_font_t * font, int32_t letter_space,
+                           int32_t max_width, lv_text_flag_t flag);
+
+/**
+ * Get the size of the text from its lines, the same as `lv_text_get_size()` would.
+ * @param lines         pointer to an up to date line cache
+ * @param txt           the text of the lines
+ * @param line_space    line space of the text
+ * @param size_res      store the result here
+ */
+void lv_text_lines_get_size(const lv_text_lines_t * lines, const char * txt, int32_t line_space,
+                            lv_point_t * size_res);
+
+/**
+ * Get the number of lines.
+ * @param lines     pointer to an up to date line cache
+ * @return          the number of lines, 0 for an empty text
+ */
+uint32_t lv_text_lines_get_count(const lv_text_lines_t * lines);
+
+/**
+ * Get the line containing a byte of the text.
+ * @param lines     pointer to an up to date line cache
+ * @param byte_id   byte index in the text
+ * @return          index of the line, the last line for the terminating '\0'
+ */
+uint32_t lv_text_lines_find(const lv_text_lines_t * lines, uint32_t byte_id);
+
+/**
+ * Get the byte index of the start of a line.
+ * @param lines     pointer to an up to date line cache
+ * @param id        index of the line, the number of lines to get the length of the text
+ * @return          byte index of the first letter of the line
+ */
+static inline uint32_t lv_text_lines_get_start(const lv_text_lines_t * lines, uint32_t id)
+{
+    return lines->lines[id].start;
+}
+
+/**
+ * Get the width of a line.
+ * @param lines     pointer to an up to date line cache
+ * @param id        index of the line
+ * @return          width of the line in pixels
+ */
+static inline int32_t lv_text_lines_get_width(const lv_text_lines_t * lines, uint32_t id)
+{
+    return lines->lines[id].width;
+}
+
 /**
  * Insert a string into another
  * @param txt_buf the original text (must be big enough for the result text and NULL terminated)
@@ -153,6 +153,8 @@ typedef struct lv_grad_t lv_grad_t;
 
 typedef struct lv_draw_label_hint_t lv_draw_label_hint_t;
 
+typedef struct lv_text_lines_t lv_text_lines_t;
+
 typedef struct lv_draw_glyph_dsc_t lv_draw_glyph_dsc_t;
 
 typedef struct lv_draw_image_sup_t lv_draw_image_sup_t;
@@ -32,6 +32,15 @@
     #define pcTASK_NAME "lvglDraw"
 #endif
 
+/*
+ * 1: on ESP32 chips with more than one core, pin the created threads to the
+ * cores in turn, starting with core 0. With `LV_DRAW_SW_DRAW_UNIT_CNT` equal to
+ * the number of cores every core gets one software draw unit.
+ */
+#ifndef LV_FREERTOS_PIN_THREADS
+    #define LV_FREERTOS_PIN_THREADS 0
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -63,6 +72,10 @@ static void prvTestAndDecrement(lv_thread_sync_t * pxCond,
     static portMUX_TYPE critSectionMux = portMUX_INITIALIZER_UNLOCKED;
 #endif
 
+#if (ESP_PLATFORM) && LV_FREERTOS_PIN_THREADS
+    static BaseType_t xNextCore = 0;
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -86,6 +99,19 @@ lv_result_t lv_thread_init(lv_thread_t * pxThread, lv_thread_prio_t xSchedPriori
     pxThread->xTaskArg = xAttr;
     pxThread->pvStartRoutine = pvStartRoutine;
 
+#if (ESP_PLATFORM) && LV_FREERTOS_PIN_THREADS
+    BaseType_t xCore = xNextCore;
+    xNextCore = (xNextCore + 1) % portNUM_PROCESSORS;
+
+    BaseType_t xTaskCreateStatus = xTaskCreatePinnedToCore(
+                                       prvRunThread,
+                                       pcTASK_NAME,
+                                       (configSTACK_DEPTH_TYPE)(usStackSize / sizeof(StackType_t)),
+                                       (void *)pxThread,
+                                       tskIDLE_PRIORITY + xSchedPriority,
+                                       &pxThread->xTaskHandle,
+                                       xCore);
+#else
     BaseType_t xTaskCreateStatus = xTaskCreate(
                                        prvRunThread,
                                        pcTASK_NAME,
@@ -93,6 +119,7 @@ lv_result_t lv_thread_init(lv_thread_t * pxThread, lv_thread_prio_t xSchedPriori
                                        (void *)pxThread,
                                        tskIDLE_PRIORITY + xSchedPriority,
                                        &pxThread->xTaskHandle);
+#endif
 
     /* Ensure that the FreeRTOS task was successfully created. */
     if(xTaskCreateStatus != pdPASS) {
@@ -123,9 +150,10 @@ lv_result_t lv_mutex_lock(lv_mutex_t * pxMutex)
     /* If mutex in uninitialized, perform initialization. */
     prvCheckMutexInit(pxMutex);
 
-    BaseType_t xMutexTakeStatus = xSemaphoreTake(pxMutex->xMutex, portMAX_DELAY);
+    /* The mutex is recursive, e.g. `lv_timer_handler()` takes `lv_lock()` again. */
+    BaseType_t xMutexTakeStatus = xSemaphoreTakeRecursive(pxMutex->xMutex, portMAX_DELAY);
     if(xMutexTakeStatus != pdTRUE) {
-        LV_LOG_ERROR("xSemaphoreTake failed!");
+        LV_LOG_ERROR("xSemaphoreTakeRecursive failed!");
         return LV_RESULT_INVALID;
     }
 
@@ -159,9 +187,9 @@ lv_result_t lv_mutex_unlock(lv_mutex_t * pxMutex)
     /* If mutex in uninitialized, perform initialization. */
     prvCheckMutexInit(pxMutex);
 
-    BaseType_t xMutexGiveStatus = xSemaphoreGive(pxMutex->xMutex);
+    BaseType_t xMutexGiveStatus = xSemaphoreGiveRecursive(pxMutex->xMutex);
     if(xMutexGiveStatus != pdTRUE) {
-        LV_LOG_ERROR("xSemaphoreGive failed!");
+        LV_LOG_ERROR("xSemaphoreGiveRecursive failed!");
         return LV_RESULT_INVALID;
     }
 
@@ -42,8 +42,13 @@ extern "C" {
  * than unblocking a task using an intermediary object such as a binary semaphore.
  *
  * RTOS task notifications can only be used when there is only one task that can be the recipient of the event.
+ *
+ * Set it to 0 if the task calling `lv_timer_handler()` also waits for its own task
+ * notifications, otherwise the two consume each other's signals.
  */
+#ifndef USE_FREERTOS_TASK_NOTIFY
 #define USE_FREERTOS_TASK_NOTIFY 1
+#endif
 
 /**********************
  *      TYPEDEFS
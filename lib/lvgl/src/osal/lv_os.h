@@ -179,6 +179,21 @@ void lv_unlock(void);
  *      MACROS
  **********************/
 
+/**
+ * Load and store a flag or pointer handed between the `lv_timer_handler()` thread and the
+ * draw threads. The accesses are sequentially consistent, so all writes made before a store
+ * are visible to the thread which loads the stored value.
+ */
+#if LV_USE_OS != LV_OS_NONE && defined(__GNUC__)
+#define LV_ATOMIC_LOAD(p)       __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define LV_ATOMIC_STORE(p, v)   __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define LV_ATOMIC_ADD(p, v)     __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)  /*For counters, no ordering*/
+#else
+#define LV_ATOMIC_LOAD(p)       (*(p))
+#define LV_ATOMIC_STORE(p, v)   (*(p) = (v))
+#define LV_ATOMIC_ADD(p, v)     (*(p) += (v))
+#endif
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
@@ -58,6 +58,12 @@ static void set_ofs_y_anim(void * obj, int32_t v);
 static size_t get_text_length(const char * text);
 static void copy_text_to_label(lv_label_t * label, const char * text);
 static lv_text_flag_t get_label_flags(lv_label_t * label);
+static void get_text_size(lv_label_t * label, lv_point_t * size_res, const lv_font_t * font, int32_t letter_space,
+                          int32_t line_space, int32_t max_width, lv_text_flag_t flag);
+#if LV_LABEL_LINE_CACHE
+static bool get_cached_line_at_y(lv_label_t * label, const lv_font_t * font, int32_t letter_space, int32_t line_space,
+                                 int32_t max_width, int32_t y, uint32_t * line_start, uint32_t * line_end);
+#endif
 static void calculate_x_coordinate(int32_t * x, const lv_text_align_t align, const char * txt,
                                    uint32_t length, const lv_font_t * font, int32_t letter_space, lv_area_t * txt_coords);
 
@@ -139,6 +145,10 @@ void lv_label_set_text(lv_obj_t * obj, const char * text)
 
     lv_obj_invalidate(obj);
 
+#if LV_LABEL_LINE_CACHE
+    lv_text_lines_invalidate(&label->lines);
+#endif
+
     /*If text is NULL then just refresh with the current text*/
     if(text == NULL) text = label->text;
 
@@ -183,6 +193,10 @@ void lv_label_set_text_fmt(lv_obj_t * obj, const char * fmt, ...)
     lv_obj_invalidate(obj);
     lv_label_t * label = (lv_label_t *)obj;
 
+#if LV_LABEL_LINE_CACHE
+    lv_text_lines_invalidate(&label->lines);
+#endif
+
     /*If text is NULL then refresh*/
     if(fmt == NULL) {
         lv_label_refr_text(obj);
@@ -218,6 +232,10 @@ void lv_label_set_text_static(lv_obj_t * obj, const char * text)
         label->text       = (char *)text;
     }
 
+#if LV_LABEL_LINE_CACHE
+    lv_text_lines_invalidate(&label->lines);
+#endif
+
     lv_label_refr_text(obj);
 }
 
@@ -337,16 +355,27 @@ void lv_label_get_letter_pos(const lv_obj_t * obj, uint32_t char_id, lv_point_t
     int32_t y = 0;
     uint32_t line_start = 0;
     uint32_t new_line_start = 0;
-    while(txt[new_line_start] != '\0') {
-        bool last_line = y + letter_height + line_space + letter_height > max_h;
-        if(last_line && label->long_mode == LV_LABEL_LONG_DOT) flag |= LV_TEXT_FLAG_BREAK_ALL;
+#if LV_LABEL_LINE_CACHE
+    if(lv_text_lines_matches(&label->lines, font, letter_space, max_w, flag)) {
+        uint32_t line = lv_text_lines_find(&label->lines, byte_id);
+        line_start = lv_text_lines_get_start(&label->lines, line);
+        new_line_start = lv_text_lines_get_start(&label->lines, line + 1);
+        y = (int32_t)line * (letter_height + line_space);
+    }
+    else
+#endif
+    {
+        while(txt[new_line_start] != '\0') {
+            bool last_line = y + letter_height + line_space + letter_height > max_h;
+            if(last_line && label->long_mode == LV_LABEL_LONG_DOT) flag |= LV_TEXT_FLAG_BREAK_ALL;
 
-        new_line_start += lv_text_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
-        if(byte_id < new_line_start || txt[new_line_start] == '\0')
-            break; /*The line of 'index' letter begins at 'line_start'*/
+            new_line_start += lv_text_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+            if(byte_id < new_line_start || txt[new_line_start] == '\0')
+                break; /*The line of 'index' letter begins at 'line_start'*/
 
-        y += letter_height + line_space;
-        line_start = new_line_start;
+            y += letter_height + line_space;
+            line_start = new_line_start;
+        }
     }
 
     /*If the last character is line break then go to the next line*/
@@ -425,27 +454,38 @@ uint32_t lv_label_get_letter_on(const lv_obj_t * obj, lv_point_t * pos_in, bool
 
     lv_text_flag_t flag = get_label_flags(label);
 
-    /*Search the line of the index letter*/;
-    while(txt[line_start] != '\0') {
-        /*If dots will be shown, break the last visible line anywhere,
-         *not only at word boundaries.*/
-        bool last_line = y + letter_height + line_space + letter_height > max_h;
-        if(last_line && label->long_mode == LV_LABEL_LONG_DOT) flag |= LV_TEXT_FLAG_BREAK_ALL;
-
-        new_line_start += lv_text_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+#if LV_LABEL_LINE_CACHE
+    if(get_cached_line_at_y(label, font, letter_space, line_space, max_w, pos.y, &line_start, &new_line_start)) {
+        /*Include the NULL terminator in the last line*/
+        uint32_t tmp = new_line_start;
+        if(new_line_start != line_start && lv_text_encoded_prev(txt, &tmp) != '\n' &&
+           txt[new_line_start] == '\0') new_line_start++;
+    }
+    else
+#endif
+    {
+        /*Search the line of the index letter*/;
+        while(txt[line_start] != '\0') {
+            /*If dots will be shown, break the last visible line anywhere,
+             *not only at word boundaries.*/
+            bool last_line = y + letter_height + line_space + letter_height > max_h;
+            if(last_line && label->long_mode == LV_LABEL_LONG_DOT) flag |= LV_TEXT_FLAG_BREAK_ALL;
+
+            new_line_start += lv_text_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+
+            if(pos.y <= y + letter_height) {
+                /*The line is found (stored in 'line_start')*/
+                /*Include the NULL terminator in the last line*/
+                uint32_t tmp = new_line_start;
+                uint32_t letter;
+                letter = lv_text_encoded_prev(txt, &tmp);
+                if(letter != '\n' && txt[new_line_start] == '\0') new_line_start++;
+                break;
+            }
+            y += letter_height + line_space;
 
-        if(pos.y <= y + letter_height) {
-            /*The line is found (stored in 'line_start')*/
-            /*Include the NULL terminator in the last line*/
-            uint32_t tmp = new_line_start;
-            uint32_t letter;
-            letter = lv_text_encoded_prev(txt, &tmp);
-            if(letter != '\n' && txt[new_line_start] == '\0') new_line_start++;
-            break;
+            line_start = new_line_start;
         }
-        y += letter_height + line_space;
-
-        line_start = new_line_start;
     }
 
     char * bidi_txt;
@@ -539,18 +579,23 @@ bool lv_label_is_char_under_pos(const lv_obj_t * obj, lv_point_t * pos)
 
     lv_text_flag_t flag = get_label_flags(label);
 
-    /*Search the line of the index letter*/
-    int32_t y = 0;
-    while(txt[line_start] != '\0') {
-        bool last_line = y + letter_height + line_space + letter_height > max_h;
-        if(last_line && label->long_mode == LV_LABEL_LONG_DOT) flag |= LV_TEXT_FLAG_BREAK_ALL;
+#if LV_LABEL_LINE_CACHE
+    if(!get_cached_line_at_y(label, font, letter_space, line_space, max_w, pos->y, &line_start, &new_line_start))
+#endif
+    {
+        /*Search the line of the index letter*/
+        int32_t y = 0;
+        while(txt[line_start] != '\0') {
+            bool last_line = y + letter_height + line_space + letter_height > max_h;
+            if(last_line && label->long_mode == LV_LABEL_LONG_DOT) flag |= LV_TEXT_FLAG_BREAK_ALL;
 
-        new_line_start += lv_text_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+            new_line_start += lv_text_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
 
-        if(pos->y <= y + letter_height) break; /*The line is found (stored in 'line_start')*/
-        y += letter_height + line_space;
+            if(pos->y <= y + letter_height) break; /*The line is found (stored in 'line_start')*/
+            y += letter_height + line_space;
 
-        line_start = new_line_start;
+            line_start = new_line_start;
+        }
     }
 
     /*Calculate the x coordinate*/
@@ -648,7 +693,13 @@ void lv_label_ins_text(lv_obj_t * obj, uint32_t pos, const char * txt)
     }
 
     lv_text_ins(label->text, pos, txt);
+#if LV_LABEL_LINE_CACHE && !LV_USE_ARABIC_PERSIAN_CHARS
+    /*Only the lines around the new text need to be broken again*/
+    lv_text_lines_edit(&label->lines, lv_text_encoded_get_byte_id(label->text, pos), 0, ins_len);
+    lv_label_refr_text(obj);
+#else
     lv_label_set_text(obj, NULL);
+#endif
 }
 
 void lv_label_cut_text(lv_obj_t * obj, uint32_t pos, uint32_t cnt)
@@ -662,6 +713,11 @@ void lv_label_cut_text(lv_obj_t * obj, uint32_t pos, uint32_t cnt)
     lv_obj_invalidate(obj);
 
     char * label_txt = lv_label_get_text(obj);
+#if LV_LABEL_LINE_CACHE
+    uint32_t byte_pos = lv_text_encoded_get_byte_id(label_txt, pos);
+    lv_text_lines_edit(&label->lines, byte_pos, lv_text_encoded_get_byte_id(&label_txt[byte_pos], cnt), 0);
+#endif
+
     /*Delete the characters*/
     lv_text_cut(label_txt, pos, cnt);
 
@@ -699,6 +755,10 @@ static void lv_label_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     label->dot.tmp_ptr   = NULL;
     label->dot_tmp_alloc = 0;
 
+#if LV_LABEL_LINE_CACHE
+    lv_text_lines_init(&label->lines);
+#endif
+
     lv_obj_remove_flag(obj, LV_OBJ_FLAG_CLICKABLE);
     lv_label_set_long_mode(obj, LV_LABEL_LONG_WRAP);
     lv_label_set_text(obj, LV_LABEL_DEFAULT_TEXT);
@@ -714,6 +774,10 @@ static void lv_label_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_label_dot_tmp_free(obj);
     if(!label->static_txt) lv_free(label->text);
     label->text = NULL;
+
+#if LV_LABEL_LINE_CACHE
+    lv_text_lines_deinit(&label->lines);
+#endif
 }
 
 static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
@@ -747,8 +811,9 @@ static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
             const lv_font_t * font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
             int32_t letter_space = lv_obj_get_style_text_letter_space(obj, LV_PART_MAIN);
             int32_t line_space = lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
-            lv_text_flag_t flag = LV_TEXT_FLAG_NONE;
-            if(label->expand != 0) flag |= LV_TEXT_FLAG_EXPAND;
+            /*FIT is set only if `w` is LV_COORD_MAX below, so it doesn't change the lines
+             *but lets the size come from the cached lines*/
+            lv_text_flag_t flag = get_label_flags(label);
 
             int32_t w = lv_obj_get_content_width(obj);
             if(lv_obj_get_style_width(obj, LV_PART_MAIN) == LV_SIZE_CONTENT && !obj->w_layout) w = LV_COORD_MAX;
@@ -756,7 +821,7 @@ static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
 
             w = LV_MIN(w, lv_obj_get_style_max_width(obj, 0));
 
-            lv_text_get_size(&label->size_cache, label->text, font, letter_space, line_space, w, flag);
+            get_text_size(label, &label->size_cache, font, letter_space, line_space, w, flag);
             label->invalid_size_cache = false;
         }
 
@@ -793,6 +858,12 @@ static void draw_main(lv_event_t * e)
 
     label_draw_dsc.flag = flag;
     lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &label_draw_dsc);
+#if LV_LABEL_LINE_CACHE
+    if(lv_text_lines_matches(&label->lines, label_draw_dsc.font, label_draw_dsc.letter_space,
+                             lv_area_get_width(&txt_coords), flag)) {
+        label_draw_dsc.lines = &label->lines;
+    }
+#endif
     lv_bidi_calculate_align(&label_draw_dsc.align, &label_draw_dsc.bidi_dir, label->text);
 
     label_draw_dsc.sel_start = lv_label_get_text_selection_start(obj);
@@ -807,8 +878,8 @@ static void draw_main(lv_event_t * e)
     if((label->long_mode == LV_LABEL_LONG_SCROLL || label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR) &&
        (label_draw_dsc.align == LV_TEXT_ALIGN_CENTER || label_draw_dsc.align == LV_TEXT_ALIGN_RIGHT)) {
         lv_point_t size;
-        lv_text_get_size(&size, label->text, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
-                         LV_COORD_MAX, flag);
+        get_text_size(label, &size, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
+                      LV_COORD_MAX, flag);
         if(size.x > lv_area_get_width(&txt_coords)) {
             label_draw_dsc.align = LV_TEXT_ALIGN_LEFT;
         }
@@ -840,8 +911,8 @@ static void draw_main(lv_event_t * e)
 
     if(label->long_mode == LV_LABEL_LONG_SCROLL_CIRCULAR) {
         lv_point_t size;
-        lv_text_get_size(&size, label->text, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
-                         LV_COORD_MAX, flag);
+        get_text_size(label, &size, label_draw_dsc.font, label_draw_dsc.letter_space, label_draw_dsc.line_space,
+                      LV_COORD_MAX, flag);
 
         /*Draw the text again on label to the original to make a circular effect */
         if(size.x > lv_area_get_width(&txt_coords)) {
@@ -913,7 +984,13 @@ static void lv_label_refr_text(lv_obj_t * obj)
     lv_point_t size;
     lv_text_flag_t flag = get_label_flags(label);
 
-    lv_text_get_size(&size, label->text, font, letter_space, line_space, max_w, flag);
+#if LV_LABEL_LINE_CACHE
+    /*The dots change the text, so their lines are not kept*/
+    if(label->long_mode == LV_LABEL_LONG_DOT) lv_text_lines_invalidate(&label->lines);
+    else lv_text_lines_update(&label->lines, label->text, font, letter_space, max_w, flag);
+#endif
+
+    get_text_size(label, &size, font, letter_space, line_space, max_w, flag);
 
     lv_obj_refresh_self_size(obj);
 
@@ -1313,6 +1390,47 @@ static lv_text_flag_t get_label_flags(lv_label_t * label)
     return flag;
 }
 
+/**
+ * Get the size of the label's text, from the cached lines if they were broken the same way
+ */
+static void get_text_size(lv_label_t * label, lv_point_t * size_res, const lv_font_t * font, int32_t letter_space,
+                          int32_t line_space, int32_t max_width, lv_text_flag_t flag)
+{
+#if LV_LABEL_LINE_CACHE
+    if(lv_text_lines_matches(&label->lines, font, letter_space, max_width, flag)) {
+        lv_text_lines_get_size(&label->lines, label->text, line_space, size_res);
+        return;
+    }
+#endif
+
+    lv_text_get_size(size_res, label->text, font, letter_space, line_space, max_width, flag);
+}
+
+#if LV_LABEL_LINE_CACHE
+/**
+ * Find the line at a y coordinate in the cached lines, the same one as searching line by line.
+ * If `y` is below the text both `line_start` and `line_end` are the length of the text.
+ * @return false if the cached lines were broken an other way
+ */
+static bool get_cached_line_at_y(lv_label_t * label, const lv_font_t * font, int32_t letter_space, int32_t line_space,
+                                 int32_t max_width, int32_t y, uint32_t * line_start, uint32_t * line_end)
+{
+    const int32_t letter_height = lv_font_get_line_height(font);
+    const int32_t line_height = letter_height + line_space;
+    if(line_height <= 0) return false;
+    if(!lv_text_lines_matches(&label->lines, font, letter_space, max_width, get_label_flags(label))) return false;
+
+    /*The first line whose bottom is not above `y`*/
+    uint32_t line = y <= letter_height ? 0 : (y - letter_height + line_height - 1) / line_height;
+    uint32_t line_cnt = lv_text_lines_get_count(&label->lines);
+    if(line >= line_cnt) line = line_cnt;
+
+    *line_start = lv_text_lines_get_start(&label->lines, line);
+    *line_end = line < line_cnt ? lv_text_lines_get_start(&label->lines, line + 1) : *line_start;
+    return true;
+}
+#endif
+
 /* Function created because of this pattern be used in multiple functions */
 static void calculate_x_coordinate(int32_t * x, const lv_text_align_t align, const char * txt, uint32_t length,
                                    const lv_font_t * font, int32_t letter_space, lv_area_t * txt_coords)
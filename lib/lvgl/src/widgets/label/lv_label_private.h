@@ -16,6 +16,7 @@ extern "C" {
 
 #include "../../draw/lv_draw_label_private.h"
 #include "../../core/lv_obj_private.h"
+#include "../../misc/lv_text_private.h"
 #include "lv_label.h"
 
 #if LV_USE_LABEL != 0
@@ -46,6 +47,10 @@ struct lv_label_t {
     uint32_t sel_end;
 #endif
 
+#if LV_LABEL_LINE_CACHE
+    lv_text_lines_t lines;              /**< Line breaks of the text, to break only the edited lines again */
+#endif
+
     lv_point_t size_cache;              /**< Text size cache */
     lv_point_t offset;                  /**< Text draw position offset */
     lv_label_long_mode_t long_mode : 3; /**< Determine what to do with the long texts */
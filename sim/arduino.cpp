@@ -0,0 +1,125 @@
+/**
+ * @file      arduino.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "sim.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <Wire.h>
+
+#include <deque>
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <vector>
+
+HardwareSerial Serial;
+LittleFSFS LittleFS;
+TwoWire Wire;
+
+static SimWireReader wire_reader = NULL;
+
+uint32_t sim_millis = 0;
+
+uint32_t millis() {
+  return sim_millis;
+}
+
+uint32_t micros() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint32_t)(t.tv_sec * 1000000ULL + t.tv_nsec / 1000);
+}
+
+void delay(uint32_t ms) {
+  sim_millis += ms;
+}
+
+struct SimQueue {
+  uint32_t length;
+  uint32_t item_size;
+  std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(uint32_t length, uint32_t item_size) {
+  return new SimQueue{length, item_size, {}};
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait) {
+  if (queue->items.size() >= queue->length)
+    return pdFALSE;
+  const uint8_t *p = (const uint8_t *)item;
+  queue->items.emplace_back(p, p + queue->item_size);
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait) {
+  if (queue->items.empty())
+    return pdFALSE;
+  memcpy(item, queue->items.front().data(), queue->item_size);
+  queue->items.pop_front();
+  return pdTRUE;
+}
+
+void simWireSetReader(SimWireReader reader) { wire_reader = reader; }
+
+uint8_t TwoWire::requestFrom(uint8_t address, size_t size) {
+  size_ = 0;
+  pos_ = 0;
+  while (wire_reader && size_ < size && size_ < sizeof(buf_)) {
+    int value = wire_reader(address);
+    if (value < 0)
+      break;
+    buf_[size_++] = (uint8_t)value;
+  }
+  return (uint8_t)size_;
+}
+
+int HardwareSerial::printf(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int n = vprintf(format, args);
+  va_end(args);
+  return n;
+}
+
+size_t fs::File::size() {
+  struct stat st;
+  return fstat(fileno(f_.get()), &st) == 0 ? st.st_size : 0;
+}
+
+size_t fs::File::read(uint8_t *buf, size_t size) {
+  return fread(buf, 1, size, f_.get());
+}
+
+size_t fs::File::write(const uint8_t *buf, size_t size) {
+  return fwrite(buf, 1, size, f_.get());
+}
+
+bool LittleFSFS::begin(bool format_if_failed) {
+  struct stat st;
+  return stat(root_.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+fs::File LittleFSFS::open(const char *path, const char *mode) {
+  fs::File file;
+  // LittleFS has no text mode, and "w" also truncates on the device
+  std::string m = std::string(mode) + "b";
+  FILE *f = fopen(hostPath(path).c_str(), m.c_str());
+  if (f)
+    file.f_.reset(f, fclose);
+  return file;
+}
+
+bool LittleFSFS::exists(const char *path) {
+  struct stat st;
+  return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool LittleFSFS::remove(const char *path) {
+  return ::remove(hostPath(path).c_str()) == 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file      anim_bench.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * 50 concurrent y animations of luavgl objects, run with each kind of
+ * exec_cb: a Lua function setting the style with obj:set { y = v }, a Lua
+ * function calling obj:setp(Y, v), and the handle from lvgl.prop("y") bound
+ * to the anim. Prints the time of an animation tick and the Lua garbage it
+ * leaves, with the collector stopped.
+ */
+#include <Arduino.h>
+#include <lvgl.h>
+
+extern "C" {
+#include "lauxlib.h"
+#include "lualib.h"
+#include "luavgl.h"
+}
+
+#define BENCH_ANIMS 50
+#define BENCH_TICKS 2000
+#define BENCH_RUNS 5
+
+static const char *setup = R"(
+local mode, count = ...
+local Y = lvgl.prop("y")
+local exec_cbs = {
+  set = function(obj, value) obj:set { y = value } end,
+  setp = function(obj, value) obj:setp(Y, value) end,
+  prop = Y,
+}
+for i = 1, count do
+  local obj = lvgl.Object { x = (i - 1) % 10 * 30, size = 20 }
+  obj:Anim {
+    run = true,
+    start_value = 0,
+    end_value = 200,
+    duration = 1000 + i * 10,
+    repeat_count = lvgl.ANIM_REPEAT_INFINITE,
+    exec_cb = exec_cbs[mode],
+  }
+end
+)";
+
+static uint32_t tick_ms = 0;
+static uint32_t tickCb() { return tick_ms; }
+
+static void flushCb(lv_display_t *disp, const lv_area_t *area,
+                    uint8_t *px_map) {
+  lv_display_flush_ready(disp);
+}
+
+struct Result {
+  double us;        // per animation tick, best run
+  double garbage_b; // Lua bytes allocated per tick
+};
+
+// Run the animations alone, without rendering the frames they invalidate
+static Result run(const char *mode) {
+  lv_obj_t *root = lv_obj_create(lv_screen_active());
+  lua_State *L = luaL_newstate();
+  luaL_openlibs(L);
+  luavgl_set_root(L, root);
+  luaL_requiref(L, "lvgl", luaopen_lvgl, 1);
+  lua_pop(L, 1);
+
+  if (luaL_loadstring(L, setup) != LUA_OK) {
+    fprintf(stderr, "setup: %s\n", lua_tostring(L, -1));
+    exit(1);
+  }
+  lua_pushstring(L, mode);
+  lua_pushinteger(L, BENCH_ANIMS);
+  if (lua_pcall(L, 2, 0, 0) != LUA_OK) {
+    fprintf(stderr, "setup: %s\n", lua_tostring(L, -1));
+    exit(1);
+  }
+  lua_gc(L, LUA_GCCOLLECT);
+  lua_gc(L, LUA_GCSTOP);
+
+  Result result = {1e9, 0};
+  for (int r = 0; r < BENCH_RUNS; r++) {
+    size_t before = lua_gc(L, LUA_GCCOUNT) * 1024 + lua_gc(L, LUA_GCCOUNTB);
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_TICKS; i++) {
+      tick_ms += LV_DEF_REFR_PERIOD;
+      lv_anim_refr_now();
+    }
+    double us = (double)(micros() - start) / BENCH_TICKS;
+    size_t after = lua_gc(L, LUA_GCCOUNT) * 1024 + lua_gc(L, LUA_GCCOUNTB);
+    if (us < result.us)
+      result.us = us;
+    result.garbage_b = (double)(after - before) / BENCH_TICKS;
+    lua_gc(L, LUA_GCCOLLECT);
+    lua_gc(L, LUA_GCSTOP);
+  }
+
+  // Like closing an app: the finalizers delete the anims and objects
+  lua_close(L);
+  lv_obj_delete(root);
+  return result;
+}
+
+int main() {
+  lv_init();
+  lv_tick_set_cb(tickCb);
+  lv_display_t *disp = lv_display_create(320, 240);
+  static uint8_t buf[320 * 40 * 2];
+  lv_display_set_buffers(disp, buf, NULL, sizeof(buf),
+                         LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_set_flush_cb(disp, flushCb);
+
+  static const struct {
+    const char *mode;
+    const char *name;
+  } modes[] = {
+      {"set", "obj:set { y = v } in exec_cb"},
+      {"setp", "obj:setp(Y, v) in exec_cb"},
+      {"prop", "exec_cb = lvgl.prop(\"y\")"},
+  };
+
+  printf("%d animations, %d ticks, best of %d\n", BENCH_ANIMS, BENCH_TICKS,
+         BENCH_RUNS);
+  for (const auto &m : modes) {
+    Result r = run(m.mode);
+    printf("%-30s %7.1f us per tick, %6.0f bytes of garbage per tick\n",
+           m.name, r.us, r.garbage_b);
+    if (lv_anim_count_running() != 0) {
+      fprintf(stderr, "%s: animations left running\n", m.mode);
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file      event_bench.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * 10,000 synthetic events sent with lv_obj_send_event() to luavgl handlers:
+ * CLICKED to a plain Lua handler, and PRESSING, 10 per lv_timer_handler()
+ * run like a drag sampled faster than the frame rate, to a plain and to a
+ * coalesced handler. Prints the time per event, including the runs that
+ * flush the coalesced ones, and the Lua calls made.
+ *
+ *   event_bench [events]
+ */
+#include <Arduino.h>
+#include <lvgl.h>
+
+extern "C" {
+#include "lauxlib.h"
+#include "lualib.h"
+#include "luavgl.h"
+}
+
+#define BENCH_EVENTS 10000
+#define BENCH_PER_FRAME 10
+#define BENCH_RUNS 5
+
+static const char *setup = R"(
+calls = 0
+local function handler(obj, code)
+  calls = calls + 1
+end
+clicked = lvgl.Object { size = 40 }
+clicked:onevent(lvgl.EVENT.CLICKED, handler)
+pressing = lvgl.Object { size = 40 }
+pressing:onevent(lvgl.EVENT.PRESSING, handler)
+coalesced = lvgl.Object { size = 40 }
+coalesced:onevent(lvgl.EVENT.PRESSING, handler, true)
+)";
+
+static uint32_t tick_ms = 0;
+static uint32_t tickCb() { return tick_ms; }
+
+static void flushCb(lv_display_t *disp, const lv_area_t *area,
+                    uint8_t *px_map) {
+  lv_display_flush_ready(disp);
+}
+
+static lv_obj_t *luaObj(lua_State *L, const char *name) {
+  lua_getglobal(L, name);
+  lv_obj_t *obj = luavgl_to_obj(L, -1);
+  lua_pop(L, 1);
+  return obj;
+}
+
+static lua_Integer luaCalls(lua_State *L) {
+  lua_getglobal(L, "calls");
+  lua_Integer calls = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  return calls;
+}
+
+// Best of BENCH_RUNS; per_frame events between lv_timer_handler() runs, or
+// none for events sent back to back
+static void run(lua_State *L, const char *name, lv_event_code_t code,
+                const char *code_name, int events, int per_frame) {
+  lv_obj_t *obj = luaObj(L, name);
+  double best = 1e9;
+  lua_Integer calls = 0;
+  for (int r = 0; r < BENCH_RUNS; r++) {
+    lua_Integer before = luaCalls(L);
+    uint32_t start = micros();
+    for (int i = 0; i < events; i++) {
+      lv_obj_send_event(obj, code, NULL);
+      if (per_frame && (i + 1) % per_frame == 0) {
+        tick_ms += LV_DEF_REFR_PERIOD;
+        lv_timer_handler();
+      }
+    }
+    double ns = (micros() - start) * 1000.0 / events;
+    if (ns < best)
+      best = ns;
+    calls = luaCalls(L) - before;
+  }
+  printf("%-10s %-9s %6d events, %6.0f ns per event, %6lld Lua calls\n",
+         code_name, name, events, best, (long long)calls);
+}
+
+int main(int argc, char **argv) {
+  int events = argc > 1 ? atoi(argv[1]) : BENCH_EVENTS;
+
+  lv_init();
+  lv_tick_set_cb(tickCb);
+  lv_display_t *disp = lv_display_create(320, 240);
+  static uint8_t buf[320 * 40 * 2];
+  lv_display_set_buffers(disp, buf, NULL, sizeof(buf),
+                         LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_set_flush_cb(disp, flushCb);
+
+  lv_obj_t *root = lv_obj_create(lv_screen_active());
+  lua_State *L = luaL_newstate();
+  luaL_openlibs(L);
+  luavgl_set_root(L, root);
+  luaL_requiref(L, "lvgl", luaopen_lvgl, 1);
+  lua_pop(L, 1);
+
+  if (luaL_loadstring(L, setup) != LUA_OK ||
+      lua_pcall(L, 0, 0, 0) != LUA_OK) {
+    fprintf(stderr, "setup: %s\n", lua_tostring(L, -1));
+    return 1;
+  }
+  // Draw once, the runs below only process events
+  lv_refr_now(NULL);
+
+  printf("best of %d, %d PRESSING per lv_timer_handler() run\n", BENCH_RUNS,
+         BENCH_PER_FRAME);
+  run(L, "clicked", LV_EVENT_CLICKED, "CLICKED", events, 0);
+  run(L, "pressing", LV_EVENT_PRESSING, "PRESSING", events, BENCH_PER_FRAME);
+  run(L, "coalesced", LV_EVENT_PRESSING, "PRESSING", events,
+      BENCH_PER_FRAME);
+
+  lua_close(L);
+  lv_obj_delete(root);
+  return 0;
+}
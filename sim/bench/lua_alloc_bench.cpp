@@ -0,0 +1,132 @@
+/**
+ * @file      lua_alloc_bench.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * Records the allocations of a chat-like Lua workload, then replays the trace
+ * through luaAlloc and through the C heap allocator of lauxlib. luaAlloc
+ * replays with the slabs grown while recording, like a long-running app.
+ */
+#include "lua_alloc.h"
+
+extern "C" {
+#include "lauxlib.h"
+#include "lualib.h"
+}
+
+#include <unordered_map>
+#include <vector>
+
+#define BENCH_REPLAYS 20
+
+// Messages kept in the history, like the messenger's list
+static const char *workload = R"(
+local history = {}
+local names = { "alice", "bob", "carol", "dave" }
+for i = 1, 20000 do
+  local msg = {
+    from = names[i % #names + 1],
+    text = string.format("message %d: %s", i, string.rep("x", i % 90)),
+    time = i * 1000,
+  }
+  msg.line = msg.from .. "> " .. msg.text
+  msg.words = {}
+  for w in msg.text:gmatch("%S+") do
+    msg.words[#msg.words + 1] = w
+  end
+  history[#history + 1] = msg
+  if #history > 200 then
+    table.remove(history, 1)
+  end
+  if i % 500 == 0 then
+    local parts = {}
+    for _, m in ipairs(history) do
+      parts[#parts + 1] = m.line
+    end
+    local _ = table.concat(parts, "\n")
+  end
+end
+)";
+
+struct TraceOp {
+  uint32_t old_id; // slot of the block passed in, or UINT32_MAX for none
+  uint32_t new_id; // slot receiving the result
+  uint32_t osize;
+  uint32_t nsize;
+};
+
+static std::vector<TraceOp> trace;
+static std::unordered_map<void *, uint32_t> live_ids;
+static uint32_t slots = 0;
+
+static void *recordAlloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+  void *nptr = luaAlloc(ud, ptr, osize, nsize);
+  if (nsize && !nptr)
+    return NULL;
+
+  TraceOp op = {UINT32_MAX, UINT32_MAX, (uint32_t)osize, (uint32_t)nsize};
+  if (ptr) {
+    auto it = live_ids.find(ptr);
+    op.old_id = it->second;
+    live_ids.erase(it);
+  }
+  if (nptr) {
+    op.new_id = slots++;
+    live_ids[nptr] = op.new_id;
+  }
+  trace.push_back(op);
+  return nptr;
+}
+
+static void *libcAlloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+  (void)ud;
+  (void)osize;
+  if (nsize == 0) {
+    free(ptr);
+    return NULL;
+  }
+  return realloc(ptr, nsize);
+}
+
+// Replay the trace BENCH_REPLAYS times, returns ns per operation. The trace
+// ends with lua_close(), so every replay frees all of its blocks.
+static double replay(lua_Alloc alloc) {
+  std::vector<void *> blocks(slots);
+  uint32_t start = micros();
+  for (int r = 0; r < BENCH_REPLAYS; r++) {
+    for (const TraceOp &op : trace) {
+      void *ptr = op.old_id == UINT32_MAX ? NULL : blocks[op.old_id];
+      void *nptr = alloc(NULL, ptr, op.osize, op.nsize);
+      if (op.new_id != UINT32_MAX) {
+        if (!nptr) {
+          fprintf(stderr, "replay: allocation of %lu bytes failed\n",
+                  (unsigned long)op.nsize);
+          exit(1);
+        }
+        blocks[op.new_id] = nptr;
+      }
+    }
+  }
+  uint32_t us = micros() - start;
+  return us * 1000.0 / ((double)trace.size() * BENCH_REPLAYS);
+}
+
+int main() {
+  lua_State *L = lua_newstate(recordAlloc, NULL);
+  luaL_openlibs(L);
+  if (luaL_dostring(L, workload) != LUA_OK) {
+    fprintf(stderr, "workload: %s\n", lua_tostring(L, -1));
+    return 1;
+  }
+  lua_close(L);
+
+  printf("Trace: %lu operations, %lu blocks\n", (unsigned long)trace.size(),
+         (unsigned long)slots);
+  printf("libc realloc: %.1f ns per operation\n", replay(libcAlloc));
+  printf("luaAlloc:     %.1f ns per operation\n", replay(luaAlloc));
+
+  luaAllocPrintStats();
+  return 0;
+}
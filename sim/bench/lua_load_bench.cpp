@@ -0,0 +1,275 @@
+/**
+ * @file      lua_load_bench.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * Load time and peak heap of Lua scripts, from a copy in a temporary
+ * directory. A generated 100 KB script is loaded the way readFile() did,
+ * whole into one buffer, streamed by luaLoadFile(), and from its bytecode by
+ * luaLoadScript(). Every script in /lua of the simulator's filesystem is
+ * then loaded from source and from its bytecode.
+ *
+ * The heap counts the Lua state's allocations and operator new (the block
+ * reader), peak above what was live before the load.
+ *
+ *   lua_load_bench [fs_dir]
+ */
+#include "lua_loader.h"
+#include <LittleFS.h>
+
+extern "C" {
+#include "lauxlib.h"
+}
+
+#include <dirent.h>
+#include <new>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#ifndef SIM_FS_DIR
+#define SIM_FS_DIR "fs"
+#endif
+
+#define BENCH_RUNS 20
+#define BIG_SCRIPT_SIZE (100 * 1024)
+
+bool fs_mounted = true;
+
+static size_t heap_live = 0;
+static size_t heap_peak = 0;
+
+static void heapTrack(size_t freed, size_t allocated) {
+  heap_live += allocated - freed;
+  if (heap_live > heap_peak)
+    heap_peak = heap_live;
+}
+
+static void *countingAlloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+  if (!ptr)
+    osize = 0; // the type of the new object
+  if (nsize == 0) {
+    free(ptr);
+    heapTrack(osize, 0);
+    return NULL;
+  }
+  void *p = realloc(ptr, nsize);
+  if (p)
+    heapTrack(osize, nsize);
+  return p;
+}
+
+// operator new keeps the size in front of the block to count its delete
+#define NEW_HEADER 16
+
+void *operator new(size_t size) {
+  size_t *p = (size_t *)malloc(size + NEW_HEADER);
+  if (!p)
+    throw std::bad_alloc();
+  *p = size;
+  heapTrack(0, size);
+  return (char *)p + NEW_HEADER;
+}
+
+void operator delete(void *ptr) noexcept {
+  if (!ptr)
+    return;
+  size_t *p = (size_t *)((char *)ptr - NEW_HEADER);
+  heapTrack(*p, 0);
+  free(p);
+}
+
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+
+// What readFile() did before luaLoadFile(): the whole file in one buffer
+static int loadWhole(lua_State *L, const char *path) {
+  fs::File file = LittleFS.open(path, "r");
+  size_t size = file.size();
+  char *buf = (char *)malloc(size);
+  heapTrack(0, size);
+  int status = file.read((uint8_t *)buf, size) == size
+                   ? luaL_loadbuffer(L, buf, size, path)
+                   : LUA_ERRFILE;
+  if (status == LUA_ERRFILE)
+    lua_pushstring(L, "read failed");
+  free(buf);
+  heapTrack(size, 0);
+  file.close();
+  return status;
+}
+
+enum LoadMode { LOAD_WHOLE, LOAD_SOURCE, LOAD_SCRIPT };
+
+struct LoadResult {
+  uint32_t us;     // best of BENCH_RUNS
+  size_t peak_b;   // heap peak above the heap before the load
+  size_t chunk_b;  // heap still held by the loaded chunk
+};
+
+static int load(lua_State *L, const std::string &path, LoadMode mode) {
+  switch (mode) {
+  case LOAD_WHOLE:
+    return loadWhole(L, path.c_str());
+  case LOAD_SOURCE:
+    return luaLoadFile(L, path.c_str(), path.c_str(), "t");
+  default:
+    return luaLoadScript(L, path.c_str());
+  }
+}
+
+static LoadResult bestLoad(lua_State *L, const std::string &path,
+                           LoadMode mode) {
+  LoadResult result = {UINT32_MAX, 0, 0};
+  for (int r = 0; r < BENCH_RUNS; r++) {
+    lua_gc(L, LUA_GCCOLLECT);
+    lua_gc(L, LUA_GCSTOP);
+    size_t before = heap_live;
+    heap_peak = heap_live;
+    uint32_t start = micros();
+    int status = load(L, path, mode);
+    uint32_t us = micros() - start;
+    if (status != LUA_OK) {
+      fprintf(stderr, "%s: %s\n", path.c_str(), lua_tostring(L, -1));
+      exit(1);
+    }
+    result.peak_b = heap_peak - before;
+    result.chunk_b = heap_live - before;
+    lua_pop(L, 1);
+    lua_gc(L, LUA_GCRESTART);
+    if (us < result.us)
+      result.us = us;
+  }
+  return result;
+}
+
+// Writes the bytecode of a script, as its first load on the device does
+static void cacheScript(lua_State *L, const std::string &path) {
+  if (luaLoadScript(L, path.c_str()) != LUA_OK) {
+    fprintf(stderr, "%s: %s\n", path.c_str(), lua_tostring(L, -1));
+    exit(1);
+  }
+  lua_pop(L, 1);
+}
+
+// Handlers like the ones of an app, until the source reaches size bytes
+static bool writeBigScript(const std::string &file, size_t size) {
+  FILE *f = fopen(file.c_str(), "w");
+  if (!f)
+    return false;
+  size_t written = 0;
+  for (int i = 0; written < size; i++) {
+    int n = fprintf(f,
+                    "function handler_%d(msg, opts)\n"
+                    "  local text = msg.text or \"message %d\"\n"
+                    "  local row = { id = %d, name = \"row%d\", "
+                    "width = opts.width * %d, items = { 1, 2, 3 } }\n"
+                    "  for k = 1, #row.items do\n"
+                    "    row.width = row.width + row.items[k]\n"
+                    "  end\n"
+                    "  if row.width > 200 then\n"
+                    "    return text .. \" is wide\"\n"
+                    "  end\n"
+                    "  return text\n"
+                    "end\n\n",
+                    i, i, i, i, i % 7 + 1);
+    if (n < 0)
+      break;
+    written += n;
+  }
+  return fclose(f) == 0 && written >= size;
+}
+
+static bool copyFile(const std::string &from, const std::string &to) {
+  FILE *in = fopen(from.c_str(), "rb");
+  FILE *out = fopen(to.c_str(), "wb");
+  bool ok = in && out;
+  char buf[4096];
+  size_t n;
+  while (ok && (n = fread(buf, 1, sizeof(buf), in)) > 0)
+    ok = fwrite(buf, 1, n, out) == n;
+  if (in)
+    fclose(in);
+  if (out)
+    fclose(out);
+  return ok;
+}
+
+static long fileSize(const std::string &path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 ? (long)st.st_size : -1;
+}
+
+static void printLoad(const char *name, const LoadResult &r) {
+  printf("%-34s %7lu %9zu %9zu\n", name, (unsigned long)r.us, r.peak_b,
+         r.chunk_b);
+}
+
+int main(int argc, char **argv) {
+  std::string fs_dir = argc > 1 ? argv[1] : SIM_FS_DIR;
+
+  char tmp[] = "/tmp/lua_load_benchXXXXXX";
+  if (!mkdtemp(tmp)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  std::string dir = tmp;
+  mkdir((dir + "/lua").c_str(), 0755);
+
+  std::vector<std::string> scripts;
+  DIR *d = opendir((fs_dir + "/lua").c_str());
+  if (!d) {
+    fprintf(stderr, "no scripts in %s/lua\n", fs_dir.c_str());
+    return 1;
+  }
+  while (struct dirent *e = readdir(d)) {
+    std::string name = e->d_name;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".lua") == 0) {
+      std::string path = "/lua/" + name;
+      if (copyFile(fs_dir + path, dir + path))
+        scripts.push_back(path);
+    }
+  }
+  closedir(d);
+
+  std::string big = "/bench_big.lua";
+  if (!writeBigScript(dir + big, BIG_SCRIPT_SIZE)) {
+    fprintf(stderr, "cannot write %s%s\n", dir.c_str(), big.c_str());
+    return 1;
+  }
+
+  LittleFS.setRoot(dir.c_str());
+  lua_State *L = lua_newstate(countingAlloc, NULL);
+
+  printf("%s, %ld bytes, best of %d\n", big.c_str(), fileSize(dir + big),
+         BENCH_RUNS);
+  printf("%-34s %7s %9s %9s\n", "", "us", "peak B", "chunk B");
+  printLoad("whole file, luaL_loadbuffer", bestLoad(L, big, LOAD_WHOLE));
+  printLoad("luaLoadFile, blocks", bestLoad(L, big, LOAD_SOURCE));
+  cacheScript(L, big);
+  printf("bytecode %ld bytes\n", fileSize(dir + big + "c"));
+  printLoad("luaLoadScript, bytecode", bestLoad(L, big, LOAD_SCRIPT));
+
+  printf("\n%-20s %7s %7s %9s %9s\n", "us, best of 20", "source", "luac",
+         "compile", "luac");
+  for (const std::string &path : scripts) {
+    LoadResult compile = bestLoad(L, path, LOAD_SOURCE);
+    cacheScript(L, path);
+    LoadResult cached = bestLoad(L, path, LOAD_SCRIPT);
+    printf("%-20s %7ld %7ld %9lu %9lu\n", path.c_str(), fileSize(dir + path),
+           fileSize(dir + path + "c"), (unsigned long)compile.us,
+           (unsigned long)cached.us);
+  }
+  lua_close(L);
+
+  scripts.push_back(big);
+  for (const std::string &path : scripts) {
+    remove((dir + path).c_str());
+    remove((dir + path + "c").c_str());
+  }
+  rmdir((dir + "/lua").c_str());
+  rmdir(dir.c_str());
+  return 0;
+}
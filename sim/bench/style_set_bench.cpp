@@ -0,0 +1,143 @@
+/**
+ * @file      style_set_bench.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * 500 labels built with 8 style keys each through obj:set { ... }, like the
+ * messenger builds its rows, then the same 8 keys set again on every label.
+ * Prints the time per set and per key. style_set_bench_linear is the same
+ * with luavgl built with LUAVGL_STYLE_LINEAR_SCAN, the lookup luavgl had
+ * before the sorted index and the pointer cache.
+ */
+#include <Arduino.h>
+#include <lvgl.h>
+
+extern "C" {
+#include "lauxlib.h"
+#include "lualib.h"
+#include "luavgl.h"
+}
+
+#define BENCH_LABELS 500
+#define BENCH_KEYS 8
+#define BENCH_RUNS 20
+
+#if LUAVGL_STYLE_LINEAR_SCAN
+#define BENCH_LOOKUP "linear scan"
+#else
+#define BENCH_LOOKUP "binary search and pointer cache"
+#endif
+
+static const char *setup = R"(
+local count = ...
+labels = {}
+local function style(label, i)
+  label:set {
+    bg_color = "#202020",
+    bg_opa = 255,
+    border_width = i % 2,
+    radius = 4,
+    pad_left = 10,
+    pad_right = 6,
+    text_color = "#e0e0e0",
+    text_align = 1, -- LV_TEXT_ALIGN_LEFT
+  }
+end
+function build()
+  for i = 1, count do
+    local label = lvgl.Label { text = "row" }
+    style(label, i)
+    labels[i] = label
+  end
+end
+function restyle()
+  for i = 1, count do
+    style(labels[i], i)
+  end
+end
+function clear()
+  for i = 1, count do
+    labels[i]:delete()
+    labels[i] = nil
+  end
+  collectgarbage()
+end
+)";
+
+static void flushCb(lv_display_t *disp, const lv_area_t *area,
+                    uint8_t *px_map) {
+  lv_display_flush_ready(disp);
+}
+
+static void call(lua_State *L, const char *name) {
+  lua_getglobal(L, name);
+  if (lua_pcall(L, 0, 0, 0) != LUA_OK) {
+    fprintf(stderr, "%s: %s\n", name, lua_tostring(L, -1));
+    exit(1);
+  }
+}
+
+// Best time of a call in us
+static uint32_t bestCall(lua_State *L, const char *name, const char *after) {
+  uint32_t best = UINT32_MAX;
+  for (int r = 0; r < BENCH_RUNS; r++) {
+    uint32_t start = micros();
+    call(L, name);
+    uint32_t us = micros() - start;
+    if (us < best)
+      best = us;
+    if (after)
+      call(L, after);
+  }
+  return best;
+}
+
+int main() {
+  lv_init();
+  // 500 styled labels need more than the 64 KB of lv_conf.h; TLSF takes
+  // pools up to about that size
+  static uint8_t pools[16][60 * 1024];
+  for (auto &pool : pools)
+    lv_mem_add_pool(pool, sizeof(pool));
+  lv_display_t *disp = lv_display_create(320, 240);
+  static uint8_t buf[320 * 40 * 2];
+  lv_display_set_buffers(disp, buf, NULL, sizeof(buf),
+                         LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_set_flush_cb(disp, flushCb);
+
+  lv_obj_t *root = lv_obj_create(lv_screen_active());
+  lua_State *L = luaL_newstate();
+  luaL_openlibs(L);
+  luavgl_set_root(L, root);
+  luaL_requiref(L, "lvgl", luaopen_lvgl, 1);
+  lua_pop(L, 1);
+
+  if (luaL_loadstring(L, setup) != LUA_OK) {
+    fprintf(stderr, "setup: %s\n", lua_tostring(L, -1));
+    return 1;
+  }
+  lua_pushinteger(L, BENCH_LABELS);
+  if (lua_pcall(L, 1, 0, 0) != LUA_OK) {
+    fprintf(stderr, "setup: %s\n", lua_tostring(L, -1));
+    return 1;
+  }
+
+  // Building includes creating the labels; restyling only sets
+  uint32_t build = bestCall(L, "build", "clear");
+  call(L, "build");
+  uint32_t restyle = bestCall(L, "restyle", NULL);
+
+  printf("%s, %d labels x %d keys, best of %d\n", BENCH_LOOKUP, BENCH_LABELS,
+         BENCH_KEYS, BENCH_RUNS);
+  printf("build    %6u us, %6.0f ns per label\n", build,
+         build * 1000.0 / BENCH_LABELS);
+  printf("restyle  %6u us, %6.0f ns per set, %5.0f ns per key\n", restyle,
+         restyle * 1000.0 / BENCH_LABELS,
+         restyle * 1000.0 / (BENCH_LABELS * BENCH_KEYS));
+
+  lua_close(L);
+  lv_obj_delete(root);
+  return 0;
+}
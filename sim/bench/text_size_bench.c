@@ -0,0 +1,105 @@
+/**
+ * @file      text_size_bench.c
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * Layout time of chat messages with lv_text_get_size(), wrapped to the
+ * message list's width, in the Montserrat 12, 14 and 28 fonts with their
+ * glyph_id_table and with the same fonts searching their cmaps only. One
+ * corpus is plain ASCII, the other Latin-1 text with accented letters. Prints
+ * ns per letter on the host, the best of ten runs.
+ */
+#include <lvgl.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define REPEAT 1000
+#define RUNS 10
+#define MAX_WIDTH 290
+
+static const char *ascii[] = {
+    "Message 12: the quick brown fox jumps over the lazy dog",
+    "Are we still meeting at the station at 6? Bring the spare antenna.",
+    "OK, see you there. Battery is at 84%, signal -97 dBm.",
+    "Node 7 relayed 128 packets today; 3 were dropped (CRC).",
+    "Hello from the hill! Range test #4 worked, next one tomorrow.",
+};
+
+static const char *latin1[] = {
+    "Grüße aus Köln! Wir treffen uns um 18 Uhr am Bahnhof.",
+    "Ça va très bien, merci. À demain près du château ?",
+    "¿Dónde está el señor Muñoz? Llegó a São Paulo ayer.",
+    "Smørrebrød og æblekage på Nørrebro, kl. 12 – så ses vi.",
+    "Température: 23 °C, humidité 45 %, vent 12 km/h, ½ nuageux.",
+};
+
+#define CORPUS_LEN (sizeof(ascii) / sizeof(ascii[0]))
+
+static double seconds(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static uint32_t letters(const char **corpus) {
+  uint32_t n = 0;
+  for (size_t i = 0; i < CORPUS_LEN; i++) {
+    for (const char *p = corpus[i]; *p; p++)
+      n += ((uint8_t)*p & 0xc0) != 0x80;
+  }
+  return n;
+}
+
+// ns per letter of laying out the corpus REPEAT times
+static double layout(const lv_font_t *font, const char **corpus) {
+  double start = seconds();
+  for (int i = 0; i < REPEAT; i++) {
+    for (size_t m = 0; m < CORPUS_LEN; m++) {
+      lv_point_t size;
+      lv_text_get_size(&size, corpus[m], font, 0, 0, MAX_WIDTH,
+                       LV_TEXT_FLAG_NONE);
+    }
+  }
+  return (seconds() - start) * 1e9 / (letters(corpus) * REPEAT);
+}
+
+static void runFont(const char *name, const lv_font_t *font) {
+  // The same font looking its glyphs up in the cmaps only
+  lv_font_fmt_txt_dsc_t cmaps_dsc = *(const lv_font_fmt_txt_dsc_t *)font->dsc;
+  cmaps_dsc.glyph_id_table = NULL;
+  cmaps_dsc.glyph_id_table_len = 0;
+  lv_font_t cmaps_font = *font;
+  cmaps_font.dsc = &cmaps_dsc;
+
+  // Interleaved, so a slow moment of the host hits all four alike
+  const lv_font_t *fonts[4] = {font, &cmaps_font, font, &cmaps_font};
+  const char **corpora[4] = {ascii, ascii, latin1, latin1};
+  double best[4] = {1e9, 1e9, 1e9, 1e9};
+  for (int r = 0; r < RUNS; r++) {
+    for (int k = 0; k < 4; k++) {
+      double ns = layout(fonts[k], corpora[k]);
+      if (ns < best[k])
+        best[k] = ns;
+    }
+  }
+
+  printf("%-14s %10.1f %10.1f %10.1f %10.1f\n", name, best[0], best[1],
+         best[2], best[3]);
+}
+
+int main(void) {
+  lv_init();
+  printf("ns per letter, best of %d\n", RUNS);
+  printf("%-14s %10s %10s %10s %10s\n", "", "ASCII", "ASCII", "Latin-1",
+         "Latin-1");
+  printf("%-14s %10s %10s %10s %10s\n", "", "table", "cmaps", "table",
+         "cmaps");
+  runFont("montserrat_12", &lv_font_montserrat_12);
+  runFont("montserrat_14", &lv_font_montserrat_14);
+  runFont("montserrat_28", &lv_font_montserrat_28);
+  return 0;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file      vlist_bench.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * A VirtualList of 10,000 messages laid out like the messenger's, every
+ * third one wrapping over several lines, scrolled from the first message to
+ * the last and back half a viewport per frame. Prints the frame time
+ * percentiles of each pass, the row objects alive and the LVGL heap used.
+ * Frame times and rows must not depend on the number of messages; the heap
+ * grows by the 2 byte height of each message.
+ *
+ *   vlist_bench [messages]
+ */
+#include <Arduino.h>
+#include <lvgl.h>
+
+extern "C" {
+#include "lauxlib.h"
+#include "lualib.h"
+#include "luavgl.h"
+}
+
+#include <algorithm>
+#include <vector>
+
+#define BENCH_MESSAGES 10000
+
+static const char *setup = R"(
+local count = ...
+local messages = {}
+for i = 1, count do
+  local text = "Message " .. i .. ": the quick brown fox"
+  if i % 3 == 0 then
+    text = text .. " jumps over the lazy dog, then runs around the field"
+        .. " twice and comes back for more, message " .. i .. " ends here"
+  end
+  messages[i] = text
+end
+list = lvgl.VirtualList {
+  border_width = 0,
+  h = 185,
+  w = lvgl.PCT(100),
+  pad_ver = 0,
+  pad_left = 10,
+  pad_right = 0,
+  pad_row = 12,
+  row_height = 28,
+  wrap = true,
+  bind = function(index, row)
+    binds = binds + 1
+    return messages[index]
+  end,
+}
+binds = 0
+list.count = count
+)";
+
+static uint32_t tick_ms = 0;
+static uint32_t tickCb() { return tick_ms; }
+
+static void flushCb(lv_display_t *disp, const lv_area_t *area,
+                    uint8_t *px_map) {
+  lv_display_flush_ready(disp);
+}
+
+static uint32_t countObjects(lv_obj_t *obj) {
+  uint32_t n = 1;
+  for (uint32_t i = 0; i < lv_obj_get_child_count(obj); i++)
+    n += countObjects(lv_obj_get_child(obj, i));
+  return n;
+}
+
+static lua_Integer luaGlobal(lua_State *L, const char *name) {
+  lua_getglobal(L, name);
+  lua_Integer value = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  return value;
+}
+
+// Scroll by dy per frame until the list stops moving, one frame rendered
+// after each step
+static void scrollPass(lua_State *L, lv_obj_t *list, int32_t dy,
+                       const char *name) {
+  std::vector<uint32_t> frames;
+  lua_Integer binds = luaGlobal(L, "binds");
+  uint32_t rows_max = 0;
+
+  for (;;) {
+    int32_t before = lv_obj_get_scroll_y(list);
+    tick_ms += LV_DEF_REFR_PERIOD;
+    uint32_t start = micros();
+    lv_obj_scroll_by_bounded(list, 0, -dy, LV_ANIM_OFF);
+    lv_refr_now(NULL);
+    frames.push_back(micros() - start);
+    rows_max = std::max(rows_max, lv_obj_get_child_count(list) - 1);
+    if (lv_obj_get_scroll_y(list) == before)
+      break;
+  }
+
+  std::sort(frames.begin(), frames.end());
+  size_t n = frames.size();
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  printf("%-6s %5zu frames, p50 %5u us, p99 %5u us, max %5u us, "
+         "%5lld binds, %2u rows, %2u objects, heap %zu B\n",
+         name, n, frames[n / 2], frames[n * 99 / 100], frames[n - 1],
+         (long long)(luaGlobal(L, "binds") - binds), rows_max,
+         countObjects(list), mon.total_size - mon.free_size);
+}
+
+int main(int argc, char **argv) {
+  int messages = argc > 1 ? atoi(argv[1]) : BENCH_MESSAGES;
+
+  lv_init();
+  lv_tick_set_cb(tickCb);
+  lv_display_t *disp = lv_display_create(320, 240);
+  static uint8_t buf[320 * 40 * 2];
+  lv_display_set_buffers(disp, buf, NULL, sizeof(buf),
+                         LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_set_flush_cb(disp, flushCb);
+
+  lv_obj_t *root = lv_obj_create(lv_screen_active());
+  lv_obj_set_size(root, LV_PCT(100), LV_PCT(100));
+  lua_State *L = luaL_newstate();
+  luaL_openlibs(L);
+  luavgl_set_root(L, root);
+  luaL_requiref(L, "lvgl", luaopen_lvgl, 1);
+  lua_pop(L, 1);
+
+  uint32_t start = micros();
+  if (luaL_loadstring(L, setup) != LUA_OK) {
+    fprintf(stderr, "setup: %s\n", lua_tostring(L, -1));
+    return 1;
+  }
+  lua_pushinteger(L, messages);
+  if (lua_pcall(L, 1, 0, 0) != LUA_OK) {
+    fprintf(stderr, "setup: %s\n", lua_tostring(L, -1));
+    return 1;
+  }
+  lv_refr_now(NULL);
+  printf("%d messages, filled and drawn in %u us\n", messages,
+         micros() - start);
+
+  lua_getglobal(L, "list");
+  lv_obj_t *list = luavgl_to_obj(L, -1);
+  lua_pop(L, 1);
+
+  int32_t step = lv_obj_get_content_height(list) / 2;
+  scrollPass(L, list, step, "down");
+  scrollPass(L, list, -step, "up");
+
+  lua_close(L);
+  lv_obj_delete(root);
+  return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file      Arduino.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * The part of the Arduino core used by the Lua runtime in /src, for the host
+ * simulator. millis() is the simulated clock, micros() the host clock, so UI
+ * timing is reproducible while measured durations are real.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+static inline bool psramFound() { return false; }
+
+// FreeRTOS queues, used to hand events to the main loop. The simulator has
+// a single thread, so they never block
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+typedef struct SimQueue *QueueHandle_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+
+QueueHandle_t xQueueCreate(uint32_t length, uint32_t item_size);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait);
+
+// FreeRTOS tasks of the input drivers. They run cooperatively on the
+// simulated clock (see simTasksRun() in sim.h): a task runs until it blocks
+// in ulTaskNotifyTake(), and ticks are milliseconds.
+typedef struct SimTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *param);
+typedef struct SimSemaphore *SemaphoreHandle_t;
+
+#define pdPASS 1
+#define portMAX_DELAY 0xffffffffu
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portYIELD_FROM_ISR()
+#define IRAM_ATTR
+#define ARDUINO_RUNNING_CORE 1
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name,
+                                   uint32_t stack_depth, void *param,
+                                   uint32_t priority, TaskHandle_t *task,
+                                   BaseType_t core);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+
+// Every task runs on the simulator's thread, so the mutexes never wait
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t wait);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex);
+
+// GPIO interrupts are raised by simInterrupt() in sim.h
+#define INPUT 0x01
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define digitalPinToInterrupt(pin) (pin)
+
+static inline void pinMode(uint8_t pin, uint8_t mode) {}
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+
+class String {
+public:
+  String(const char *s = "") : s_(s ? s : "") {}
+
+  String operator+(const char *s) const { return String((s_ + s).c_str()); }
+  String operator+(const String &s) const { return *this + s.c_str(); }
+  String &operator+=(const char *s) {
+    s_ += s;
+    return *this;
+  }
+  String &operator+=(char c) {
+    s_ += c;
+    return *this;
+  }
+  char operator[](unsigned i) const { return s_[i]; }
+
+  bool reserve(unsigned size) {
+    s_.reserve(size);
+    return true;
+  }
+  const char *c_str() const { return s_.c_str(); }
+  unsigned length() const { return s_.size(); }
+
+private:
+  std::string s_;
+};
+
+class HardwareSerial {
+public:
+  void begin(unsigned long baud) {}
+  void print(const char *s) { fputs(s, stdout); }
+  void print(const String &s) { print(s.c_str()); }
+  void print(unsigned long n) { printf("%lu", n); }
+  void println(const char *s = "") { puts(s); }
+  void println(const String &s) { println(s.c_str()); }
+  void println(unsigned long n) { printf("%lu\n", n); }
+  int printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
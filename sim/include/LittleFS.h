@@ -0,0 +1,52 @@
+/**
+ * @file      LittleFS.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * Host simulator: LittleFS paths are files below a host directory, a copy of
+ * /data made by the build.
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include <memory>
+
+class LittleFSFS;
+
+namespace fs {
+
+class File {
+public:
+  explicit operator bool() const { return (bool)f_; }
+
+  size_t size();
+  size_t read(uint8_t *buf, size_t size);
+  size_t write(const uint8_t *buf, size_t size);
+  void close() { f_.reset(); }
+
+private:
+  friend class ::LittleFSFS;
+  std::shared_ptr<FILE> f_;
+};
+
+} // namespace fs
+
+class LittleFSFS {
+public:
+  // Directory holding the filesystem root
+  void setRoot(const char *dir) { root_ = dir; }
+
+  bool begin(bool format_if_failed = false);
+  fs::File open(const char *path, const char *mode = "r");
+  bool exists(const char *path);
+  bool remove(const char *path);
+
+private:
+  std::string hostPath(const char *path) const { return root_ + path; }
+  std::string root_ = ".";
+};
+
+extern LittleFSFS LittleFS;
@@ -0,0 +1,24 @@
+/**
+ * @file      TouchDrvGT911.hpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * Host simulator: the part of the SensorsLib GT911 driver used by
+ * touch_input.cpp. The panel behind it is implemented by the test using it.
+ */
+#pragma once
+
+#include <Arduino.h>
+
+class TouchDrvGT911 {
+public:
+  uint8_t getSupportTouchPoint() { return 5; }
+
+  // Points of the last report, 0 once they have been read
+  uint8_t getPoint(int16_t *x_array, int16_t *y_array, uint8_t size = 1);
+
+  // Trigger mode of the INT line, 0x00 rising, 0x01 falling
+  uint8_t getInterruptMode();
+};
@@ -0,0 +1,31 @@
+/**
+ * @file      Wire.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * Host simulator: reads are answered by the device set with
+ * simWireSetReader(), writes are dropped.
+ */
+#pragma once
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+  uint8_t requestFrom(uint8_t address, size_t size);
+  int available() { return (int)(size_ - pos_); }
+  int read() { return pos_ < size_ ? buf_[pos_++] : -1; }
+
+  void beginTransmission(uint8_t address) {}
+  size_t write(uint8_t value) { return 1; }
+  uint8_t endTransmission() { return 0; }
+
+private:
+  uint8_t buf_[32];
+  size_t size_ = 0;
+  size_t pos_ = 0;
+};
+
+extern TwoWire Wire;
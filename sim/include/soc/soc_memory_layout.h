@@ -0,0 +1,12 @@
+/**
+ * @file      soc_memory_layout.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * Host simulator: there is no PSRAM.
+ */
+#pragma once
+
+static inline bool esp_ptr_external_ram(const void *p) { return false; }
@@ -0,0 +1,103 @@
+/**
+ * @file      png.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "png.h"
+
+#include <stdio.h>
+#include <vector>
+
+// Snapshots are small, so the image data goes in stored deflate blocks and
+// no zlib is needed
+#define DEFLATE_BLOCK_MAX 65535
+
+static uint32_t crc_table[256];
+
+static uint32_t crc32(uint32_t crc, const uint8_t *p, size_t len) {
+  if (!crc_table[1]) {
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; k++)
+        c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+      crc_table[n] = c;
+    }
+  }
+
+  crc = ~crc;
+  while (len--)
+    crc = crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+static void put32(std::vector<uint8_t> &out, uint32_t v) {
+  out.push_back(v >> 24);
+  out.push_back(v >> 16);
+  out.push_back(v >> 8);
+  out.push_back(v);
+}
+
+static void chunk(std::vector<uint8_t> &out, const char *type,
+                  const std::vector<uint8_t> &data) {
+  put32(out, data.size());
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  put32(out, crc32(0, &out[start], out.size() - start));
+}
+
+bool pngWrite(const char *path, const uint16_t *pixels, int width,
+              int height) {
+  // Scanlines with filter type 0, RGB565 widened to RGB888
+  std::vector<uint8_t> raw;
+  raw.reserve((size_t)height * (width * 3 + 1));
+  for (int y = 0; y < height; y++) {
+    raw.push_back(0);
+    for (int x = 0; x < width; x++) {
+      uint16_t c = pixels[y * width + x];
+      uint8_t r = (c >> 11) & 0x1f, g = (c >> 5) & 0x3f, b = c & 0x1f;
+      raw.push_back((r << 3) | (r >> 2));
+      raw.push_back((g << 2) | (g >> 4));
+      raw.push_back((b << 3) | (b >> 2));
+    }
+  }
+
+  std::vector<uint8_t> z = {0x78, 0x01};
+  for (size_t pos = 0; pos < raw.size(); pos += DEFLATE_BLOCK_MAX) {
+    size_t len = raw.size() - pos;
+    if (len > DEFLATE_BLOCK_MAX)
+      len = DEFLATE_BLOCK_MAX;
+    z.push_back(pos + len == raw.size()); // BFINAL, stored
+    z.push_back(len);
+    z.push_back(len >> 8);
+    z.push_back(~len);
+    z.push_back(~len >> 8);
+    z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + len);
+  }
+
+  uint32_t a = 1, b = 0;
+  for (uint8_t v : raw) {
+    a = (a + v) % 65521;
+    b = (b + a) % 65521;
+  }
+  put32(z, (b << 16) | a);
+
+  std::vector<uint8_t> ihdr;
+  put32(ihdr, width);
+  put32(ihdr, height);
+  ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0}); // 8 bit RGB
+
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  chunk(png, "IHDR", ihdr);
+  chunk(png, "IDAT", z);
+  chunk(png, "IEND", {});
+
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  bool ok = fwrite(png.data(), 1, png.size(), f) == png.size();
+  return fclose(f) == 0 && ok;
+}
@@ -0,0 +1,14 @@
+/**
+ * @file      png.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+// Write an RGB565 image as an uncompressed 24 bit PNG
+bool pngWrite(const char *path, const uint16_t *pixels, int width, int height);
@@ -0,0 +1,536 @@
+/**
+ * @file      sim.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * Headless simulator: runs the Lua apps from /data with the firmware's LVGL
+ * configuration on a 320x240 RGB565 framebuffer, driven by a script of touch
+ * and keyboard input.
+ */
+#include "lua_alloc.h"
+#include "lua_app.h"
+#include "lua_async.h"
+#include "lua_gc.h"
+#include "lua_loader.h"
+#include "png.h"
+#include "scheduler.h"
+#include "sim.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <lvgl.h>
+
+extern "C" {
+#include "lauxlib.h"
+}
+
+#include <deque>
+#include <getopt.h>
+#include <string>
+
+#define SIM_WIDTH 320
+#define SIM_HEIGHT 240
+
+// Same partial strips as the DISPLAY_DMA_FLUSH backend
+#define SIM_BUF_LINES 40
+
+// Panel model: the ST7789 of the T-Deck on its 40 MHz SPI bus, RGB565
+#define SIM_SPI_HZ 40000000
+#define SIM_SPI_BITS_PER_PX 16
+
+// Time between two pointer reads of a drag
+#define SIM_DRAG_STEP_MS 10
+
+// Simulated time run without a script
+#define SIM_DEFAULT_RUN_MS 3000
+
+#ifndef SIM_FS_DIR
+#define SIM_FS_DIR "fs"
+#endif
+
+bool fs_mounted = false;
+
+// Input arrives from the script, not from a task
+void schedulerWake() {}
+
+struct FrameStats {
+  uint32_t frames;       // refreshed frames
+  uint64_t render_us;    // host time spent refreshing them
+  uint32_t max_render_us;
+  uint64_t pixels;       // pixels flushed
+  uint32_t areas;        // areas flushed
+  uint64_t panel_us;     // modeled time until the panel shows the frames
+  uint32_t max_panel_us;
+};
+
+// Modeled SPI transfers of the frame being refreshed
+struct PanelModel {
+  uint32_t strips;      // strips flushed
+  uint32_t render_end;  // us from the frame start until the last render ended
+  uint32_t tx_end[2];   // us until the transfer out of each buffer ended
+};
+
+struct KeyEvent {
+  uint32_t key;
+  bool pressed;
+};
+
+static uint16_t framebuffer[SIM_WIDTH * SIM_HEIGHT];
+static FrameStats frame_stats = {};
+static uint32_t refr_start = 0;
+static uint32_t strip_start = 0;
+static uint32_t pending_areas = 0;
+static PanelModel panel = {};
+
+// -m full: one full-screen buffer with blocking writes, like
+// DISPLAY_DMA_FLUSH=0, instead of two DMA strips
+static bool full_frame = false;
+
+// -r: host render times are multiplied by this for the panel model
+static double render_scale = 1.0;
+
+// -g: glyph cache budget in KB instead of LV_GLYPH_CACHE_SIZE, 0 disables it
+static int32_t glyph_cache_kb = -1;
+
+static lv_indev_t *touch_indev = NULL;
+static lv_indev_t *kb_indev = NULL;
+static lv_point_t touch_point = {0, 0};
+static bool touch_pressed = false;
+static bool touch_changed = false;
+static std::deque<KeyEvent> keys;
+static KeyEvent key_last = {0, false};
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area,
+                     uint8_t *px_map) {
+  uint32_t render_us = (uint32_t)((micros() - strip_start) * render_scale);
+  uint32_t spi_us = (uint32_t)((uint64_t)lv_area_get_size(area) *
+                               SIM_SPI_BITS_PER_PX * 1000000 / SIM_SPI_HZ);
+  if (full_frame) {
+    // The whole frame is rendered, then sent while LVGL waits
+    panel.render_end += render_us + spi_us;
+    panel.tx_end[0] = panel.render_end;
+  } else {
+    // A strip is rendered once its buffer has been sent, and sent once the
+    // bus is done with the other buffer
+    uint32_t *own = &panel.tx_end[panel.strips % 2];
+    uint32_t other = panel.tx_end[(panel.strips + 1) % 2];
+    panel.render_end = LV_MAX(panel.render_end, *own) + render_us;
+    *own = LV_MAX(panel.render_end, other) + spi_us;
+  }
+  panel.strips++;
+
+  int32_t w = lv_area_get_width(area);
+  const uint16_t *src = (const uint16_t *)px_map;
+  for (int32_t y = area->y1; y <= area->y2; y++) {
+    uint16_t *dst = &framebuffer[y * SIM_WIDTH + area->x1];
+    for (int32_t x = 0; x < w; x++) {
+#if LV_COLOR_16_SWAP
+      // Swapped for the panel by LVGL before the flush
+      dst[x] = (uint16_t)((src[x] << 8) | (src[x] >> 8));
+#else
+      dst[x] = src[x];
+#endif
+    }
+    src += w;
+  }
+
+  frame_stats.pixels += lv_area_get_size(area);
+  frame_stats.areas++;
+  pending_areas++;
+  lv_display_flush_ready(disp);
+  strip_start = micros();
+}
+
+static void refr_start_cb(lv_event_t *e) {
+  refr_start = micros();
+  strip_start = refr_start;
+  pending_areas = 0;
+  panel = {};
+}
+
+static void refr_ready_cb(lv_event_t *e) {
+  if (pending_areas == 0)
+    return;
+
+  uint32_t us = micros() - refr_start;
+  frame_stats.frames++;
+  frame_stats.render_us += us;
+  if (us > frame_stats.max_render_us)
+    frame_stats.max_render_us = us;
+
+  uint32_t panel_us = LV_MAX(panel.tx_end[0], panel.tx_end[1]);
+  frame_stats.panel_us += panel_us;
+  if (panel_us > frame_stats.max_panel_us)
+    frame_stats.max_panel_us = panel_us;
+}
+
+static void touchpad_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+  data->point = touch_point;
+  data->state = touch_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+static void keyboard_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+  data->key = key_last.key;
+  data->state = key_last.pressed ? LV_INDEV_STATE_PRESSED
+                                 : LV_INDEV_STATE_RELEASED;
+}
+
+static void setupLvgl() {
+  lv_init();
+  lv_glyph_cache_set_allocator(
+      [](size_t size) { return heap_caps_malloc(size, MALLOC_CAP_SPIRAM); },
+      heap_caps_free);
+  if (glyph_cache_kb >= 0)
+    lv_glyph_cache_resize(glyph_cache_kb * 1024, true);
+  lv_tick_set_cb(millis);
+
+  lv_group_t *default_group = lv_group_create();
+  lv_group_set_default(default_group);
+
+  lv_display_t *disp = lv_display_create(SIM_WIDTH, SIM_HEIGHT);
+
+  if (full_frame) {
+    static uint8_t buf[SIM_WIDTH * SIM_HEIGHT * 2];
+    lv_display_set_buffers(disp, buf, NULL, sizeof(buf),
+                           LV_DISPLAY_RENDER_MODE_FULL);
+  } else {
+    static uint8_t buf1[SIM_WIDTH * SIM_BUF_LINES * 2];
+    static uint8_t buf2[SIM_WIDTH * SIM_BUF_LINES * 2];
+    lv_display_set_buffers(disp, buf1, buf2, sizeof(buf1),
+                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+  }
+  lv_display_set_flush_cb(disp, flush_cb);
+  lv_display_add_event_cb(disp, refr_start_cb, LV_EVENT_REFR_START, NULL);
+  lv_display_add_event_cb(disp, refr_ready_cb, LV_EVENT_REFR_READY, NULL);
+
+  // Read on demand from the loop, like the firmware's input tasks
+  touch_indev = lv_indev_create();
+  lv_indev_set_type(touch_indev, LV_INDEV_TYPE_POINTER);
+  lv_indev_set_read_cb(touch_indev, touchpad_read_cb);
+  lv_indev_set_display(touch_indev, disp);
+  lv_indev_set_mode(touch_indev, LV_INDEV_MODE_EVENT);
+
+  kb_indev = lv_indev_create();
+  lv_indev_set_type(kb_indev, LV_INDEV_TYPE_KEYPAD);
+  lv_indev_set_read_cb(kb_indev, keyboard_read_cb);
+  lv_indev_set_mode(kb_indev, LV_INDEV_MODE_EVENT);
+  lv_indev_set_long_press_time(kb_indev, UINT16_MAX);
+  lv_indev_set_group(kb_indev, default_group);
+}
+
+static bool touch_active() {
+  return lv_indev_get_state(touch_indev) == LV_INDEV_STATE_PRESSED ||
+         lv_indev_get_scroll_obj(touch_indev) != NULL;
+}
+
+static void read_input_devices() {
+  if (touch_changed || touch_active()) {
+    touch_changed = false;
+    lv_indev_read(touch_indev);
+  }
+
+  while (!keys.empty()) {
+    key_last = keys.front();
+    keys.pop_front();
+    lv_indev_read(kb_indev);
+  }
+}
+
+// One iteration of the firmware's loop(), returns the ms it would sleep
+static uint32_t loopOnce() {
+  lv_lock();
+
+  read_input_devices();
+
+  luaAppPoll();
+  lua_State *L = luaAppState();
+
+  uint32_t async_ms = luaAsyncPoll(L);
+
+  uint32_t frame_start = micros();
+  uint32_t idle_ms = lv_timer_handler();
+  luaGcFrameTime(micros() - frame_start);
+
+  bool busy = touch_active();
+  if (busy && idle_ms > LV_DEF_REFR_PERIOD) {
+    idle_ms = LV_DEF_REFR_PERIOD;
+  }
+  if (idle_ms > async_ms) {
+    idle_ms = async_ms;
+  }
+  if (idle_ms > LOOP_MAX_SLEEP_MS) {
+    idle_ms = LOOP_MAX_SLEEP_MS;
+  }
+
+  // Collector steps take host time, the simulated clock is not charged
+  luaGcSetBusy(L, busy);
+  if (!busy && idle_ms > 0) {
+    luaGcIdle(L, idle_ms * 1000);
+  }
+
+  lv_unlock();
+  return idle_ms;
+}
+
+// Run the loop for ms of simulated time, skipping the idle time in between
+static void run(uint32_t ms) {
+  uint32_t end = sim_millis + ms;
+  loopOnce();
+  while ((int32_t)(end - sim_millis) > 0) {
+    uint32_t idle_ms = loopOnce();
+    uint32_t left = end - sim_millis;
+    sim_millis += idle_ms == 0 ? 1 : (idle_ms < left ? idle_ms : left);
+  }
+}
+
+static void touch(bool pressed, int32_t x, int32_t y) {
+  touch_pressed = pressed;
+  touch_point.x = x;
+  touch_point.y = y;
+  touch_changed = true;
+  loopOnce();
+}
+
+static void key(uint32_t code) {
+  keys.push_back({code, true});
+  keys.push_back({code, false});
+  loopOnce();
+}
+
+static bool keyByName(const char *name, uint32_t *code) {
+  static const struct {
+    const char *name;
+    uint32_t code;
+  } names[] = {
+      {"enter", LV_KEY_ENTER}, {"esc", LV_KEY_ESC},
+      {"backspace", LV_KEY_BACKSPACE}, {"tab", LV_KEY_NEXT},
+      {"next", LV_KEY_NEXT}, {"prev", LV_KEY_PREV},
+      {"up", LV_KEY_UP}, {"down", LV_KEY_DOWN},
+      {"left", LV_KEY_LEFT}, {"right", LV_KEY_RIGHT},
+  };
+
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    if (strcmp(name, names[i].name) == 0) {
+      *code = names[i].code;
+      return true;
+    }
+  }
+
+  if (strlen(name) == 1) {
+    *code = (uint8_t)name[0];
+    return true;
+  }
+  return false;
+}
+
+static void printStats() {
+  const FrameStats &f = frame_stats;
+  printf("Time: %lu ms simulated\n", (unsigned long)sim_millis);
+  printf("Frames: %lu, render avg %lu us, max %lu us, draw units: %d\n",
+         (unsigned long)f.frames,
+         (unsigned long)(f.frames ? f.render_us / f.frames : 0),
+         (unsigned long)f.max_render_us, LV_DRAW_SW_DRAW_UNIT_CNT);
+  printf("Flushed: %llu px in %lu areas, %lu px per frame\n",
+         (unsigned long long)f.pixels, (unsigned long)f.areas,
+         (unsigned long)(f.frames ? f.pixels / f.frames : 0));
+  printf("Panel model: %lu us avg, %lu us max per frame (%s, SPI %d MHz, "
+         "render x%.1f)\n",
+         (unsigned long)(f.frames ? f.panel_us / f.frames : 0),
+         (unsigned long)f.max_panel_us,
+         full_frame ? "full frame, blocking" : "partial strips, DMA",
+         SIM_SPI_HZ / 1000000, render_scale);
+
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  printf("LVGL heap: %lu/%lu KB used, peak %lu KB, frag %u%%\n",
+         (unsigned long)((mon.total_size - mon.free_size) / 1024),
+         (unsigned long)(mon.total_size / 1024),
+         (unsigned long)(mon.max_used / 1024), mon.frag_pct);
+
+  lv_glyph_cache_stats_t glyphs;
+  lv_glyph_cache_get_stats(&glyphs);
+  printf("Glyph cache: %lu hits, %lu misses, %lu evictions, %lu/%lu KB\n",
+         (unsigned long)glyphs.hits, (unsigned long)glyphs.misses,
+         (unsigned long)glyphs.evictions, (unsigned long)(glyphs.size / 1024),
+         (unsigned long)(glyphs.max_size / 1024));
+
+  const LuaAppStats &app = luaAppStats();
+  printf("Lua heap: %lu KB, peak %lu KB (app %s, open %lu us)\n",
+         (unsigned long)(app.heap_bytes / 1024),
+         (unsigned long)(app.peak_bytes / 1024), luaAppName(),
+         (unsigned long)app.open_us);
+
+  const LuaGcStats &gc = luaGcStats();
+  printf("Lua GC: %lu steps, p50 %lu us, p99 %lu us, max %lu us, "
+         "%lu deferred\n",
+         (unsigned long)gc.steps.count,
+         (unsigned long)luaGcPercentile(gc.steps, 50),
+         (unsigned long)luaGcPercentile(gc.steps, 99),
+         (unsigned long)gc.steps.max_us, (unsigned long)gc.deferred);
+  printf("Timer handler: p50 %lu us, p99 %lu us, max %lu us\n",
+         (unsigned long)luaGcPercentile(gc.frames, 50),
+         (unsigned long)luaGcPercentile(gc.frames, 99),
+         (unsigned long)gc.frames.max_us);
+}
+
+static bool runLua(const char *code) {
+  lua_State *L = luaAppState();
+  if (!L)
+    return false;
+  if (luaL_dostring(L, code) != LUA_OK) {
+    fprintf(stderr, "lua: %s\n", lua_tostring(L, -1));
+    lua_pop(L, 1);
+    return false;
+  }
+  lua_settop(L, 0);
+  return true;
+}
+
+// Run one script line, false on errors
+static bool command(char *line) {
+  char *cmd = strtok(line, " \t\r\n");
+  if (!cmd || cmd[0] == '#')
+    return true;
+
+  char *rest = strtok(NULL, "\r\n");
+  int a[5] = {0};
+  int n = rest ? sscanf(rest, "%d %d %d %d %d", &a[0], &a[1], &a[2], &a[3],
+                        &a[4])
+               : 0;
+
+  if (!strcmp(cmd, "wait") && n == 1) {
+    run(a[0]);
+  } else if (!strcmp(cmd, "press") && n == 2) {
+    touch(true, a[0], a[1]);
+  } else if (!strcmp(cmd, "move") && n == 2) {
+    touch(true, a[0], a[1]);
+  } else if (!strcmp(cmd, "release")) {
+    touch(false, touch_point.x, touch_point.y);
+  } else if (!strcmp(cmd, "tap") && n == 2) {
+    touch(true, a[0], a[1]);
+    run(50);
+    touch(false, a[0], a[1]);
+  } else if (!strcmp(cmd, "drag") && n == 5) {
+    // drag x0 y0 x1 y1 ms
+    int steps = a[4] / SIM_DRAG_STEP_MS;
+    touch(true, a[0], a[1]);
+    for (int i = 1; i <= steps; i++) {
+      run(SIM_DRAG_STEP_MS);
+      touch(true, a[0] + (a[2] - a[0]) * i / steps,
+            a[1] + (a[3] - a[1]) * i / steps);
+    }
+    touch(false, a[2], a[3]);
+  } else if (!strcmp(cmd, "type") && rest) {
+    for (const char *c = rest; *c; c++) {
+      key((uint8_t)*c);
+    }
+  } else if (!strcmp(cmd, "key") && rest) {
+    uint32_t code;
+    if (!keyByName(strtok(rest, " \t"), &code))
+      return false;
+    key(code);
+  } else if (!strcmp(cmd, "snap") && rest) {
+    lv_refr_now(NULL);
+    if (!pngWrite(rest, framebuffer, SIM_WIDTH, SIM_HEIGHT)) {
+      fprintf(stderr, "snap: cannot write %s\n", rest);
+      return false;
+    }
+  } else if (!strcmp(cmd, "open") && rest) {
+    return luaAppOpen(rest);
+  } else if (!strcmp(cmd, "lua") && rest) {
+    return runLua(rest);
+  } else if (!strcmp(cmd, "stats")) {
+    printStats();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static int runScript(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return 1;
+  }
+
+  char line[256];
+  int lineno = 0;
+  int status = 0;
+  while (status == 0 && fgets(line, sizeof(line), f)) {
+    lineno++;
+    if (!command(line)) {
+      fprintf(stderr, "%s:%d: command failed\n", path, lineno);
+      status = 1;
+    }
+  }
+  fclose(f);
+  return status;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [-f fs_dir] [-a app] [-m partial|full] [-r scale] "
+          "[-g kb] [script]\n"
+          "  -f  directory holding the filesystem, default " SIM_FS_DIR "\n"
+          "  -a  app opened at start, default " LUA_APP_HOME "\n"
+          "  -m  display buffers: two DMA strips (default) or one full "
+          "frame\n"
+          "  -r  factor applied to host render times in the panel model\n"
+          "  -g  glyph cache budget in KB, 0 disables the cache\n"
+          "Without a script the app runs for %d ms.\n",
+          prog, SIM_DEFAULT_RUN_MS);
+}
+
+int main(int argc, char **argv) {
+  const char *fs_dir = SIM_FS_DIR;
+  const char *app = LUA_APP_HOME;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "f:a:m:r:g:h")) != -1) {
+    switch (opt) {
+    case 'f':
+      fs_dir = optarg;
+      break;
+    case 'a':
+      app = optarg;
+      break;
+    case 'm':
+      if (strcmp(optarg, "full") && strcmp(optarg, "partial")) {
+        usage(argv[0]);
+        return 2;
+      }
+      full_frame = !strcmp(optarg, "full");
+      break;
+    case 'r':
+      render_scale = atof(optarg);
+      break;
+    case 'g':
+      glyph_cache_kb = atoi(optarg);
+      break;
+    default:
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  LittleFS.setRoot(fs_dir);
+  fs_mounted = LittleFS.begin(false);
+  if (!fs_mounted)
+    fprintf(stderr, "No filesystem at %s\n", fs_dir);
+
+  setupLvgl();
+  luaAppOpen(app);
+
+  int status = 0;
+  if (optind < argc) {
+    status = runScript(argv[optind]);
+  } else {
+    run(SIM_DEFAULT_RUN_MS);
+  }
+
+  printStats();
+  return status;
+}
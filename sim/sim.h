@@ -0,0 +1,28 @@
+/**
+ * @file      sim.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <stdint.h>
+
+// Simulated time in ms, returned by millis() and advanced by the main loop
+// instead of sleeping
+extern uint32_t sim_millis;
+
+// Run the FreeRTOS tasks for ms of simulated time. Tasks run whenever they
+// are notified or their wait times out; the clock then jumps to the next
+// timeout.
+void simTasksRun(uint32_t ms);
+
+// Call the handler attached to pin, as the GPIO interrupt would
+void simInterrupt(uint8_t pin);
+
+// Device answering Wire.requestFrom(): returns the next byte read from the
+// device at address, or -1 if it does not answer
+typedef int (*SimWireReader)(uint8_t address);
+void simWireSetReader(SimWireReader reader);
@@ -0,0 +1,146 @@
+/**
+ * @file      tasks.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * FreeRTOS tasks, notifications and GPIO interrupts for the host simulator.
+ * Tasks are coroutines switched on the simulator's thread, so a run only
+ * depends on the simulated clock and gives the same result every time.
+ */
+#include "sim.h"
+#include <Arduino.h>
+
+#include <ucontext.h>
+#include <vector>
+
+// Host stack of every task, the device sizes are too small for the host
+#define SIM_TASK_STACK (256 * 1024)
+
+#define SIM_GPIO_COUNT 64
+
+struct SimTask {
+  ucontext_t ctx;
+  TaskFunction_t fn;
+  void *param;
+  std::vector<uint8_t> stack;
+  uint32_t notified;  // pending notifications
+  bool blocked;       // waiting in ulTaskNotifyTake()
+  uint64_t wake_at;   // simulated ms the wait times out, UINT64_MAX for never
+};
+
+static std::vector<SimTask *> tasks;
+static SimTask *current = NULL;
+static ucontext_t scheduler_ctx;
+static void (*gpio_isr[SIM_GPIO_COUNT])() = {};
+
+static void taskEntry() {
+  current->fn(current->param);
+  // FreeRTOS tasks never return, park one that does
+  current->blocked = true;
+  current->wake_at = UINT64_MAX;
+  swapcontext(&current->ctx, &scheduler_ctx);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name,
+                                   uint32_t stack_depth, void *param,
+                                   uint32_t priority, TaskHandle_t *task,
+                                   BaseType_t core) {
+  SimTask *t = new SimTask();
+  t->fn = fn;
+  t->param = param;
+  t->stack.resize(SIM_TASK_STACK);
+
+  getcontext(&t->ctx);
+  t->ctx.uc_stack.ss_sp = t->stack.data();
+  t->ctx.uc_stack.ss_size = t->stack.size();
+  t->ctx.uc_link = NULL;
+  makecontext(&t->ctx, taskEntry, 0);
+
+  tasks.push_back(t);
+  if (task)
+    *task = t;
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait) {
+  SimTask *t = current;
+  if (!t->notified && wait) {
+    t->blocked = true;
+    t->wake_at = wait == portMAX_DELAY ? UINT64_MAX : (uint64_t)sim_millis + wait;
+    swapcontext(&t->ctx, &scheduler_ctx);
+  }
+
+  uint32_t count = t->notified;
+  if (clear)
+    t->notified = 0;
+  else if (count)
+    t->notified--;
+  return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  task->notified++;
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken) {
+  task->notified++;
+  if (woken)
+    *woken = pdTRUE;
+}
+
+static bool ready(const SimTask *t) {
+  return !t->blocked || t->notified || t->wake_at <= sim_millis;
+}
+
+void simTasksRun(uint32_t ms) {
+  uint64_t end = (uint64_t)sim_millis + ms;
+  for (;;) {
+    // Run every task that can run at this time until all of them block
+    bool ran = false;
+    for (SimTask *t : tasks) {
+      if (!ready(t))
+        continue;
+      t->blocked = false;
+      current = t;
+      swapcontext(&scheduler_ctx, &t->ctx);
+      current = NULL;
+      ran = true;
+    }
+    if (ran)
+      continue;
+
+    uint64_t next = end;
+    for (SimTask *t : tasks) {
+      if (t->wake_at < next)
+        next = t->wake_at;
+    }
+    if (sim_millis >= end)
+      break;
+    sim_millis = (uint32_t)next;
+  }
+}
+
+struct SimSemaphore {};
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+  return new SimSemaphore();
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t wait) {
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex) { return pdTRUE; }
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+  if (pin < SIM_GPIO_COUNT)
+    gpio_isr[pin] = isr;
+}
+
+void simInterrupt(uint8_t pin) {
+  if (pin < SIM_GPIO_COUNT && gpio_isr[pin])
+    gpio_isr[pin]();
+}
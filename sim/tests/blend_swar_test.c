@@ -0,0 +1,173 @@
+/**
+ * @file      blend_swar_test.c
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * The SWAR blend backend against LVGL's scalar RGB565 blending, built a
+ * second time without the backend: random fills and images with odd offsets,
+ * strides, masks and opacities must give the same bytes.
+ *
+ *   blend_swar_test [iterations]
+ */
+#include "test.h"
+#include <lvgl.h>
+#include <src/draw/sw/blend/lv_draw_sw_blend_private.h>
+#include <src/draw/sw/blend/lv_draw_sw_blend_to_rgb565.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+// lv_draw_sw_blend_to_rgb565.c built with LV_DRAW_SW_ASM_NONE
+void ref_blend_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t *dsc);
+void ref_blend_image_to_rgb565(lv_draw_sw_blend_image_dsc_t *dsc);
+
+#define BUF_BYTES 16384
+
+static uint8_t dest_swar[BUF_BYTES];
+static uint8_t dest_ref[BUF_BYTES];
+static uint8_t src[BUF_BYTES * 2];
+static uint8_t mask[BUF_BYTES];
+
+static uint32_t lcg = 1;
+static uint32_t rnd(void) {
+  lcg = lcg * 1103515245 + 12345;
+  return lcg >> 8;
+}
+
+// Mostly the 0 and 255 opacities the backend takes shortcuts for
+static uint8_t rndOpa(void) {
+  switch (rnd() % 5) {
+  case 0:
+    return 0;
+  case 1:
+    return 255;
+  default:
+    return (uint8_t)rnd();
+  }
+}
+
+// Runs of equal mask values, like the coverage of glyphs and edges
+static void fillMask(uint8_t *m, int n) {
+  int i = 0;
+  while (i < n) {
+    int run = 1 + rnd() % 9;
+    uint8_t v = rndOpa();
+    while (run-- && i < n)
+      m[i++] = rnd() % 4 ? v : (uint8_t)rnd();
+  }
+}
+
+// A random or a flat background, the backend reuses results on the latter
+static void fillDest(int flat) {
+  for (int i = 0; i < BUF_BYTES; i++)
+    dest_swar[i] = (uint8_t)rnd();
+  if (flat) {
+    for (int i = 2; i < BUF_BYTES; i += 2) {
+      dest_swar[i] = dest_swar[0];
+      dest_swar[i + 1] = dest_swar[1];
+    }
+  }
+  memcpy(dest_ref, dest_swar, BUF_BYTES);
+}
+
+static const char *format_names[] = {"fill", "RGB565", "RGB888", "XRGB8888",
+                                     "ARGB8888"};
+static const lv_color_format_t formats[] = {
+    LV_COLOR_FORMAT_RGB565, LV_COLOR_FORMAT_RGB888, LV_COLOR_FORMAT_XRGB8888,
+    LV_COLOR_FORMAT_ARGB8888};
+
+int main(int argc, char **argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+  int cases[5] = {0};
+  int reported = 0;
+
+  lv_init();
+
+  for (int it = 0; it < iterations; it++) {
+    int w = 1 + rnd() % 40;
+    int h = 1 + rnd() % 6;
+    int offset = rnd() % 4;
+    int dest_stride = (w + offset + rnd() % 5) * 2;
+    int mask_stride = w + rnd() % 5;
+    int mask_offset = rnd() % 4;
+    int use_mask = rnd() % 2;
+    lv_opa_t opa = rnd() % 3 ? rndOpa() : 255;
+    int kind;
+
+    fillDest(rnd() % 3 == 0);
+    fillMask(mask, BUF_BYTES);
+
+    if (rnd() % 3 == 0) {
+      lv_draw_sw_blend_fill_dsc_t d;
+      memset(&d, 0, sizeof(d));
+      d.dest_buf = dest_swar + offset * 2;
+      d.dest_w = w;
+      d.dest_h = h;
+      d.dest_stride = dest_stride;
+      d.mask_buf = use_mask ? mask + mask_offset : NULL;
+      d.mask_stride = mask_stride;
+      d.color = lv_color_hex(rnd());
+      d.opa = opa;
+
+      lv_draw_sw_blend_fill_dsc_t r = d;
+      r.dest_buf = dest_ref + offset * 2;
+      lv_draw_sw_blend_color_to_rgb565(&d);
+      ref_blend_color_to_rgb565(&r);
+      kind = 0;
+    } else {
+      int f = rnd() % 4;
+      int px_size = lv_color_format_get_size(formats[f]);
+      for (int i = 0; i < BUF_BYTES * 2; i++)
+        src[i] = (uint8_t)rnd();
+      if (formats[f] == LV_COLOR_FORMAT_ARGB8888) {
+        for (int i = 3; i < BUF_BYTES * 2; i += 4)
+          src[i] = rndOpa();
+      }
+
+      lv_draw_sw_blend_image_dsc_t d;
+      memset(&d, 0, sizeof(d));
+      d.dest_buf = dest_swar + offset * 2;
+      d.dest_w = w;
+      d.dest_h = h;
+      d.dest_stride = dest_stride;
+      d.mask_buf = use_mask ? mask + mask_offset : NULL;
+      d.mask_stride = mask_stride;
+      // RGB565 sources also start on odd pixels
+      d.src_buf = src + (f == 0 ? 2 * (rnd() % 2) : 0);
+      d.src_stride = (w + rnd() % 3) * px_size;
+      d.src_color_format = formats[f];
+      d.opa = opa;
+      d.blend_mode = LV_BLEND_MODE_NORMAL;
+
+      lv_draw_sw_blend_image_dsc_t r = d;
+      r.dest_buf = dest_ref + offset * 2;
+      lv_draw_sw_blend_image_to_rgb565(&d);
+      ref_blend_image_to_rgb565(&r);
+      kind = 1 + f;
+    }
+    cases[kind]++;
+
+    if (memcmp(dest_swar, dest_ref, BUF_BYTES) == 0)
+      continue;
+    test_failures++;
+    for (int i = 0; i < BUF_BYTES && reported < 5; i += 2) {
+      if (memcmp(dest_swar + i, dest_ref + i, 2)) {
+        fprintf(stderr,
+                "%d: %s %dx%d at pixel %d, mask %d, opa %d: byte %d is "
+                "%02x%02x, scalar %02x%02x\n",
+                it, format_names[kind], w, h, offset, use_mask, opa, i,
+                dest_swar[i + 1], dest_swar[i], dest_ref[i + 1], dest_ref[i]);
+        reported++;
+        break;
+      }
+    }
+  }
+
+  printf("%d cases:", iterations);
+  for (int k = 0; k < 5; k++)
+    printf(" %s %d", format_names[k], cases[k]);
+  printf("\n");
+  return testResult("blend_swar_test");
+}
@@ -0,0 +1,56 @@
+/**
+ * @file      glyph_id_table_test.c
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * The glyph_id_table of the Montserrat fonts against their cmaps: every code
+ * point up to U+FFFF, followed by the letters that are kerned with it, must
+ * give the same glyph and kerned advance with and without the table.
+ */
+#include "test.h"
+#include <lvgl.h>
+
+static void checkFont(const char *name, const lv_font_t *font) {
+  const lv_font_fmt_txt_dsc_t *dsc = font->dsc;
+  CHECK(dsc->glyph_id_table != NULL);
+
+  // The same font looking its glyphs up in the cmaps only
+  lv_font_fmt_txt_dsc_t cmaps_dsc = *dsc;
+  cmaps_dsc.glyph_id_table = NULL;
+  cmaps_dsc.glyph_id_table_len = 0;
+  lv_font_t cmaps_font = *font;
+  cmaps_font.dsc = &cmaps_dsc;
+
+  int reported = 0;
+  for (uint32_t letter = 0; letter < 0x10000; letter++) {
+    // All pairs within the table, a letter past its end otherwise
+    uint32_t step = letter < 0x200 ? 1 : 0x1ff;
+    for (uint32_t next = 0; next < 0x200; next += step) {
+      lv_font_glyph_dsc_t a = {0}, b = {0};
+      bool found_a = lv_font_get_glyph_dsc_fmt_txt(font, &a, letter, next);
+      bool found_b =
+          lv_font_get_glyph_dsc_fmt_txt(&cmaps_font, &b, letter, next);
+      if (found_a == found_b && a.gid.index == b.gid.index &&
+          a.adv_w == b.adv_w)
+        continue;
+      test_failures++;
+      if (reported++ < 5)
+        fprintf(stderr,
+                "%s: U+%04X before U+%04X gives glyph %u advance %u, "
+                "cmaps give %u advance %u\n",
+                name, (unsigned)letter, (unsigned)next,
+                (unsigned)a.gid.index, (unsigned)a.adv_w,
+                (unsigned)b.gid.index, (unsigned)b.adv_w);
+    }
+  }
+}
+
+int main(void) {
+  lv_init();
+  checkFont("montserrat_12", &lv_font_montserrat_12);
+  checkFont("montserrat_14", &lv_font_montserrat_14);
+  checkFont("montserrat_28", &lv_font_montserrat_28);
+  return testResult("glyph_id_table_test");
+}
@@ -0,0 +1,242 @@
+/**
+ * @file      keyboard_input_test.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * keyboard_input.cpp against a simulated LilyGo keyboard: recorded typing at
+ * 20 to 33 keys/s is replayed while the main loop drains the queue at
+ * irregular intervals. Every keystroke must come out as one press and one
+ * release, in order.
+ *
+ *   keyboard_input_test poll|int
+ *
+ * runs the reader polling the keyboard or woken by its interrupt line.
+ */
+#include "keyboard_input.h"
+#include "sim.h"
+#include "test.h"
+
+#include <string>
+#include <vector>
+
+#define KB_ADDRESS 0x55
+#define KB_INT_PIN 46
+
+// How the keyboard answers a read
+enum Firmware {
+  REPORT_ONCE, // every keystroke once, then 0
+  REPORT_HELD, // the last pressed key for as long as it is held, else 0
+};
+
+struct Keystroke {
+  uint32_t down; // ms from the start of the stream
+  uint32_t up;
+  uint8_t key;
+};
+
+static struct {
+  Firmware firmware;
+  uint8_t latched; // REPORT_ONCE: keystroke not read yet
+  std::vector<uint8_t> held;
+} kb;
+
+static bool use_int = false;
+static std::vector<KeyEvent> received;
+
+void schedulerWake() {}
+
+static int kbRead(uint8_t address) {
+  if (address != KB_ADDRESS)
+    return -1;
+  if (kb.firmware == REPORT_ONCE) {
+    uint8_t key = kb.latched;
+    kb.latched = 0;
+    return key;
+  }
+  return kb.held.empty() ? 0 : kb.held.back();
+}
+
+static void keyDown(uint8_t key) {
+  kb.latched = key;
+  kb.held.push_back(key);
+  if (use_int)
+    simInterrupt(KB_INT_PIN);
+}
+
+static void keyUp(uint8_t key) {
+  for (size_t i = 0; i < kb.held.size(); i++) {
+    if (kb.held[i] == key) {
+      kb.held.erase(kb.held.begin() + i);
+      break;
+    }
+  }
+}
+
+static void drain() {
+  KeyEvent event;
+  while (keyboardInputRead(event))
+    received.push_back(event);
+}
+
+static uint32_t lcg = 4242;
+static uint32_t randomBelow(uint32_t n) {
+  lcg = lcg * 1103515245 + 12345;
+  return (lcg >> 16) % n;
+}
+
+// Typing with 30 to 50 ms between keystrokes, keys held 15 to 25 ms. With
+// rollover a key is released 10 to 19 ms after the next one went down,
+// unless the same key is typed again. Without the interrupt line a key
+// typed twice stays up for at least one poll, which the reader needs to
+// see the release.
+static std::vector<Keystroke> record(const char *text, bool rollover) {
+  std::vector<Keystroke> stream;
+  uint32_t t = 0;
+  for (const char *c = text; *c; c++) {
+    uint32_t gap = 30 + randomBelow(21);
+    uint32_t hold = 15 + randomBelow(11);
+    if (rollover && c[1] != c[0])
+      hold = gap + 10 + randomBelow(10);
+    else if (!use_int && c[1] == c[0] && hold > gap - KEYBOARD_POLL_MS)
+      hold = gap - KEYBOARD_POLL_MS;
+    stream.push_back({t, t + hold, (uint8_t)*c});
+    t += gap;
+  }
+  return stream;
+}
+
+// Replay a stream millisecond by millisecond while the loop drains the
+// queue every 20 to 300 ms, then return the received events
+static std::vector<KeyEvent> replay(const std::vector<Keystroke> &stream,
+                                    std::vector<uint32_t> *down_times) {
+  uint32_t start = sim_millis;
+  uint32_t end = stream.back().up + 100;
+  uint32_t next_drain = start + 20 + randomBelow(281);
+  received.clear();
+
+  for (uint32_t t = 0; t < end; t++) {
+    for (const Keystroke &k : stream) {
+      if (k.up == t)
+        keyUp(k.key);
+    }
+    for (const Keystroke &k : stream) {
+      if (k.down == t) {
+        keyDown(k.key);
+        if (down_times)
+          down_times->push_back(sim_millis);
+      }
+    }
+    simTasksRun(1);
+    if ((int32_t)(sim_millis - next_drain) >= 0) {
+      drain();
+      next_drain = sim_millis + 20 + randomBelow(281);
+    }
+  }
+  drain();
+  return received;
+}
+
+// Every keystroke as a press and a release, in order, and no later than
+// one poll after the key went down
+static void checkKeystrokes(const std::vector<Keystroke> &stream,
+                            const std::vector<KeyEvent> &events,
+                            const std::vector<uint32_t> &down_times) {
+  CHECK_EQ(events.size(), stream.size() * 2);
+  for (size_t i = 0; i < stream.size() && i * 2 + 1 < events.size(); i++) {
+    const KeyEvent &press = events[i * 2];
+    const KeyEvent &release = events[i * 2 + 1];
+    if (press.key != stream[i].key || !press.pressed ||
+        release.key != stream[i].key || release.pressed) {
+      fprintf(stderr, "keystroke %zu '%c': got %c%s %c%s\n", i,
+              stream[i].key, press.key, press.pressed ? "+" : "-",
+              release.key, release.pressed ? "+" : "-");
+      test_failures++;
+      return;
+    }
+    uint32_t latency = press.time - down_times[i];
+    if (latency > KEYBOARD_POLL_MS) {
+      fprintf(stderr, "keystroke %zu '%c': read after %lu ms\n", i,
+              stream[i].key, (unsigned long)latency);
+      test_failures++;
+      return;
+    }
+  }
+  for (size_t i = 1; i < events.size(); i++)
+    CHECK(events[i].time >= events[i - 1].time);
+}
+
+static const char *text =
+    "hello balloon, see you at noon! the quick brown fox jumps over the "
+    "lazy dog 0123456789 aabbccdd";
+
+static void testTyping(Firmware firmware, bool rollover) {
+  kb.firmware = firmware;
+  std::vector<Keystroke> stream = record(text, rollover);
+  std::vector<uint32_t> down_times;
+  std::vector<KeyEvent> events = replay(stream, &down_times);
+  checkKeystrokes(stream, events, down_times);
+  CHECK_EQ(keyboardInputDropped(), 0);
+}
+
+// A key held for a second repeats KEYBOARD_REPEAT_DELAY_MS after it went
+// down, then every KEYBOARD_REPEAT_RATE_MS, if the keyboard keeps reporting
+// it. A keyboard reporting every keystroke once gives no repeat.
+static void testRepeat(Firmware firmware) {
+  kb.firmware = firmware;
+  std::vector<Keystroke> stream = {{0, 1000, 'x'}};
+  std::vector<uint32_t> down_times;
+  std::vector<KeyEvent> events = replay(stream, &down_times);
+  CHECK(!events.empty());
+  if (events.empty())
+    return;
+
+  // Repeats due while the key is still down
+  uint32_t repeats = 0;
+  uint32_t up = down_times[0] + 1000;
+  uint32_t next = events[0].time + KEYBOARD_REPEAT_DELAY_MS;
+  while (firmware == REPORT_HELD && next < up) {
+    repeats++;
+    next += KEYBOARD_REPEAT_RATE_MS;
+  }
+
+  CHECK_EQ(events.size(), 2 + repeats * 2);
+  for (size_t i = 0; i < events.size(); i++) {
+    CHECK_EQ(events[i].key, 'x');
+    CHECK_EQ(events[i].pressed, i % 2 == 0);
+  }
+  for (uint32_t i = 1; i <= repeats && i * 2 < events.size(); i++) {
+    uint32_t due = events[0].time + KEYBOARD_REPEAT_DELAY_MS +
+                   (i - 1) * KEYBOARD_REPEAT_RATE_MS;
+    CHECK_EQ(events[i * 2].time, due);
+    CHECK_EQ(events[i * 2 - 1].time, due);
+  }
+}
+
+// With the interrupt line a key typed again while up for less than a poll
+// still counts twice: the keyboard pulses INT when it goes down
+static void testQuickDoubleKey() {
+  kb.firmware = REPORT_HELD;
+  std::vector<Keystroke> stream = {{0, 12, 'l'}, {15, 30, 'l'}};
+  std::vector<uint32_t> down_times;
+  std::vector<KeyEvent> events = replay(stream, &down_times);
+  checkKeystrokes(stream, events, down_times);
+}
+
+int main(int argc, char **argv) {
+  use_int = argc > 1 && !strcmp(argv[1], "int");
+  simWireSetReader(kbRead);
+  CHECK(keyboardInputBegin(KB_ADDRESS, use_int ? KB_INT_PIN : -1));
+
+  testTyping(REPORT_ONCE, false);
+  testTyping(REPORT_HELD, false);
+  testTyping(REPORT_HELD, true);
+  testRepeat(REPORT_HELD);
+  testRepeat(REPORT_ONCE);
+  if (use_int)
+    testQuickDoubleKey();
+
+  return testResult(use_int ? "keyboard_input_test int"
+                            : "keyboard_input_test poll");
+}
@@ -0,0 +1,327 @@
+/**
+ * @file      lua_async_test.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * lua_async.cpp with thousands of concurrent coroutines on the simulated
+ * clock: sleepers must wake exactly when due, every event waiter must get
+ * every post, concurrent file reads must return the files, and a failing
+ * task must not disturb the others. Nothing may stay pending.
+ *
+ *   lua_async_test [tasks]
+ */
+#include "lua_async.h"
+#include "sim.h"
+#include "test.h"
+#include <LittleFS.h>
+
+extern "C" {
+#include "lauxlib.h"
+#include "lualib.h"
+}
+
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+void schedulerWake() {}
+
+static int lua_millis(lua_State *L) {
+  lua_pushinteger(L, millis());
+  return 1;
+}
+
+static lua_State *newState() {
+  lua_State *L = luaL_newstate();
+  luaL_openlibs(L);
+  luaAsyncBegin(L);
+  lua_register(L, "millis", lua_millis);
+  return L;
+}
+
+// Run a chunk with an integer argument, returns its integer results
+static std::vector<lua_Integer> runLua(lua_State *L, const char *code,
+                                       lua_Integer arg) {
+  std::vector<lua_Integer> results;
+  int top = lua_gettop(L);
+  if (luaL_loadstring(L, code) != LUA_OK) {
+    fprintf(stderr, "%s\n", lua_tostring(L, -1));
+    test_failures++;
+    lua_settop(L, top);
+    return results;
+  }
+  lua_pushinteger(L, arg);
+  if (lua_pcall(L, 1, LUA_MULTRET, 0) != LUA_OK) {
+    fprintf(stderr, "%s\n", lua_tostring(L, -1));
+    test_failures++;
+    lua_settop(L, top);
+    return results;
+  }
+  for (int i = top + 1; i <= lua_gettop(L); i++)
+    results.push_back(lua_tointeger(L, i));
+  lua_settop(L, top);
+  return results;
+}
+
+// The main loop without LVGL: poll, then sleep as long as it asks
+static void runUntilIdle(lua_State *L) {
+  while (luaAsyncPending()) {
+    uint32_t wait = luaAsyncPoll(L);
+    if (wait == UINT32_MAX)
+      break;
+    sim_millis += wait;
+  }
+}
+
+// Every task sleeps one to four times and yields in between. It records
+// whether it woke exactly when due.
+static const char *sleepers = R"(
+local n = ...
+local seed = 7
+local function random(m)
+  seed = (seed * 1103515245 + 12345) % 2147483648
+  return seed % m
+end
+done, late = 0, 0
+for i = 1, n do
+  local sleeps = {}
+  for s = 1, 1 + random(4) do
+    sleeps[s] = random(3) == 0 and 0 or random(5000)
+  end
+  async.spawn(function()
+    for _, ms in ipairs(sleeps) do
+      local due = millis() + ms
+      await(async.sleep(ms))
+      if millis() ~= due then late = late + 1 end
+      coroutine.yield()
+    end
+    done = done + 1
+  end)
+end
+)";
+
+static void testSleepers(int tasks) {
+  lua_State *L = newState();
+  uint32_t start = sim_millis;
+  runLua(L, sleepers, tasks);
+  CHECK_EQ(luaAsyncPending(), (uint32_t)tasks);
+  runUntilIdle(L);
+
+  std::vector<lua_Integer> r = runLua(L, "return done, late", 0);
+  CHECK_EQ(r.size(), 2u);
+  if (r.size() == 2) {
+    CHECK_EQ(r[0], tasks);
+    CHECK_EQ(r[1], 0);
+  }
+  CHECK_EQ(luaAsyncPending(), 0u);
+  // No more than the longest chain of sleeps
+  CHECK(sim_millis - start <= 4 * 5000);
+  lua_close(L);
+}
+
+// Waiters of two events, awaiting them again after every post. Half of the
+// "radio" posts come from Lua.
+static const char *waiters = R"(
+local n = ...
+got, wrong = 0, 0
+for i = 1, n do
+  local name = i % 4 == 0 and "key" or "radio"
+  async.spawn(function()
+    for p = 1, 3 do
+      local data = await(async.event(name))
+      if data ~= name .. p then wrong = wrong + 1 end
+      got = got + 1
+    end
+  end)
+end
+)";
+
+static void testEvents(int tasks) {
+  lua_State *L = newState();
+  runLua(L, waiters, tasks);
+  CHECK_EQ(luaAsyncPending(), (uint32_t)tasks);
+
+  for (int p = 1; p <= 3; p++) {
+    std::string radio = "radio" + std::to_string(p);
+    std::string key = "key" + std::to_string(p);
+    if (p == 2) {
+      runLua(L, "async.post('radio', 'radio2')", 0);
+    } else {
+      CHECK(luaAsyncPost("radio", radio.data(), radio.size()));
+    }
+    CHECK(luaAsyncPost("key", key.data(), key.size()));
+    // Nobody waits for it
+    CHECK(luaAsyncPost("other", "x", 1));
+    runUntilIdle(L);
+  }
+
+  std::vector<lua_Integer> r = runLua(L, "return got, wrong", 0);
+  CHECK_EQ(r.size(), 2u);
+  if (r.size() == 2) {
+    CHECK_EQ(r[0], tasks * 3);
+    CHECK_EQ(r[1], 0);
+  }
+  CHECK_EQ(luaAsyncPending(), 0u);
+  lua_close(L);
+}
+
+static const size_t file_sizes[] = {0,
+                                    1,
+                                    LUA_ASYNC_READ_CHUNK - 1,
+                                    LUA_ASYNC_READ_CHUNK,
+                                    LUA_ASYNC_READ_CHUNK + 1,
+                                    10000};
+#define FILE_COUNT (sizeof(file_sizes) / sizeof(file_sizes[0]))
+
+static std::string fileContent(size_t f) {
+  std::string data(file_sizes[f], '\0');
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = (char)(i * 7 + f);
+  return data;
+}
+
+// Concurrent reads of the files, each task reading one of them twice, and
+// of a missing one
+static const char *readers = R"(
+local n, files = ...
+data, missing = {}, 0
+for i = 1, n do
+  async.spawn(function()
+    local f = i % files
+    local first = await(async.read_file("/file" .. f))
+    local second = await(async.read_file("/file" .. f))
+    if first == second then data[i] = first end
+    local none, err = await(async.read_file("/missing"))
+    if none == nil and err then missing = missing + 1 end
+  end)
+end
+)";
+
+static void testReads(int tasks) {
+  lua_State *L = newState();
+  luaL_loadstring(L, readers);
+  lua_pushinteger(L, tasks);
+  lua_pushinteger(L, FILE_COUNT);
+  CHECK_EQ(lua_pcall(L, 2, 0, 0), LUA_OK);
+  CHECK_EQ(luaAsyncPending(), (uint32_t)tasks);
+  runUntilIdle(L);
+  CHECK_EQ(luaAsyncPending(), 0u);
+
+  lua_getglobal(L, "data");
+  for (int i = 1; i <= tasks; i++) {
+    std::string expected = fileContent(i % FILE_COUNT);
+    size_t len = 0;
+    lua_rawgeti(L, -1, i);
+    const char *data = lua_tolstring(L, -1, &len);
+    if (!data || len != expected.size() ||
+        memcmp(data, expected.data(), len)) {
+      fprintf(stderr, "task %d read %zu bytes of file%zu, expected %zu\n", i,
+              len, (size_t)(i % FILE_COUNT), expected.size());
+      test_failures++;
+      break;
+    }
+    lua_pop(L, 1);
+  }
+  lua_settop(L, 0);
+
+  std::vector<lua_Integer> r = runLua(L, "return missing", 0);
+  CHECK_EQ(r.size(), 1u);
+  if (r.size() == 1)
+    CHECK_EQ(r[0], tasks);
+  lua_close(L);
+}
+
+// A few failing tasks among many yielding ones
+static const char *failing = R"(
+local n = ...
+done = 0
+for i = 1, n do
+  async.spawn(function()
+    for y = 1, 5 do coroutine.yield() end
+    if i % 1000 == 0 then error("task " .. i .. " fails") end
+    await(async.sleep(i % 10))
+    done = done + 1
+  end)
+end
+)";
+
+static void testErrors(int tasks) {
+  lua_State *L = newState();
+  runLua(L, failing, tasks);
+  runUntilIdle(L);
+
+  std::vector<lua_Integer> r = runLua(L, "return done", 0);
+  CHECK_EQ(r.size(), 1u);
+  if (r.size() == 1)
+    CHECK_EQ(r[0], tasks - tasks / 1000);
+  CHECK_EQ(luaAsyncPending(), 0u);
+  lua_close(L);
+}
+
+// Closing an app while its tasks sleep, wait for an event or read a file
+static const char *abandoned = R"(
+local n = ...
+for i = 1, n do
+  async.spawn(function()
+    if i % 3 == 0 then
+      await(async.sleep(1000000))
+    elseif i % 3 == 1 then
+      await(async.event("radio"))
+    else
+      await(async.read_file("/file" .. i % 6))
+    end
+  end)
+end
+)";
+
+static void testEnd(int tasks) {
+  lua_State *L = newState();
+  runLua(L, abandoned, tasks);
+  CHECK_EQ(luaAsyncPending(), (uint32_t)tasks);
+  // Posted for this app, not delivered before it closes
+  CHECK(luaAsyncPost("radio", "old", 3));
+  luaAsyncEnd(L);
+  CHECK_EQ(luaAsyncPending(), 0u);
+  lua_close(L);
+
+  // The next app starts from a clean state, with no post left over
+  L = newState();
+  runLua(L, "async.spawn(function() got = await(async.event('radio')) end)",
+         0);
+  CHECK(luaAsyncPost("radio", "next", 4));
+  runUntilIdle(L);
+  CHECK_EQ(luaAsyncPending(), 0u);
+  lua_getglobal(L, "got");
+  CHECK(lua_isstring(L, -1) && !strcmp(lua_tostring(L, -1), "next"));
+  lua_close(L);
+}
+
+int main(int argc, char **argv) {
+  int tasks = argc > 1 ? atoi(argv[1]) : 5000;
+
+  // The files read by the tasks
+  char dir[] = "/tmp/lua_async_testXXXXXX";
+  CHECK(mkdtemp(dir) != NULL);
+  LittleFS.setRoot(dir);
+  for (size_t f = 0; f < FILE_COUNT; f++) {
+    std::string path = "/file" + std::to_string(f);
+    std::string data = fileContent(f);
+    fs::File file = LittleFS.open(path.c_str(), "w");
+    CHECK(file.write((const uint8_t *)data.data(), data.size()) ==
+          data.size());
+  }
+
+  testSleepers(tasks);
+  testEvents(tasks);
+  testReads(tasks / 10);
+  testErrors(tasks);
+  testEnd(tasks);
+
+  for (size_t f = 0; f < FILE_COUNT; f++)
+    remove((std::string(dir) + "/file" + std::to_string(f)).c_str());
+  rmdir(dir);
+  return testResult("lua_async_test");
+}
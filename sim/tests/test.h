@@ -0,0 +1,42 @@
+/**
+ * @file      test.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * Checks for the host tests run by CTest. A failed check is printed and the
+ * test carries on; main() returns testResult().
+ */
+#pragma once
+
+#include <stdio.h>
+
+static int test_failures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      test_failures++;                                                         \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                         \
+  do {                                                                         \
+    long long a_ = (long long)(a), b_ = (long long)(b);                        \
+    if (a_ != b_) {                                                            \
+      fprintf(stderr, "%s:%d: check failed: %s == %s (%lld != %lld)\n",        \
+              __FILE__, __LINE__, #a, #b, a_, b_);                             \
+      test_failures++;                                                         \
+    }                                                                          \
+  } while (0)
+
+static inline int testResult(const char *name) {
+  if (test_failures) {
+    fprintf(stderr, "%s: %d checks failed\n", name, test_failures);
+    return 1;
+  }
+  printf("%s: passed\n", name);
+  return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file      text_lines_test.c
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * The label line cache (LV_LABEL_LINE_CACHE) against breaking the whole text:
+ * after random inserts and cuts, alone or several merged before an update,
+ * lv_text_lines_update() must give the lines and the size a full
+ * lv_text_get_next_line() pass gives.
+ *
+ *   text_lines_test [edits]
+ */
+#include "test.h"
+#include <lvgl.h>
+#include <src/misc/lv_text_private.h>
+#include <src/widgets/label/lv_label_private.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+// The LVGL heap is 64 KB, texts stay well below it
+#define TEXT_MAX 1500
+
+static const char *inserts[] = {
+    "a",  " ",    "\n",           "wwwwwwwwwwwwww", "\xc3\xa9",
+    "\r\n", "iii", "Hello world ", "xx yy",          "\xe2\x82\xac "};
+
+static const char *start_text =
+    "ab\ncd efg\n\nhij\r\nklm wwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwwww";
+
+static uint32_t lcg = 2024;
+static uint32_t randomBelow(uint32_t n) {
+  lcg = lcg * 1103515245 + 12345;
+  return (lcg >> 16) % n;
+}
+
+static int reported = 0;
+
+// The cached lines of txt against breaking it from the start
+static void checkLines(const lv_text_lines_t *c, const char *txt,
+                       const char *what, int edit) {
+  int failures = test_failures;
+  CHECK(c->valid);
+  uint32_t start = 0;
+  uint32_t i = 0;
+  while (txt[start] && test_failures == failures) {
+    uint32_t end = start + lv_text_get_next_line(&txt[start], c->font,
+                                                 c->letter_space,
+                                                 c->max_width, NULL, c->flag);
+    int32_t width =
+        lv_text_get_width(&txt[start], end - start, c->font, c->letter_space);
+    CHECK(i < lv_text_lines_get_count(c));
+    if (test_failures == failures) {
+      CHECK_EQ(lv_text_lines_get_start(c, i), start);
+      CHECK_EQ(lv_text_lines_get_width(c, i), width);
+    }
+    start = end;
+    i++;
+  }
+  if (test_failures == failures) {
+    CHECK_EQ(lv_text_lines_get_count(c), i);
+    CHECK_EQ(lv_text_lines_get_start(c, i), start);
+
+    lv_point_t full, cached;
+    lv_text_get_size(&full, txt, c->font, c->letter_space, 2, c->max_width,
+                     c->flag);
+    lv_text_lines_get_size(c, txt, 2, &cached);
+    CHECK_EQ(cached.x, full.x);
+    CHECK_EQ(cached.y, full.y);
+  }
+  if (test_failures != failures && reported++ < 5)
+    fprintf(stderr, "%s, edit %d: lines differ at line %u\n", what, edit,
+            (unsigned)i);
+}
+
+// Random edits through the label API, each checked after the label updated
+// its lines
+static void testLabel(const char *what, lv_obj_t *label, int edits) {
+  lv_label_set_text(label, start_text);
+  for (int i = 0; i < edits; i++) {
+    uint32_t len = lv_text_get_encoded_length(lv_label_get_text(label));
+    uint32_t pos = randomBelow(len + 1);
+    if (randomBelow(5) < 3 || len < 10) {
+      lv_label_ins_text(label, pos, inserts[randomBelow(10)]);
+      // A second edit before the update
+      if (randomBelow(4) == 0)
+        lv_label_ins_text(label, randomBelow(len + 1), "xx yy");
+    } else {
+      uint32_t cnt = 1 + randomBelow(8);
+      if (pos + cnt > len)
+        cnt = len - pos;
+      lv_label_cut_text(label, pos, cnt);
+    }
+    if (strlen(lv_label_get_text(label)) > TEXT_MAX)
+      lv_label_cut_text(label, 0, TEXT_MAX / 2);
+
+    // The size and the draw read the cached lines
+    lv_obj_update_layout(label);
+    lv_label_t *l = (lv_label_t *)label;
+    checkLines(&l->lines, l->text, what, i);
+    if (i % 100 == 0)
+      lv_refr_now(NULL);
+  }
+}
+
+// Up to four edits of a plain buffer merged into one update
+static void testMergedEdits(const char *what, int32_t max_width,
+                            lv_text_flag_t flag, int rounds) {
+  static char t[TEXT_MAX * 2];
+  const lv_font_t *font = LV_FONT_DEFAULT;
+  lv_text_lines_t c;
+  lv_text_lines_init(&c);
+
+  strcpy(t, start_text);
+  lv_text_lines_update(&c, t, font, 0, max_width, flag);
+  for (int i = 0; i < rounds; i++) {
+    int n = 1 + randomBelow(4);
+    for (int j = 0; j < n; j++) {
+      size_t len = strlen(t);
+      size_t pos = randomBelow(len + 1);
+      if (randomBelow(2) || len < 10) {
+        const char *ins = inserts[randomBelow(10)];
+        size_t ins_len = strlen(ins);
+        // Only whole letters are cut or inserted into
+        while (pos < len && (t[pos] & 0xc0) == 0x80)
+          pos++;
+        memmove(t + pos + ins_len, t + pos, len - pos + 1);
+        memcpy(t + pos, ins, ins_len);
+        lv_text_lines_edit(&c, pos, 0, ins_len);
+      } else {
+        size_t cnt = 1 + randomBelow(8);
+        while (pos < len && (t[pos] & 0xc0) == 0x80)
+          pos++;
+        if (pos + cnt > len)
+          cnt = len - pos;
+        while (pos + cnt < len && (t[pos + cnt] & 0xc0) == 0x80)
+          cnt++;
+        memmove(t + pos, t + pos + cnt, len - pos - cnt + 1);
+        lv_text_lines_edit(&c, pos, cnt, 0);
+      }
+    }
+    if (strlen(t) > TEXT_MAX) {
+      strcpy(t, start_text);
+      lv_text_lines_invalidate(&c);
+    }
+    lv_text_lines_update(&c, t, font, 0, max_width, flag);
+    checkLines(&c, t, what, i);
+  }
+  lv_text_lines_deinit(&c);
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area,
+                     uint8_t *px_map) {
+  lv_display_flush_ready(disp);
+}
+
+int main(int argc, char **argv) {
+  int edits = argc > 1 ? atoi(argv[1]) : 3000;
+
+  lv_init();
+  lv_display_t *disp = lv_display_create(320, 240);
+  static uint8_t buf[320 * 40 * 2];
+  lv_display_set_buffers(disp, buf, NULL, sizeof(buf),
+                         LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_set_flush_cb(disp, flush_cb);
+
+  // Wrapped like a message, one line like a text area, and narrower than
+  // the longest word
+  lv_obj_t *wrap = lv_label_create(lv_screen_active());
+  lv_obj_set_width(wrap, 300);
+  lv_obj_t *one_line = lv_label_create(lv_screen_active());
+  lv_obj_t *narrow = lv_label_create(lv_screen_active());
+  lv_obj_set_width(narrow, 40);
+
+  testLabel("wrap 300 px", wrap, edits);
+  lv_label_set_text(wrap, "");
+  testLabel("one line", one_line, edits);
+  lv_label_set_text(one_line, "");
+  testLabel("wrap 40 px", narrow, edits);
+  lv_label_set_text(narrow, "");
+
+  testMergedEdits("merged, 60 px", 60, LV_TEXT_FLAG_NONE, edits);
+  testMergedEdits("merged, break all", 60, LV_TEXT_FLAG_BREAK_ALL, edits);
+  testMergedEdits("merged, expand", LV_COORD_MAX, LV_TEXT_FLAG_EXPAND, edits);
+
+  return testResult("text_lines_test");
+}
@@ -0,0 +1,231 @@
+/**
+ * @file      touch_input_test.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ * touch_input.cpp against a simulated GT911: the panel pulses INT for every
+ * report, the reader task queues the points and the main loop drains them at
+ * irregular intervals. Every report must come out once, in order.
+ */
+#include "sim.h"
+#include "test.h"
+#include "touch_input.h"
+
+#include <vector>
+
+#define TOUCH_INT_PIN 16
+
+// Simulated GT911. A report latches the point and pulses INT; reading the
+// point registers clears them, like clearBuffer() in the driver.
+static struct {
+  int16_t x;
+  int16_t y;
+  uint8_t points;
+  uint32_t reads; // I2C reads of the point registers
+} panel;
+
+uint8_t TouchDrvGT911::getPoint(int16_t *x_array, int16_t *y_array,
+                                uint8_t size) {
+  panel.reads++;
+  uint8_t points = panel.points;
+  panel.points = 0;
+  if (points) {
+    x_array[0] = panel.x;
+    y_array[0] = panel.y;
+  }
+  return points;
+}
+
+uint8_t TouchDrvGT911::getInterruptMode() { return 0x01; }
+
+static TouchDrvGT911 touch;
+static std::vector<TouchEvent> expected;
+static std::vector<TouchEvent> received;
+static uint32_t wakeups = 0;
+
+void schedulerWake() { wakeups++; }
+
+// Finger at x, y: the panel reports and the task gets to read it
+static void report(int16_t x, int16_t y) {
+  panel.x = x;
+  panel.y = y;
+  panel.points = 1;
+  simInterrupt(TOUCH_INT_PIN);
+  expected.push_back({sim_millis, x, y, true});
+}
+
+// Finger lifted. The GT911 sends a last report without points, but the
+// pulse can be missed.
+static void lift(bool pulse) {
+  panel.points = 0;
+  if (pulse)
+    simInterrupt(TOUCH_INT_PIN);
+}
+
+static void expectRelease(uint32_t time) {
+  TouchEvent last = expected.back();
+  expected.push_back({time, last.x, last.y, false});
+}
+
+// The main loop handing the queued events to LVGL
+static void drain() {
+  TouchEvent event;
+  while (touchInputRead(event))
+    received.push_back(event);
+}
+
+static void checkReceived() {
+  CHECK_EQ(received.size(), expected.size());
+  for (size_t i = 0; i < received.size() && i < expected.size(); i++) {
+    const TouchEvent &r = received[i];
+    const TouchEvent &e = expected[i];
+    if (r.time != e.time || r.x != e.x || r.y != e.y ||
+        r.pressed != e.pressed) {
+      fprintf(stderr,
+              "event %zu: got %s %d,%d at %lu, expected %s %d,%d at %lu\n", i,
+              r.pressed ? "press" : "release", r.x, r.y,
+              (unsigned long)r.time, e.pressed ? "press" : "release", e.x,
+              e.y, (unsigned long)e.time);
+      test_failures++;
+      break;
+    }
+  }
+  expected.clear();
+  received.clear();
+}
+
+static uint32_t lcg = 12345;
+static uint32_t randomBelow(uint32_t n) {
+  lcg = lcg * 1103515245 + 12345;
+  return (lcg >> 16) % n;
+}
+
+// No I2C traffic without a touch
+static void testIdle() {
+  uint32_t reads = panel.reads;
+  simTasksRun(10000);
+  CHECK_EQ(panel.reads, reads);
+  drain();
+  checkReceived();
+}
+
+// A long drag at the panel's report rate while the loop stalls for up to
+// 400 ms, e.g. behind a full-screen render or a collector step
+static void testDragWithStalls() {
+  uint32_t next_drain = sim_millis + randomBelow(400);
+  for (int i = 0; i < 1000; i++) {
+    report(10 + i % 300, 20 + i / 5);
+    simTasksRun(5 + randomBelow(11));
+    if ((int32_t)(sim_millis - next_drain) >= 0) {
+      drain();
+      next_drain = sim_millis + randomBelow(400);
+    }
+  }
+  lift(true);
+  expectRelease(sim_millis);
+  simTasksRun(100);
+  drain();
+
+  CHECK_EQ(touchInputDropped(), 0);
+  checkReceived();
+}
+
+// A finger held still keeps reporting and must not be released in between
+static void testHold() {
+  for (int i = 0; i < 100; i++) {
+    report(160, 120);
+    simTasksRun(TOUCH_RELEASE_TIMEOUT_MS - 10);
+    if (i % 10 == 9)
+      drain();
+  }
+  lift(true);
+  expectRelease(sim_millis);
+  simTasksRun(100);
+  drain();
+  checkReceived();
+}
+
+// Quick taps in bursts, drained four times a second
+static void testTaps() {
+  for (int i = 0; i < 50; i++) {
+    int16_t x = 20 + (i * 37) % 280;
+    int16_t y = 30 + (i * 53) % 180;
+    report(x, y);
+    simTasksRun(10);
+    report(x + 1, y);
+    simTasksRun(10);
+    lift(true);
+    expectRelease(sim_millis);
+    simTasksRun(i % 10 == 9 ? 200 : 20);
+    if (i % 12 == 11)
+      drain();
+  }
+  drain();
+
+  CHECK_EQ(touchInputDropped(), 0);
+  checkReceived();
+}
+
+// Several pulses before the task runs: the GT911 only holds the latest
+// report, which is read once
+static void testCoalescedPulses() {
+  panel.x = 50;
+  panel.y = 60;
+  panel.points = 1;
+  simInterrupt(TOUCH_INT_PIN);
+  report(51, 60);
+  simTasksRun(10);
+  lift(true);
+  expectRelease(sim_millis);
+  simTasksRun(100);
+  drain();
+  checkReceived();
+}
+
+// A missed release pulse is caught by the timeout
+static void testMissedRelease() {
+  report(200, 100);
+  simTasksRun(10);
+  uint32_t last_report = sim_millis - 10;
+  lift(false);
+  expectRelease(last_report + TOUCH_RELEASE_TIMEOUT_MS);
+  simTasksRun(200);
+  drain();
+  checkReceived();
+}
+
+// A loop stalled past the queue capacity loses events, and they are counted
+static void testOverflow() {
+  for (int i = 0; i < 100; i++) {
+    report(100, i);
+    simTasksRun(10);
+  }
+  lift(true);
+  simTasksRun(100);
+  CHECK_EQ(touchInputDropped(), 100 + 1 - 64);
+
+  TouchEvent event;
+  uint32_t count = 0;
+  while (touchInputRead(event))
+    count++;
+  CHECK_EQ(count, 64);
+  expected.clear();
+}
+
+int main() {
+  CHECK(touchInputBegin(touch, TOUCH_INT_PIN));
+  simTasksRun(1);
+
+  testIdle();
+  testDragWithStalls();
+  testHold();
+  testTaps();
+  testCoalescedPulses();
+  testMissedRelease();
+  testOverflow();
+  CHECK(wakeups > 0);
+
+  return testResult("touch_input_test");
+}
@@ -0,0 +1,26 @@
+/**
+ * @file      i2c_bus.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "i2c_bus.h"
+
+static SemaphoreHandle_t i2c_mutex = NULL;
+
+void i2cBusInit() {
+  if (!i2c_mutex)
+    i2c_mutex = xSemaphoreCreateRecursiveMutex();
+}
+
+void i2cBusLock() {
+  if (i2c_mutex)
+    xSemaphoreTakeRecursive(i2c_mutex, portMAX_DELAY);
+}
+
+void i2cBusUnlock() {
+  if (i2c_mutex)
+    xSemaphoreGiveRecursive(i2c_mutex);
+}
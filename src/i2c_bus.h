@@ -0,0 +1,26 @@
+/**
+ * @file      i2c_bus.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+
+// The touch panel, keyboard and sensors share one I2C bus (Wire) but are
+// read from different tasks. Hold the bus for a whole register transaction.
+void i2cBusInit();
+void i2cBusLock();
+void i2cBusUnlock();
+
+// Scoped bus lock
+class I2CBusGuard {
+public:
+  I2CBusGuard() { i2cBusLock(); }
+  ~I2CBusGuard() { i2cBusUnlock(); }
+  I2CBusGuard(const I2CBusGuard &) = delete;
+  I2CBusGuard &operator=(const I2CBusGuard &) = delete;
+};
@@ -0,0 +1,114 @@
+/**
+ * @file      keyboard_input.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "keyboard_input.h"
+#include "i2c_bus.h"
+#include "ring_buffer.h"
+#include "scheduler.h"
+#include <Wire.h>
+
+static uint8_t kb_address = 0;
+static int kb_irq_pin = -1;
+static TaskHandle_t keyboard_task = NULL;
+static RingBuffer<KeyEvent, 64> key_events;
+
+static volatile uint16_t repeat_delay = KEYBOARD_REPEAT_DELAY_MS;
+static volatile uint16_t repeat_rate = KEYBOARD_REPEAT_RATE_MS;
+
+static void IRAM_ATTR keyboard_isr() {
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(keyboard_task, &woken);
+  if (woken)
+    portYIELD_FROM_ISR();
+}
+
+static void push_key(uint32_t time, uint8_t key, bool pressed) {
+  KeyEvent event = {time, key, pressed};
+  key_events.push(event);
+  schedulerWake();
+}
+
+static void keyboard_task_fn(void *param) {
+  uint8_t held = 0;
+  uint32_t next_repeat = 0;
+
+  for (;;) {
+    // Without an interrupt line, or while a key is held, poll at a fixed
+    // cadence; otherwise sleep until the keyboard signals a key
+    uint32_t notified;
+    if (held || kb_irq_pin < 0) {
+      notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(KEYBOARD_POLL_MS));
+    } else {
+      notified = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    uint8_t key = 0;
+    {
+      I2CBusGuard bus;
+      Wire.requestFrom(kb_address, 1);
+      if (Wire.available() > 0) {
+        key = Wire.read();
+      }
+    }
+
+    uint32_t now = millis();
+
+    // A read returns the last key typed, or 0. Depending on its firmware
+    // the keyboard reports a key once per keystroke, or for as long as it
+    // is held; only the latter gives typematic repeat below. A polled key
+    // is seen as typed again once it was up for at least KEYBOARD_POLL_MS.
+    // With the interrupt line a pulse while the key is held is that key
+    // typed again.
+    bool again = key && key == held && notified && kb_irq_pin >= 0;
+    if (key != held || again) {
+      if (held) {
+        push_key(now, held, false);
+      }
+      if (key) {
+        push_key(now, key, true);
+        next_repeat = now + repeat_delay;
+      }
+      held = key;
+    } else if (held && repeat_rate && (int32_t)(now - next_repeat) >= 0) {
+      // Typematic repeat is delivered as a release/press pair so LVGL
+      // treats it as another keystroke
+      push_key(now, held, false);
+      push_key(now, held, true);
+      next_repeat = now + repeat_rate;
+    }
+  }
+}
+
+bool keyboardInputBegin(uint8_t address, int irq_pin) {
+  kb_address = address;
+  kb_irq_pin = irq_pin;
+
+  if (xTaskCreatePinnedToCore(keyboard_task_fn, "keyboard", 3072, NULL, 2,
+                              &keyboard_task, ARDUINO_RUNNING_CORE) != pdPASS) {
+    Serial.println("Failed to create keyboard task");
+    return false;
+  }
+
+  if (kb_irq_pin >= 0) {
+    pinMode(kb_irq_pin, INPUT);
+    attachInterrupt(digitalPinToInterrupt(kb_irq_pin), keyboard_isr, FALLING);
+  }
+
+  return true;
+}
+
+void keyboardSetRepeat(uint16_t delay_ms, uint16_t rate_ms) {
+  repeat_delay = delay_ms;
+  repeat_rate = rate_ms;
+}
+
+bool keyboardInputRead(KeyEvent &event) { return key_events.pop(event); }
+
+bool keyboardInputPending() { return !key_events.empty(); }
+
+uint32_t keyboardInputDropped() { return key_events.dropped(); }
@@ -0,0 +1,49 @@
+/**
+ * @file      keyboard_input.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+
+// Keyboard read cadence while a key is held, or always when polling
+#ifndef KEYBOARD_POLL_MS
+#define KEYBOARD_POLL_MS 10
+#endif
+
+// Default typematic repeat: delay before the first repeat and the interval
+// between repeats. Set KEYBOARD_REPEAT_RATE_MS to 0 to disable repeat.
+#ifndef KEYBOARD_REPEAT_DELAY_MS
+#define KEYBOARD_REPEAT_DELAY_MS 500
+#endif
+
+#ifndef KEYBOARD_REPEAT_RATE_MS
+#define KEYBOARD_REPEAT_RATE_MS 60
+#endif
+
+struct KeyEvent {
+  uint32_t time; // millis() when the key state changed
+  uint8_t key;   // character reported by the keyboard
+  bool pressed;
+};
+
+// Start the keyboard reader task. With irq_pin >= 0 the keyboard is only
+// read after it raises its interrupt line (and while a key is held);
+// with irq_pin < 0 it is polled every KEYBOARD_POLL_MS.
+bool keyboardInputBegin(uint8_t address, int irq_pin);
+
+// Configure typematic repeat for held keys. rate_ms = 0 disables repeat.
+void keyboardSetRepeat(uint16_t delay_ms, uint16_t rate_ms);
+
+// Pop the oldest queued key event. Returns false if none is pending.
+bool keyboardInputRead(KeyEvent &event);
+
+// True if more key events are queued
+bool keyboardInputPending();
+
+// Number of events dropped because the queue was full
+uint32_t keyboardInputDropped();
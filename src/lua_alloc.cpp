@@ -0,0 +1,396 @@
+/**
+ * @file      lua_alloc.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "lua_alloc.h"
+
+#include <esp_heap_caps.h>
+#include <soc/soc_memory_layout.h>
+
+extern "C" {
+#include "lauxlib.h"
+}
+
+#define INTERNAL_CAPS (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define PSRAM_CAPS (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+// Lua passes the old size on free and realloc, so blocks need no header: the
+// size class of a block is found again from osize
+static const uint16_t class_sizes[LUA_ALLOC_NUM_CLASSES] = {
+    16, 24, 32, 40, 48, 64, 80, 96, 128};
+
+// Size class for every 8 byte step up to LUA_ALLOC_SMALL_MAX
+static const uint8_t class_of_step[LUA_ALLOC_SMALL_MAX / 8] = {
+    0, 0, 1, 2, 3, 4, 5, 5, 6, 6, 7, 7, 8, 8, 8, 8};
+
+static_assert(LUA_ALLOC_SMALL_MAX == 128, "update the size class tables");
+
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+static FreeBlock *free_lists[LUA_ALLOC_NUM_CLASSES];
+static LuaAllocStats stats;
+static bool stats_ready = false;
+
+static inline int sizeClass(size_t size) {
+  return class_of_step[(size - 1) >> 3];
+}
+
+// Slabs come from internal RAM up to LUA_ALLOC_SLAB_INTERNAL_MAX, then from
+// PSRAM. Without PSRAM internal RAM is used past the limit.
+static uint8_t *newSlab() {
+  uint8_t *slab = NULL;
+  if (stats.slab_internal + LUA_ALLOC_SLAB_BYTES <= LUA_ALLOC_SLAB_INTERNAL_MAX)
+    slab = (uint8_t *)heap_caps_malloc(LUA_ALLOC_SLAB_BYTES, INTERNAL_CAPS);
+  if (!slab && psramFound())
+    slab = (uint8_t *)heap_caps_malloc(LUA_ALLOC_SLAB_BYTES, PSRAM_CAPS);
+  if (!slab)
+    slab = (uint8_t *)heap_caps_malloc(LUA_ALLOC_SLAB_BYTES, INTERNAL_CAPS);
+  if (!slab)
+    return NULL;
+
+  if (esp_ptr_external_ram(slab))
+    stats.slab_psram += LUA_ALLOC_SLAB_BYTES;
+  else
+    stats.slab_internal += LUA_ALLOC_SLAB_BYTES;
+  return slab;
+}
+
+// Carve a new slab into blocks of class c
+static bool growClass(int c) {
+  uint16_t block = class_sizes[c];
+  uint8_t *slab = newSlab();
+  if (!slab)
+    return false;
+
+  for (size_t off = 0; off + block <= LUA_ALLOC_SLAB_BYTES; off += block) {
+    FreeBlock *b = (FreeBlock *)(slab + off);
+    b->next = free_lists[c];
+    free_lists[c] = b;
+  }
+
+  stats.small[c].slab_bytes += LUA_ALLOC_SLAB_BYTES;
+  return true;
+}
+
+static void *smallAlloc(size_t size) {
+  int c = sizeClass(size);
+  if (!free_lists[c] && !growClass(c))
+    return NULL;
+
+  FreeBlock *b = free_lists[c];
+  free_lists[c] = b->next;
+
+  LuaAllocClassStats &s = stats.small[c];
+  s.live_blocks++;
+  s.live_bytes += size;
+  if (s.live_bytes > s.peak_bytes)
+    s.peak_bytes = s.live_bytes;
+  return b;
+}
+
+// Slabs are kept for reuse, freed blocks go back to their class
+static void smallFree(void *ptr, size_t size) {
+  int c = sizeClass(size);
+  FreeBlock *b = (FreeBlock *)ptr;
+  b->next = free_lists[c];
+  free_lists[c] = b;
+
+  LuaAllocClassStats &s = stats.small[c];
+  s.live_blocks--;
+  s.live_bytes -= size;
+}
+
+static LuaAllocTierStats &tierOf(void *ptr) {
+  return esp_ptr_external_ram(ptr) ? stats.psram : stats.internal;
+}
+
+static void tierAdd(LuaAllocTierStats &t, size_t size) {
+  t.live_blocks++;
+  t.live_bytes += size;
+  if (t.live_bytes > t.peak_bytes)
+    t.peak_bytes = t.live_bytes;
+}
+
+static void tierRemove(LuaAllocTierStats &t, size_t size) {
+  t.live_blocks--;
+  t.live_bytes -= size;
+}
+
+static bool wantsPsram(size_t size) {
+  return size >= LUA_ALLOC_PSRAM_MIN && psramFound();
+}
+
+// Either tier is used when the preferred one is full
+static void *largeAlloc(size_t size) {
+  void *ptr = NULL;
+  if (wantsPsram(size))
+    ptr = heap_caps_malloc(size, PSRAM_CAPS);
+  if (!ptr)
+    ptr = heap_caps_malloc(size, INTERNAL_CAPS);
+  if (!ptr && psramFound() && !wantsPsram(size))
+    ptr = heap_caps_malloc(size, PSRAM_CAPS);
+  if (ptr)
+    tierAdd(tierOf(ptr), size);
+  return ptr;
+}
+
+static void largeFree(void *ptr, size_t size) {
+  tierRemove(tierOf(ptr), size);
+  heap_caps_free(ptr);
+}
+
+static void *largeRealloc(void *ptr, size_t osize, size_t nsize) {
+  LuaAllocTierStats &t = tierOf(ptr);
+  bool in_psram = &t == &stats.psram;
+
+  // A block crossing LUA_ALLOC_PSRAM_MIN moves to the tier largeAlloc() would
+  // pick, in place when that tier is full
+  if (wantsPsram(nsize) != in_psram) {
+    void *nptr = largeAlloc(nsize);
+    if (nptr) {
+      memcpy(nptr, ptr, osize < nsize ? osize : nsize);
+      largeFree(ptr, osize);
+      return nptr;
+    }
+  }
+
+  void *nptr =
+      heap_caps_realloc(ptr, nsize, in_psram ? PSRAM_CAPS : INTERNAL_CAPS);
+  if (!nptr && !in_psram && psramFound()) {
+    // Internal RAM is full, spill the grown block to PSRAM
+    nptr = heap_caps_malloc(nsize, PSRAM_CAPS);
+    if (nptr) {
+      memcpy(nptr, ptr, osize < nsize ? osize : nsize);
+      largeFree(ptr, osize);
+      tierAdd(stats.psram, nsize);
+      return nptr;
+    }
+  }
+  if (!nptr) {
+    // Lua expects shrinking to succeed, the block then stays as it is
+    if (nsize > osize)
+      return NULL;
+    nptr = ptr;
+  }
+
+  tierRemove(t, osize);
+  tierAdd(t, nsize);
+  return nptr;
+}
+
+// A block that could not be moved into a smaller size class is kept and
+// handed to the new class on free, like a slab of one block
+static void *adoptBlock(void *ptr, size_t osize, size_t nsize) {
+  size_t held = osize;
+  if (osize > LUA_ALLOC_SMALL_MAX) {
+    tierRemove(tierOf(ptr), osize);
+    if (esp_ptr_external_ram(ptr))
+      stats.slab_psram += osize;
+    else
+      stats.slab_internal += osize;
+  } else {
+    LuaAllocClassStats &o = stats.small[sizeClass(osize)];
+    held = o.block_size;
+    o.slab_bytes -= held;
+    o.live_blocks--;
+    o.live_bytes -= osize;
+  }
+
+  LuaAllocClassStats &s = stats.small[sizeClass(nsize)];
+  s.slab_bytes += held;
+  s.live_blocks++;
+  s.live_bytes += nsize;
+  if (s.live_bytes > s.peak_bytes)
+    s.peak_bytes = s.live_bytes;
+  return ptr;
+}
+
+static void statsInit() {
+  for (int c = 0; c < LUA_ALLOC_NUM_CLASSES; c++) {
+    stats.small[c].block_size = class_sizes[c];
+  }
+  stats_ready = true;
+}
+
+void *luaAlloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+  (void)ud;
+
+  if (!stats_ready)
+    statsInit();
+
+  // For new blocks osize holds the object type, not a size
+  if (!ptr)
+    osize = 0;
+
+  if (nsize == 0) {
+    if (ptr) {
+      if (osize <= LUA_ALLOC_SMALL_MAX)
+        smallFree(ptr, osize);
+      else
+        largeFree(ptr, osize);
+    }
+    return NULL;
+  }
+
+  if (nsize > osize)
+    stats.allocated += nsize - osize;
+
+  bool small_old = ptr && osize <= LUA_ALLOC_SMALL_MAX;
+  bool small_new = nsize <= LUA_ALLOC_SMALL_MAX;
+
+  if (!ptr)
+    return small_new ? smallAlloc(nsize) : largeAlloc(nsize);
+
+  if (small_old && small_new && sizeClass(osize) == sizeClass(nsize)) {
+    // Still fits the same block, only the requested size changes
+    LuaAllocClassStats &s = stats.small[sizeClass(nsize)];
+    s.live_bytes += nsize - osize;
+    if (s.live_bytes > s.peak_bytes)
+      s.peak_bytes = s.live_bytes;
+    return ptr;
+  }
+
+  if (!small_old && !small_new)
+    return largeRealloc(ptr, osize, nsize);
+
+  // Moving between a size class and the large tiers, or between classes
+  void *nptr = small_new ? smallAlloc(nsize) : largeAlloc(nsize);
+  if (!nptr) {
+    // Lua expects shrinking to succeed: keep the larger block
+    if (nsize > osize)
+      return NULL;
+    return adoptBlock(ptr, osize, nsize);
+  }
+
+  memcpy(nptr, ptr, osize < nsize ? osize : nsize);
+  if (small_old)
+    smallFree(ptr, osize);
+  else
+    largeFree(ptr, osize);
+  return nptr;
+}
+
+static int panic(lua_State *L) {
+  const char *msg = lua_tostring(L, -1);
+  Serial.print("Lua panic: ");
+  Serial.println(msg ? msg : "error object is not a string");
+  return 0; // Lua aborts after the handler returns
+}
+
+lua_State *luaAllocNewState() {
+  lua_State *L = lua_newstate(luaAlloc, NULL);
+  if (L)
+    lua_atpanic(L, panic);
+  return L;
+}
+
+const LuaAllocStats &luaAllocStats() {
+  if (!stats_ready)
+    statsInit();
+  return stats;
+}
+
+// Share of slab memory not holding requested bytes, in percent
+static uint32_t fragmentation(const LuaAllocClassStats &s) {
+  if (!s.slab_bytes)
+    return 0;
+  return 100 - (uint64_t)s.live_bytes * 100 / s.slab_bytes;
+}
+
+void luaAllocPrintStats() {
+  const LuaAllocStats &st = luaAllocStats();
+
+  Serial.println("Lua heap: class live/peak/slab bytes, frag");
+  for (int c = 0; c < LUA_ALLOC_NUM_CLASSES; c++) {
+    const LuaAllocClassStats &s = st.small[c];
+    if (!s.slab_bytes)
+      continue;
+    Serial.printf("  %4u: %6lu/%6lu/%6lu %3lu%% (%lu blocks)\n",
+                  s.block_size, (unsigned long)s.live_bytes,
+                  (unsigned long)s.peak_bytes, (unsigned long)s.slab_bytes,
+                  (unsigned long)fragmentation(s),
+                  (unsigned long)s.live_blocks);
+  }
+  Serial.printf("  slabs: %lu internal, %lu psram bytes\n",
+                (unsigned long)st.slab_internal,
+                (unsigned long)st.slab_psram);
+  Serial.printf("  internal: %lu/%lu bytes (%lu blocks)\n",
+                (unsigned long)st.internal.live_bytes,
+                (unsigned long)st.internal.peak_bytes,
+                (unsigned long)st.internal.live_blocks);
+  Serial.printf("  psram:    %lu/%lu bytes (%lu blocks)\n",
+                (unsigned long)st.psram.live_bytes,
+                (unsigned long)st.psram.peak_bytes,
+                (unsigned long)st.psram.live_blocks);
+}
+
+static void pushTier(lua_State *L, const LuaAllocTierStats &t) {
+  lua_createtable(L, 0, 3);
+  lua_pushinteger(L, t.live_blocks);
+  lua_setfield(L, -2, "blocks");
+  lua_pushinteger(L, t.live_bytes);
+  lua_setfield(L, -2, "live");
+  lua_pushinteger(L, t.peak_bytes);
+  lua_setfield(L, -2, "peak");
+}
+
+// alloc.stats() -> { classes = { {size, blocks, live, peak, slab, frag}, ... },
+//                    internal = {...}, psram = {...}, allocated,
+//                    slab_internal, slab_psram }
+static int alloc_stats(lua_State *L) {
+  const LuaAllocStats &st = luaAllocStats();
+
+  lua_createtable(L, 0, 6);
+  lua_createtable(L, LUA_ALLOC_NUM_CLASSES, 0);
+  for (int c = 0; c < LUA_ALLOC_NUM_CLASSES; c++) {
+    const LuaAllocClassStats &s = st.small[c];
+    lua_createtable(L, 0, 6);
+    lua_pushinteger(L, s.block_size);
+    lua_setfield(L, -2, "size");
+    lua_pushinteger(L, s.live_blocks);
+    lua_setfield(L, -2, "blocks");
+    lua_pushinteger(L, s.live_bytes);
+    lua_setfield(L, -2, "live");
+    lua_pushinteger(L, s.peak_bytes);
+    lua_setfield(L, -2, "peak");
+    lua_pushinteger(L, s.slab_bytes);
+    lua_setfield(L, -2, "slab");
+    lua_pushinteger(L, fragmentation(s));
+    lua_setfield(L, -2, "frag");
+    lua_rawseti(L, -2, c + 1);
+  }
+  lua_setfield(L, -2, "classes");
+
+  pushTier(L, st.internal);
+  lua_setfield(L, -2, "internal");
+  pushTier(L, st.psram);
+  lua_setfield(L, -2, "psram");
+  lua_pushinteger(L, st.allocated);
+  lua_setfield(L, -2, "allocated");
+  lua_pushinteger(L, st.slab_internal);
+  lua_setfield(L, -2, "slab_internal");
+  lua_pushinteger(L, st.slab_psram);
+  lua_setfield(L, -2, "slab_psram");
+  return 1;
+}
+
+static int alloc_print(lua_State *L) {
+  luaAllocPrintStats();
+  return 0;
+}
+
+static const luaL_Reg alloc_lib[] = {
+    {"stats", alloc_stats},
+    {"print", alloc_print},
+    {NULL, NULL}};
+
+int luaopen_alloc(lua_State *L) {
+  luaL_newlib(L, alloc_lib);
+  return 1;
+}
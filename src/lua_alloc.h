@@ -0,0 +1,73 @@
+/**
+ * @file      lua_alloc.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+
+extern "C" {
+#include "lua.h"
+}
+
+// Blocks up to this size come from size-class slabs
+#ifndef LUA_ALLOC_SMALL_MAX
+#define LUA_ALLOC_SMALL_MAX 128
+#endif
+
+// Internal RAM carved into blocks of one size class at a time
+#ifndef LUA_ALLOC_SLAB_BYTES
+#define LUA_ALLOC_SLAB_BYTES 2048
+#endif
+
+// Internal RAM taken by slabs before new slabs come from PSRAM
+#ifndef LUA_ALLOC_SLAB_INTERNAL_MAX
+#define LUA_ALLOC_SLAB_INTERNAL_MAX (64 * 1024)
+#endif
+
+// Larger blocks from this size on go to PSRAM when it is available
+#ifndef LUA_ALLOC_PSRAM_MIN
+#define LUA_ALLOC_PSRAM_MIN 256
+#endif
+
+#define LUA_ALLOC_NUM_CLASSES 9
+
+struct LuaAllocClassStats {
+  uint16_t block_size;
+  uint32_t live_blocks;
+  uint32_t live_bytes; // requested bytes, without rounding to block_size
+  uint32_t peak_bytes;
+  uint32_t slab_bytes; // RAM held by slabs of this class
+};
+
+struct LuaAllocTierStats {
+  uint32_t live_blocks;
+  uint32_t live_bytes;
+  uint32_t peak_bytes;
+};
+
+struct LuaAllocStats {
+  LuaAllocClassStats small[LUA_ALLOC_NUM_CLASSES];
+  LuaAllocTierStats internal; // large blocks in internal RAM
+  LuaAllocTierStats psram;    // large blocks in PSRAM
+  uint32_t slab_internal;     // slab bytes in internal RAM
+  uint32_t slab_psram;        // slab bytes in PSRAM
+  uint32_t allocated;         // bytes requested since boot, wraps around
+};
+
+// lua_Alloc for lua_newstate(), ud is unused
+void *luaAlloc(void *ud, void *ptr, size_t osize, size_t nsize);
+
+// Create a state using luaAlloc, with a panic handler printing to Serial
+lua_State *luaAllocNewState();
+
+const LuaAllocStats &luaAllocStats();
+void luaAllocPrintStats();
+
+// Open the `alloc` module: alloc.stats() returns a table, alloc.print()
+// prints to the serial console
+int luaopen_alloc(lua_State *L);
@@ -0,0 +1,332 @@
+/**
+ * @file      lua_app.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "lua_app.h"
+#include "lua_alloc.h"
+#include "lua_async.h"
+#include "lua_gc.h"
+#include "lua_loader.h"
+#include "lua_profile.h"
+#include <lvgl.h>
+
+extern "C" {
+#include "lauxlib.h"
+#include "lualib.h"
+#include "luavgl.h"
+}
+
+// Run in every new state before the app script
+static const char prelude_src[] = R"(
+  local old_print = print
+  print = function(...)
+    local args = {...}
+    local text = ""
+    for i, v in ipairs(args) do
+      text = text .. tostring(v) .. (i < #args and "\t" or "")
+    end
+    old_print(text)
+  end
+)";
+
+// Shown when an app script is missing or fails
+static const char fallback_src[] = R"(
+  local root = lvgl.Object()
+  root:set { w = lvgl.HOR_RES(), h = lvgl.VER_RES() }
+
+  root:Label {
+    text = "Filesystem Error\nMake sure to upload data files",
+    align = lvgl.ALIGN.CENTER
+  }
+)";
+
+// Prelude bytecode, dumped from the first state and shared by later ones
+static char *prelude_code = NULL;
+static size_t prelude_len = 0;
+
+static lua_State *state = NULL;
+static lv_obj_t *root = NULL;
+static char name[LUA_APP_NAME_MAX] = "";
+static char pending[LUA_APP_NAME_MAX] = "";
+static LuaAppStats stats = {};
+
+// luaAlloc with a per app limit and accounting
+static void *appAlloc(void *ud, void *ptr, size_t osize, size_t nsize) {
+  size_t old = ptr ? osize : 0;
+  if (nsize > old &&
+      stats.heap_bytes + (nsize - old) > LUA_APP_HEAP_MAX_KB * 1024UL) {
+    return NULL;
+  }
+
+  void *p = luaAlloc(ud, ptr, osize, nsize);
+  if (p || nsize == 0) {
+    stats.heap_bytes = stats.heap_bytes - old + nsize;
+    if (stats.heap_bytes > stats.peak_bytes)
+      stats.peak_bytes = stats.heap_bytes;
+  }
+  return p;
+}
+
+static int preludeWrite(lua_State *L, const void *p, size_t size, void *ud) {
+  char *code = (char *)realloc(prelude_code, prelude_len + size);
+  if (!code)
+    return 1;
+  memcpy(code + prelude_len, p, size);
+  prelude_code = code;
+  prelude_len += size;
+  return 0;
+}
+
+static bool runPrelude(lua_State *L) {
+  int status;
+  if (prelude_code) {
+    status = luaL_loadbufferx(L, prelude_code, prelude_len, "=prelude", "b");
+  } else {
+    status = luaL_loadbufferx(L, prelude_src, sizeof(prelude_src) - 1,
+                              "=prelude", "t");
+    if (status == LUA_OK && lua_dump(L, preludeWrite, NULL, 1) != 0) {
+      free(prelude_code); // compiled again by the next app
+      prelude_code = NULL;
+      prelude_len = 0;
+    }
+  }
+
+  if (status != LUA_OK || lua_pcall(L, 0, 0, 0) != LUA_OK) {
+    Serial.print("Lua prelude error: ");
+    Serial.println(lua_tostring(L, -1));
+    lua_pop(L, 1);
+    return false;
+  }
+  return true;
+}
+
+// package.searchers entry loading modules from LUA_PATH
+static int searchScript(lua_State *L) {
+  const char *modname = luaL_checkstring(L, 1);
+  String filename = String(LUA_PATH) + modname + ".lua";
+
+  int status = luaLoadScript(L, filename.c_str());
+  if (status == LUA_ERRFILE) {
+    lua_pushfstring(L, "\n\t%s", lua_tostring(L, -1));
+    return 1; // Return the error message
+  }
+
+  if (status != LUA_OK) {
+    lua_error(L);
+  }
+
+  return 1; // Return the loaded chunk
+}
+
+static bool runScript(lua_State *L, const char *filename) {
+  String scriptPath = String(LUA_PATH) + filename;
+
+  uint32_t start = micros();
+  int status = luaLoadScript(L, scriptPath.c_str());
+  if (status == LUA_ERRFILE) {
+    Serial.print("Error loading Lua script: ");
+    Serial.println(scriptPath);
+    lua_pop(L, 1);
+    return false;
+  }
+  uint32_t loaded = micros();
+
+  Serial.print("Executing Lua script: ");
+  Serial.println(scriptPath);
+
+  if (status != LUA_OK || lua_pcall(L, 0, LUA_MULTRET, 0) != LUA_OK) {
+    Serial.print("Lua error: ");
+    Serial.println(lua_tostring(L, -1));
+    lua_pop(L, 1);
+    return false;
+  }
+
+  Serial.printf("Script load %lu us, run %lu us\n",
+                (unsigned long)(loaded - start),
+                (unsigned long)(micros() - loaded));
+  return true;
+}
+
+static bool setPending(const char *app) {
+  if (strlen(app) >= LUA_APP_NAME_MAX)
+    return false;
+  strcpy(pending, app);
+  return true;
+}
+
+// app.open(name) switches to LUA_PATH/<name>.lua once this callback returns
+static int app_open(lua_State *L) {
+  lua_pushboolean(L, setPending(luaL_checkstring(L, 1)));
+  return 1;
+}
+
+// app.exit() returns to LUA_APP_HOME
+static int app_exit(lua_State *L) {
+  setPending(LUA_APP_HOME);
+  return 0;
+}
+
+static int app_name(lua_State *L) {
+  lua_pushstring(L, name);
+  return 1;
+}
+
+static int app_stats(lua_State *L) {
+  lua_createtable(L, 0, 4);
+  lua_pushinteger(L, stats.open_us);
+  lua_setfield(L, -2, "open_us");
+  lua_pushinteger(L, stats.close_us);
+  lua_setfield(L, -2, "close_us");
+  lua_pushinteger(L, stats.heap_bytes);
+  lua_setfield(L, -2, "heap");
+  lua_pushinteger(L, stats.peak_bytes);
+  lua_setfield(L, -2, "peak");
+  return 1;
+}
+
+static const luaL_Reg app_lib[] = {
+    {"open", app_open},
+    {"exit", app_exit},
+    {"name", app_name},
+    {"stats", app_stats},
+    {NULL, NULL}};
+
+static int luaopen_app(lua_State *L) {
+  luaL_newlib(L, app_lib);
+  return 1;
+}
+
+// Libraries, luavgl on the app root, require() from LUA_PATH and the prelude
+static lua_State *newState(lv_obj_t *parent) {
+  lua_State *L = luaAllocNewState();
+  if (!L)
+    return NULL;
+
+  stats.heap_bytes = lua_gc(L, LUA_GCCOUNT) * 1024 + lua_gc(L, LUA_GCCOUNTB);
+  stats.peak_bytes = stats.heap_bytes;
+  lua_setallocf(L, appAlloc, NULL);
+
+  luaL_openlibs(L);
+
+  // Widgets created without a parent go to the app root
+  luavgl_set_root(L, parent);
+#if LUA_PROFILE
+  // Account every timer, event and animation callback: profile.print()
+  luavgl_set_pcall(L, luaProfilePcall);
+  luaL_requiref(L, "profile", luaopen_profile, 1);
+  lua_pop(L, 1);
+#endif
+  luaL_requiref(L, "lvgl", luaopen_lvgl, 1);
+  lua_pop(L, 1);
+
+  // Lua heap statistics: alloc.stats(), alloc.print()
+  luaL_requiref(L, "alloc", luaopen_alloc, 1);
+  lua_pop(L, 1);
+
+  luaL_requiref(L, "app", luaopen_app, 1);
+  lua_pop(L, 1);
+
+  // Collector mode; collection is mostly run from idle time in loop()
+  luaGcBegin(L);
+
+  // Coroutine tasks: async.spawn(), await(async.sleep(ms)), ...
+  luaAsyncBegin(L);
+
+  // Add our loader to the searchers table
+  lua_getglobal(L, "package");
+  lua_getfield(L, -1, "searchers");
+  lua_pushcfunction(L, searchScript);
+  lua_rawseti(L, -2, lua_rawlen(L, -2) + 1);
+  lua_pop(L, 2);
+
+  runPrelude(L);
+  return L;
+}
+
+void luaAppBegin() {
+  luaAppOpen(LUA_APP_HOME);
+}
+
+bool luaAppOpen(const char *app) {
+  if (strlen(app) >= LUA_APP_NAME_MAX)
+    return false;
+
+  luaAppClose();
+
+  uint32_t start = micros();
+  root = lv_obj_create(lv_screen_active());
+  state = newState(root);
+  if (!state) {
+    Serial.println("Failed to create Lua state");
+    lv_obj_delete(root);
+    root = NULL;
+    return false;
+  }
+  strcpy(name, app);
+
+  String filename = String(app) + ".lua";
+  bool ok = fs_mounted && runScript(state, filename.c_str());
+  if (!ok) {
+    Serial.printf("Failed to load app %s, using fallback\n", app);
+    if (luaL_dostring(state, fallback_src) != LUA_OK) {
+      Serial.print("Fallback script error: ");
+      Serial.println(lua_tostring(state, -1));
+    }
+    lua_settop(state, 0);
+  }
+
+  stats.open_us = micros() - start;
+  Serial.printf("App %s: open %lu us, heap %lu KB\n", name,
+                (unsigned long)stats.open_us,
+                (unsigned long)(stats.heap_bytes / 1024));
+  return ok;
+}
+
+void luaAppClose() {
+  if (!state)
+    return;
+
+  uint32_t start = micros();
+  uint32_t heap = stats.heap_bytes;
+
+  // Objects and timers of the app are deleted by their finalizers, then the
+  // rest of the root by luavgl
+  luaAsyncEnd(state);
+  lua_close(state);
+  lv_obj_delete(root);
+  state = NULL;
+  root = NULL;
+
+  stats.close_us = micros() - start;
+  stats.heap_bytes = 0;
+  stats.peak_bytes = 0;
+  Serial.printf("App %s: closed in %lu us, freed %lu KB\n", name,
+                (unsigned long)stats.close_us, (unsigned long)(heap / 1024));
+  name[0] = '\0';
+}
+
+void luaAppPoll() {
+  if (!pending[0])
+    return;
+
+  char app[LUA_APP_NAME_MAX];
+  strcpy(app, pending);
+  pending[0] = '\0';
+  luaAppOpen(app);
+}
+
+lua_State *luaAppState() {
+  return state;
+}
+
+const char *luaAppName() {
+  return name;
+}
+
+const LuaAppStats &luaAppStats() {
+  return stats;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file      lua_app.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+
+extern "C" {
+#include "lua.h"
+}
+
+// Directory holding the app scripts and modules for require()
+#ifndef LUA_PATH
+#define LUA_PATH "/lua/"
+#endif
+
+// App opened at boot and by app.exit()
+#ifndef LUA_APP_HOME
+#define LUA_APP_HOME "messenger"
+#endif
+
+// Lua heap limit of one app; beyond it allocations fail with a memory error
+#ifndef LUA_APP_HEAP_MAX_KB
+#define LUA_APP_HEAP_MAX_KB 512
+#endif
+
+#define LUA_APP_NAME_MAX 24
+
+struct LuaAppStats {
+  uint32_t open_us;    // state, prelude and script of the last opened app
+  uint32_t close_us;   // teardown of the last closed app
+  uint32_t heap_bytes; // Lua heap of the current app
+  uint32_t peak_bytes; // largest Lua heap of the current app
+};
+
+// Each app is a script in LUA_PATH running in its own lua_State, with its own
+// full screen luavgl root. Only one app is open: opening another one closes
+// the current one, which frees its whole Lua heap and widgets.
+//
+// New states run a prelude compiled once and kept as read-only bytecode,
+// instead of compiling it for every app.
+
+// Open LUA_APP_HOME
+void luaAppBegin();
+
+// Close the current app and open LUA_PATH/<name>.lua. Scripts use
+// app.open(name) instead, which switches on the next luaAppPoll()
+bool luaAppOpen(const char *name);
+
+void luaAppClose();
+
+// Run a switch requested by a script. Call from the main loop, outside of
+// lv_timer_handler()
+void luaAppPoll();
+
+// State of the current app, NULL if none is open
+lua_State *luaAppState();
+
+const char *luaAppName();
+const LuaAppStats &luaAppStats();
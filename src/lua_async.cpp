@@ -0,0 +1,331 @@
+/**
+ * @file      lua_async.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "lua_async.h"
+#include "scheduler.h"
+#include <LittleFS.h>
+#include <algorithm>
+#include <vector>
+
+extern "C" {
+#include "lauxlib.h"
+}
+
+// Operations are yielded as (tag, argument): the tag tells which one
+static const char tag_sleep = 0;
+static const char tag_read = 0;
+static const char tag_event = 0;
+
+// Registry key of the table name -> array of coroutines awaiting that event
+static const char events_key = 0;
+
+struct Sleeper {
+  uint32_t due;
+  int ref;
+  lua_State *co;
+};
+
+// Min-heap on due time, safe across millis() wrap around
+static bool sleeperLater(const Sleeper &a, const Sleeper &b) {
+  return (int32_t)(a.due - b.due) > 0;
+}
+
+struct FileRead {
+  fs::File file;
+  char *buf;
+  size_t size;
+  size_t pos;
+  bool failed;
+  int ref;
+  lua_State *co;
+};
+
+struct Post {
+  char name[LUA_ASYNC_NAME_MAX];
+  uint16_t len;
+  uint8_t data[LUA_ASYNC_POST_MAX];
+};
+
+static std::vector<Sleeper> sleepers;
+static std::vector<FileRead> reads;
+static uint32_t event_waiters = 0;
+static QueueHandle_t posts = NULL;
+
+static void resume(lua_State *L, lua_State *co, int ref, int nargs);
+
+// Release the coroutine once it finished or failed
+static void finish(lua_State *L, lua_State *co, int ref, int status) {
+  if (status != LUA_OK) {
+    luaL_traceback(L, co, lua_tostring(co, -1), 0);
+    Serial.print("Lua async error: ");
+    Serial.println(lua_tostring(L, -1));
+    lua_pop(L, 1);
+  }
+  luaL_unref(L, LUA_REGISTRYINDEX, ref);
+}
+
+// Park a coroutine that yielded (tag, argument) on the operation
+static void park(lua_State *L, lua_State *co, int ref, int nres) {
+  const void *tag = nres >= 1 ? lua_touserdata(co, -nres) : NULL;
+
+  if (tag == &tag_sleep) {
+    lua_Integer ms = lua_tointeger(co, -nres + 1);
+    Sleeper s = {millis() + (uint32_t)(ms > 0 ? ms : 0), ref, co};
+    sleepers.push_back(s);
+    std::push_heap(sleepers.begin(), sleepers.end(), sleeperLater);
+  } else if (tag == &tag_read) {
+    FileRead r = {};
+    r.ref = ref;
+    r.co = co;
+    r.file = LittleFS.open(lua_tostring(co, -nres + 1), "r");
+    r.size = r.file ? r.file.size() : 0;
+    r.buf = r.file ? (char *)malloc(r.size ? r.size : 1) : NULL;
+    r.failed = !r.buf;
+    reads.push_back(r);
+  } else if (tag == &tag_event) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, &events_key);
+    lua_pushstring(L, lua_tostring(co, -nres + 1));
+    if (lua_rawget(L, -2) != LUA_TTABLE) {
+      lua_pop(L, 1);
+      lua_newtable(L);
+      lua_pushstring(L, lua_tostring(co, -nres + 1));
+      lua_pushvalue(L, -2);
+      lua_rawset(L, -4);
+    }
+    lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+    lua_rawseti(L, -2, lua_rawlen(L, -2) + 1);
+    lua_pop(L, 2);
+    luaL_unref(L, LUA_REGISTRYINDEX, ref); // the waiter list holds it now
+    event_waiters++;
+  } else {
+    // Plain coroutine.yield() inside a task: resume on the next poll
+    Sleeper s = {millis(), ref, co};
+    sleepers.push_back(s);
+    std::push_heap(sleepers.begin(), sleepers.end(), sleeperLater);
+  }
+
+  lua_pop(co, nres);
+}
+
+static void resume(lua_State *L, lua_State *co, int ref, int nargs) {
+  int nres = 0;
+  int status = lua_resume(co, L, nargs, &nres);
+  if (status == LUA_YIELD) {
+    park(L, co, ref, nres);
+  } else {
+    finish(L, co, ref, status);
+  }
+}
+
+// async.spawn(fn, ...) starts fn as a coroutine right away, returns it
+static int async_spawn(lua_State *L) {
+  luaL_checktype(L, 1, LUA_TFUNCTION);
+  int nargs = lua_gettop(L) - 1;
+
+  lua_State *co = lua_newthread(L);
+  lua_pushvalue(L, -1);
+  int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+  lua_insert(L, 1); // keep the thread to return it
+
+  lua_xmove(L, co, nargs + 1); // function and arguments
+  resume(L, co, ref, nargs);
+
+  lua_settop(L, 1);
+  return 1;
+}
+
+static int async_sleep(lua_State *L) {
+  lua_Integer ms = luaL_optinteger(L, 1, 0);
+  lua_pushlightuserdata(L, (void *)&tag_sleep);
+  lua_pushinteger(L, ms);
+  return 2;
+}
+
+static int async_read_file(lua_State *L) {
+  luaL_checkstring(L, 1);
+  lua_pushlightuserdata(L, (void *)&tag_read);
+  lua_pushvalue(L, 1);
+  return 2;
+}
+
+static int async_event(lua_State *L) {
+  luaL_argcheck(L, luaL_len(L, 1) < LUA_ASYNC_NAME_MAX, 1, "name too long");
+  lua_pushlightuserdata(L, (void *)&tag_event);
+  lua_pushvalue(L, 1);
+  return 2;
+}
+
+// async.post(name, data) wakes the awaiters of name on the next poll
+static int async_post(lua_State *L) {
+  size_t len;
+  const char *name = luaL_checkstring(L, 1);
+  const char *data = luaL_optlstring(L, 2, "", &len);
+  lua_pushboolean(L, luaAsyncPost(name, data, len));
+  return 1;
+}
+
+static int async_await(lua_State *L) {
+  if (!lua_isyieldable(L))
+    return luaL_error(L, "await outside of async.spawn");
+  return lua_yield(L, lua_gettop(L));
+}
+
+static const luaL_Reg async_lib[] = {
+    {"spawn", async_spawn},
+    {"sleep", async_sleep},
+    {"read_file", async_read_file},
+    {"event", async_event},
+    {"post", async_post},
+    {NULL, NULL}};
+
+void luaAsyncBegin(lua_State *L) {
+  if (!posts)
+    posts = xQueueCreate(LUA_ASYNC_POST_QUEUE, sizeof(Post));
+
+  lua_newtable(L);
+  lua_rawsetp(L, LUA_REGISTRYINDEX, &events_key);
+
+  luaL_newlib(L, async_lib);
+  lua_setglobal(L, "async");
+  lua_pushcfunction(L, async_await);
+  lua_setglobal(L, "await");
+}
+
+bool luaAsyncPost(const char *name, const void *data, size_t len) {
+  if (!posts || strlen(name) >= LUA_ASYNC_NAME_MAX || len > LUA_ASYNC_POST_MAX)
+    return false;
+
+  Post post;
+  strcpy(post.name, name);
+  post.len = len;
+  memcpy(post.data, data, len);
+  if (xQueueSend(posts, &post, 0) != pdTRUE)
+    return false;
+
+  schedulerWake();
+  return true;
+}
+
+static void wakeEvent(lua_State *L, const Post &post) {
+  lua_rawgetp(L, LUA_REGISTRYINDEX, &events_key);
+  lua_pushstring(L, post.name);
+  if (lua_rawget(L, -2) != LUA_TTABLE) {
+    lua_pop(L, 2);
+    return;
+  }
+
+  // Take the list first, coroutines may await the same event again
+  lua_pushstring(L, post.name);
+  lua_pushnil(L);
+  lua_rawset(L, -4);
+
+  int n = lua_rawlen(L, -1);
+  for (int i = 1; i <= n; i++) {
+    lua_rawgeti(L, -1, i);
+    lua_State *co = lua_tothread(L, -1);
+    int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    event_waiters--;
+    lua_pushlstring(co, (const char *)post.data, post.len);
+    resume(L, co, ref, 1);
+  }
+  lua_pop(L, 2);
+}
+
+static void pumpReads(lua_State *L) {
+  for (size_t i = 0; i < reads.size();) {
+    FileRead &r = reads[i];
+    if (!r.failed && r.pos < r.size) {
+      size_t n = r.size - r.pos;
+      if (n > LUA_ASYNC_READ_CHUNK)
+        n = LUA_ASYNC_READ_CHUNK;
+      size_t got = r.file.read((uint8_t *)r.buf + r.pos, n);
+      r.pos += got;
+      r.failed = got != n;
+      if (!r.failed && r.pos < r.size) {
+        i++;
+        continue;
+      }
+    }
+
+    // Done: take it out before resuming, the coroutine may read again
+    FileRead done = r;
+    reads.erase(reads.begin() + i);
+    if (done.file)
+      done.file.close();
+
+    int nargs = 1;
+    if (done.failed) {
+      lua_pushnil(done.co);
+      lua_pushstring(done.co, "read failed");
+      nargs = 2;
+    } else {
+      lua_pushlstring(done.co, done.buf, done.size);
+    }
+    free(done.buf);
+    resume(L, done.co, done.ref, nargs);
+  }
+}
+
+uint32_t luaAsyncPoll(lua_State *L) {
+  if (!L)
+    return UINT32_MAX;
+
+  Post post;
+  while (posts && xQueueReceive(posts, &post, 0) == pdTRUE) {
+    wakeEvent(L, post);
+  }
+
+  pumpReads(L);
+
+  // Resume only sleepers due now, ones parked meanwhile wait for next poll
+  uint32_t now = millis();
+  static std::vector<Sleeper> due;
+  due.clear();
+  while (!sleepers.empty() && (int32_t)(now - sleepers.front().due) >= 0) {
+    std::pop_heap(sleepers.begin(), sleepers.end(), sleeperLater);
+    due.push_back(sleepers.back());
+    sleepers.pop_back();
+  }
+  for (size_t i = 0; i < due.size(); i++) {
+    resume(L, due[i].co, due[i].ref, 0);
+  }
+
+  if (!reads.empty())
+    return 0;
+  if (sleepers.empty())
+    return UINT32_MAX;
+
+  int32_t wait = sleepers.front().due - millis();
+  return wait > 0 ? wait : 0;
+}
+
+uint32_t luaAsyncPending() {
+  return sleepers.size() + reads.size() + event_waiters;
+}
+
+void luaAsyncEnd(lua_State *L) {
+  for (size_t i = 0; i < reads.size(); i++) {
+    if (reads[i].file)
+      reads[i].file.close();
+    free(reads[i].buf);
+  }
+
+  // The coroutines themselves go with the state
+  reads.clear();
+  sleepers.clear();
+  event_waiters = 0;
+
+  // Posts not delivered yet were meant for this state's waiters, the next
+  // app's tasks must not get them
+  Post post;
+  while (posts && xQueueReceive(posts, &post, 0) == pdTRUE) {
+  }
+
+  lua_pushnil(L);
+  lua_rawsetp(L, LUA_REGISTRYINDEX, &events_key);
+}
@@ -0,0 +1,58 @@
+/**
+ * @file      lua_async.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+
+extern "C" {
+#include "lua.h"
+}
+
+// Bytes of a file read per main loop iteration by async.read_file()
+#ifndef LUA_ASYNC_READ_CHUNK
+#define LUA_ASYNC_READ_CHUNK 1024
+#endif
+
+// Events posted with luaAsyncPost() waiting for the main loop
+#ifndef LUA_ASYNC_POST_QUEUE
+#define LUA_ASYNC_POST_QUEUE 8
+#endif
+
+// Largest event payload, enough for one LoRa packet
+#ifndef LUA_ASYNC_POST_MAX
+#define LUA_ASYNC_POST_MAX 256
+#endif
+
+#define LUA_ASYNC_NAME_MAX 16
+
+// Open the `async` module and the global `await`:
+//
+//   async.spawn(function()
+//     await(async.sleep(100))
+//     local data = await(async.read_file("/lua/utils.lua"))
+//     local packet = await(async.event("radio"))
+//   end)
+//
+// await() yields the current coroutine until the operation completes and
+// returns its result. Coroutines are resumed by luaAsyncPoll().
+void luaAsyncBegin(lua_State *L);
+
+// Resume coroutines whose operation completed. Call from the main loop;
+// returns the time in ms until a sleeping coroutine is due
+uint32_t luaAsyncPoll(lua_State *L);
+
+// Wake every coroutine awaiting async.event(name) with data as a string.
+// Can be called from any task, not from an ISR
+bool luaAsyncPost(const char *name, const void *data, size_t len);
+
+// Number of coroutines waiting on an operation
+uint32_t luaAsyncPending();
+
+// Drop every coroutine of L before lua_close(L), pending reads are closed
+void luaAsyncEnd(lua_State *L);
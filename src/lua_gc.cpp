@@ -0,0 +1,154 @@
+/**
+ * @file      lua_gc.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "lua_gc.h"
+
+#define REPORT_MS 10000
+
+bool lua_gc_debug = false;
+
+static LuaGcStats stats = {};  // since startup
+static LuaGcStats window = {}; // since the last report
+
+static bool stopped = false;  // automatic collection held off by us
+static bool overrun = false;  // heap grew too much while busy
+static int stop_kb = 0;       // heap size when it was held off
+static int last_idle_kb = 0;  // heap size after the last idle collection
+static uint32_t last_report = 0;
+
+static void histAdd(LuaGcHistogram &h, uint32_t us) {
+  int b = 0;
+  for (uint32_t limit = LUA_GC_HIST_MIN_US;
+       b < LUA_GC_HIST_BUCKETS - 1 && us >= limit; limit <<= 1) {
+    b++;
+  }
+
+  h.buckets[b]++;
+  h.count++;
+  if (us > h.max_us)
+    h.max_us = us;
+}
+
+uint32_t luaGcPercentile(const LuaGcHistogram &h, uint32_t percent) {
+  if (!h.count)
+    return 0;
+
+  uint32_t target = ((uint64_t)h.count * percent + 99) / 100;
+  uint32_t seen = 0;
+  for (int b = 0; b < LUA_GC_HIST_BUCKETS - 1; b++) {
+    seen += h.buckets[b];
+    if (seen >= target) {
+      uint32_t limit = (uint32_t)LUA_GC_HIST_MIN_US << b;
+      return limit < h.max_us ? limit : h.max_us;
+    }
+  }
+  return h.max_us;
+}
+
+static void printHist(const char *name, const LuaGcHistogram &h) {
+  Serial.printf("%s: n=%lu p50<=%lu p99<=%lu max=%lu us\n", name,
+                (unsigned long)h.count,
+                (unsigned long)luaGcPercentile(h, 50),
+                (unsigned long)luaGcPercentile(h, 99),
+                (unsigned long)h.max_us);
+}
+
+static void report(lua_State *L) {
+  uint32_t now = millis();
+  if (now - last_report < REPORT_MS)
+    return;
+  last_report = now;
+
+  if (lua_gc_debug) {
+    Serial.printf("Lua GC: %d KB in use, %lu deferred\n",
+                  lua_gc(L, LUA_GCCOUNT), (unsigned long)window.deferred);
+    printHist("  idle steps", window.steps);
+    printHist("  frames", window.frames);
+  }
+
+  // Printed distributions cover the last report window, luaGcStats() all
+  memset(&window, 0, sizeof(window));
+}
+
+void luaGcBegin(lua_State *L) {
+#if LUA_GC_GENERATIONAL
+  lua_gc(L, LUA_GCGEN, 0, 0);
+#else
+  lua_gc(L, LUA_GCINC, 0, 0, 0);
+#endif
+  stopped = false;
+  overrun = false;
+  last_idle_kb = lua_gc(L, LUA_GCCOUNT);
+  last_report = millis();
+}
+
+void luaGcSetBusy(lua_State *L, bool busy) {
+  if (!L)
+    return;
+
+  if (busy && !stopped && !overrun) {
+    lua_gc(L, LUA_GCSTOP);
+    stopped = true;
+    stop_kb = lua_gc(L, LUA_GCCOUNT);
+    stats.deferred++;
+    window.deferred++;
+  } else if (stopped &&
+             (!busy || lua_gc(L, LUA_GCCOUNT) - stop_kb > LUA_GC_DEFER_MAX_KB)) {
+    lua_gc(L, LUA_GCRESTART);
+    stopped = false;
+    overrun = busy;
+  }
+
+  if (!busy)
+    overrun = false;
+}
+
+uint32_t luaGcIdle(lua_State *L, uint32_t slack_us) {
+  if (!L)
+    return 0;
+
+  uint32_t start = micros();
+  uint32_t budget = slack_us < LUA_GC_BUDGET_US ? slack_us : LUA_GC_BUDGET_US;
+
+  int kb = lua_gc(L, LUA_GCCOUNT);
+  if (kb < last_idle_kb)
+    last_idle_kb = kb; // collected meanwhile
+
+  if (kb - last_idle_kb >= LUA_GC_IDLE_MIN_KB) {
+    uint32_t elapsed = 0;
+    while (elapsed < budget) {
+      uint32_t step_start = micros();
+#if LUA_GC_GENERATIONAL
+      // In generational mode a step is one young collection
+      lua_gc(L, LUA_GCSTEP, 0);
+      bool done = true;
+#else
+      bool done = lua_gc(L, LUA_GCSTEP, LUA_GC_STEP_KB);
+#endif
+      uint32_t now = micros();
+      histAdd(stats.steps, now - step_start);
+      histAdd(window.steps, now - step_start);
+      elapsed = now - start;
+      if (done)
+        break;
+    }
+    last_idle_kb = lua_gc(L, LUA_GCCOUNT);
+  }
+
+  report(L);
+  return micros() - start;
+}
+
+void luaGcFrameTime(uint32_t us) {
+  histAdd(stats.frames, us);
+  histAdd(window.frames, us);
+}
+
+const LuaGcStats &luaGcStats() {
+  return stats;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file      lua_gc.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+
+extern "C" {
+#include "lua.h"
+}
+
+// 1: generational collector, 0: incremental
+#ifndef LUA_GC_GENERATIONAL
+#define LUA_GC_GENERATIONAL 1
+#endif
+
+// Most time per main loop iteration spent collecting while the UI is idle
+#ifndef LUA_GC_BUDGET_US
+#define LUA_GC_BUDGET_US 2000
+#endif
+
+// Only collect when idle after this much new Lua heap
+#ifndef LUA_GC_IDLE_MIN_KB
+#define LUA_GC_IDLE_MIN_KB 4
+#endif
+
+// Work per incremental step, see lua_gc(LUA_GCSTEP)
+#ifndef LUA_GC_STEP_KB
+#define LUA_GC_STEP_KB 2
+#endif
+
+// Automatic collection is held off while the UI is busy (touch scrolling),
+// unless the heap grows by more than this meanwhile
+#ifndef LUA_GC_DEFER_MAX_KB
+#define LUA_GC_DEFER_MAX_KB 64
+#endif
+
+#define LUA_GC_HIST_BUCKETS 13
+#define LUA_GC_HIST_MIN_US 16
+
+// Durations in power of two buckets: bucket 0 is below 16 us, the last one is
+// 32 ms and above
+struct LuaGcHistogram {
+  uint32_t buckets[LUA_GC_HIST_BUCKETS];
+  uint32_t count;
+  uint32_t max_us;
+};
+
+struct LuaGcStats {
+  LuaGcHistogram steps;  // collector steps run from idle time
+  LuaGcHistogram frames; // lv_timer_handler() run time
+  uint32_t deferred;     // times automatic collection was held off
+};
+
+// Debug flag: print the histograms every few seconds
+extern bool lua_gc_debug;
+
+void luaGcBegin(lua_State *L);
+
+// Hold automatic collection off while busy, restart it afterwards
+void luaGcSetBusy(lua_State *L, bool busy);
+
+// Run collector steps within the idle slack, returns the time used
+uint32_t luaGcIdle(lua_State *L, uint32_t slack_us);
+
+// Record the duration of one lv_timer_handler() call
+void luaGcFrameTime(uint32_t us);
+
+// Upper bound of the bucket holding the given percentile, at most the
+// maximum, in us
+uint32_t luaGcPercentile(const LuaGcHistogram &h, uint32_t percent);
+
+// Totals since startup; the debug print covers the last report window only
+const LuaGcStats &luaGcStats();
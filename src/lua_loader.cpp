@@ -0,0 +1,227 @@
+/**
+ * @file      lua_loader.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "lua_loader.h"
+#include <LittleFS.h>
+extern "C" {
+#include <lauxlib.h>
+}
+
+struct LuacHeader {
+  char magic[4];
+  uint32_t source_hash;
+  uint32_t source_size;
+};
+
+// Streams a file into lua_load() one block at a time, so loading a script
+// needs one fixed block of heap however large the file is. The blocks can
+// be hashed on the way.
+struct FileBlockReader {
+  fs::File file;
+  bool hashing;
+  uint32_t hash;
+  char block[LUA_READER_BLOCK_SIZE];
+};
+
+static uint32_t fnv1a32(uint32_t hash, const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ data[i]) * 0x01000193;
+  }
+  return hash;
+}
+
+static const char *fileBlockRead(lua_State *L, void *ud, size_t *size) {
+  FileBlockReader *reader = (FileBlockReader *)ud;
+  *size = reader->file.read((uint8_t *)reader->block, sizeof(reader->block));
+  if (reader->hashing)
+    reader->hash = fnv1a32(reader->hash, (const uint8_t *)reader->block, *size);
+  return *size > 0 ? reader->block : NULL;
+}
+
+static void startHash(FileBlockReader *reader) {
+  reader->hashing = true;
+  reader->hash = 0x811C9DC5;
+}
+
+// Size of the source, read without its content
+struct SourceInfo {
+  bool exists; // and is not empty
+  uint32_t size;
+};
+
+static SourceInfo statSource(const char *path) {
+  SourceInfo info = {};
+  if (!fs_mounted || !LittleFS.exists(path))
+    return info;
+
+  fs::File file = LittleFS.open(path, "r");
+  if (!file)
+    return info;
+  info.size = file.size();
+  info.exists = info.size > 0;
+  file.close();
+  return info;
+}
+
+// Hash a file block by block; returns false if it cannot be read
+static bool hashFile(FileBlockReader *reader, const char *path,
+                     uint32_t *hash) {
+  reader->file = LittleFS.open(path, "r");
+  if (!reader->file)
+    return false;
+
+  size_t size;
+  startHash(reader);
+  while (fileBlockRead(NULL, reader, &size)) {
+  }
+  reader->hashing = false;
+  reader->file.close();
+  *hash = reader->hash;
+  return true;
+}
+
+static bool readCacheHeader(const char *cache_path, LuacHeader *header) {
+  if (!fs_mounted || !LittleFS.exists(cache_path))
+    return false;
+
+  fs::File file = LittleFS.open(cache_path, "r");
+  if (!file)
+    return false;
+  bool ok = file.read((uint8_t *)header, sizeof(*header)) == sizeof(*header) &&
+            memcmp(header->magic, LUAC_CACHE_MAGIC, sizeof(header->magic)) == 0;
+  file.close();
+  return ok;
+}
+
+// Whether the bytecode was compiled from the source. A source of another
+// size is rejected without reading it; otherwise it is always hashed, the
+// device has no clock to trust modification times by.
+static bool cacheIsCurrent(FileBlockReader *reader, const char *path,
+                           const SourceInfo &source, const LuacHeader &header) {
+  if (!source.exists)
+    return true; // bytecode shipped without its source
+  if (header.source_size != source.size)
+    return false;
+
+  uint32_t hash;
+  return hashFile(reader, path, &hash) && hash == header.source_hash;
+}
+
+// Load the bytecode of "<path>c" after its header
+static bool loadCached(lua_State *L, FileBlockReader *reader,
+                       const char *cache_path, const char *chunkname) {
+  reader->file = LittleFS.open(cache_path, "r");
+  if (!reader->file)
+    return false;
+
+  LuacHeader header;
+  bool loaded = false;
+  if (reader->file.read((uint8_t *)&header, sizeof(header)) ==
+      sizeof(header)) {
+    if (lua_load(L, fileBlockRead, reader, chunkname, "b") == LUA_OK) {
+      loaded = true;
+    } else {
+      // Bytecode from another Lua build, fall back to the source
+      Serial.print("Ignoring bytecode: ");
+      Serial.println(lua_tostring(L, -1));
+      lua_pop(L, 1);
+    }
+  }
+  reader->file.close();
+  return loaded;
+}
+
+static int cacheWriter(lua_State *L, const void *p, size_t size, void *ud) {
+  fs::File *file = (fs::File *)ud;
+  return file->write((const uint8_t *)p, size) == size ? 0 : 1;
+}
+
+// Dump the chunk on top of the stack to "<path>c"
+static void writeCache(lua_State *L, const char *cache_path,
+                       const SourceInfo &source, uint32_t source_hash) {
+  fs::File file = LittleFS.open(cache_path, "w");
+  if (!file)
+    return;
+
+  LuacHeader header;
+  memcpy(header.magic, LUAC_CACHE_MAGIC, sizeof(header.magic));
+  header.source_hash = source_hash;
+  header.source_size = source.size;
+
+  bool ok = file.write((const uint8_t *)&header, sizeof(header)) ==
+                sizeof(header) &&
+            lua_dump(L, cacheWriter, &file, 1) == 0;
+  file.close();
+
+  if (ok) {
+    Serial.print("Cached bytecode: ");
+    Serial.println(cache_path);
+  } else {
+    LittleFS.remove(cache_path);
+  }
+}
+
+static int loadFile(lua_State *L, FileBlockReader *reader, const char *path,
+                    const char *chunkname, const char *mode) {
+  if (!fs_mounted) {
+    lua_pushstring(L, "filesystem not mounted");
+    return LUA_ERRFILE;
+  }
+
+  reader->file = LittleFS.exists(path) ? LittleFS.open(path, "r") : fs::File();
+  if (!reader->file) {
+    lua_pushfstring(L, "no file '%s' in LittleFS", path);
+    return LUA_ERRFILE;
+  }
+
+  int status = lua_load(L, fileBlockRead, reader, chunkname, mode);
+  reader->file.close();
+  return status;
+}
+
+int luaLoadFile(lua_State *L, const char *path, const char *chunkname,
+                const char *mode) {
+  FileBlockReader *reader = new FileBlockReader();
+  int status = loadFile(L, reader, path, chunkname, mode);
+  delete reader;
+  return status;
+}
+
+int luaLoadScript(lua_State *L, const char *path) {
+  String cache_path = String(path) + "c";
+  String chunkname = String("@") + path;
+
+  FileBlockReader *reader = new FileBlockReader();
+  SourceInfo source = statSource(path);
+
+  LuacHeader header;
+  if (readCacheHeader(cache_path.c_str(), &header) &&
+      cacheIsCurrent(reader, path, source, header) &&
+      loadCached(L, reader, cache_path.c_str(), chunkname.c_str())) {
+    delete reader;
+    return LUA_OK;
+  }
+
+  if (!source.exists) {
+    delete reader;
+    lua_pushfstring(L, "no file '%s' in LittleFS", path);
+    return LUA_ERRFILE;
+  }
+
+  // The source is hashed while it is compiled, for the bytecode header
+  startHash(reader);
+  int status = loadFile(L, reader, path, chunkname.c_str(), "t");
+  uint32_t source_hash = reader->hash;
+  delete reader;
+#if LUAC_CACHE_WRITEBACK
+  if (status == LUA_OK) {
+    writeCache(L, cache_path.c_str(), source, source_hash);
+  }
+#endif
+  return status;
+}
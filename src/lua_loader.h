@@ -0,0 +1,46 @@
+/**
+ * @file      lua_loader.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+extern "C" {
+#include <lua.h>
+}
+
+// Precompiled scripts (name.luac) start with this magic followed by the
+// little-endian FNV-1a hash and size of the source they were built from.
+// A source of the same size is hashed before the bytecode is used.
+// Must match LUAC_CACHE_MAGIC in compile_lua.py
+#define LUAC_CACHE_MAGIC "MPL3"
+
+// Write bytecode back to LittleFS when a script had to be compiled on device
+#ifndef LUAC_CACHE_WRITEBACK
+#define LUAC_CACHE_WRITEBACK 1
+#endif
+
+// Set by setup() once LittleFS is mounted
+extern bool fs_mounted;
+
+// Block size used to stream files into the Lua parser
+#ifndef LUA_READER_BLOCK_SIZE
+#define LUA_READER_BLOCK_SIZE 1024
+#endif
+
+// Stream a file from LittleFS into lua_load() in LUA_READER_BLOCK_SIZE
+// blocks. Pushes the chunk, or an error message on failure; returns a
+// lua_load status, LUA_ERRFILE if the file does not exist.
+int luaLoadFile(lua_State *L, const char *path, const char *chunkname,
+                const char *mode);
+
+// Load a Lua script (e.g. "/lua/messenger.lua") without running it.
+// The precompiled "<path>c" is used when it matches the source, otherwise
+// the source is compiled and, with LUAC_CACHE_WRITEBACK, cached.
+// Pushes the chunk, or an error message on failure; returns a lua_load
+// status, LUA_ERRFILE if the script does not exist.
+int luaLoadScript(lua_State *L, const char *path);
@@ -0,0 +1,258 @@
+/**
+ * @file      lua_profile.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "lua_profile.h"
+#include "lua_alloc.h"
+#include <LittleFS.h>
+#include <algorithm>
+
+extern "C" {
+#include "lauxlib.h"
+#include "luavgl.h"
+}
+
+#define DEFAULT_DUMP_PATH "/profile.folded"
+
+bool lua_profile_enabled = false;
+
+struct Stack {
+  uint32_t hash;
+  uint32_t samples;
+  char frames[LUA_PROFILE_STACK_MAX];
+};
+
+static LuaProfileEntry entries[LUA_PROFILE_FUNCS];
+static int entry_count = 0;
+static Stack stacks[LUA_PROFILE_STACKS];
+static int stack_count = 0;
+static uint32_t dropped = 0;      // samples or callbacks without a free slot
+static uint32_t instructions = 0; // counted by the hook
+static int depth = 0;             // nested callbacks being profiled
+
+static uint32_t fnv1a(const char *s) {
+  uint32_t hash = 0x811c9dc5;
+  while (*s) {
+    hash = (hash ^ (uint8_t)*s++) * 0x01000193;
+  }
+  return hash;
+}
+
+// "source:line" into buf. short_src may be longer than buf, its start is cut
+// so the file name and the line stay.
+static void formatWhere(char *buf, size_t size, const lua_Debug *ar) {
+  // ':' and up to 10 digits of the line follow the source
+  int keep = size > 12 ? (int)size - 12 : 0;
+  const char *src = ar->short_src;
+  int len = strlen(src);
+  if (len > keep)
+    src += len - keep;
+
+  if (ar->linedefined > 0)
+    snprintf(buf, size, "%.*s:%d", keep, src, ar->linedefined);
+  else
+    snprintf(buf, size, "%.*s", keep, src);
+}
+
+// "source:line" of a frame's function, false for C functions
+static bool frameName(lua_State *L, lua_Debug *ar, char *buf, size_t size) {
+  lua_getinfo(L, "S", ar);
+  if (ar->what[0] == 'C')
+    return false;
+  formatWhere(buf, size, ar);
+  return true;
+}
+
+// Record the running stack, outermost frame first
+static void sampleStack(lua_State *L) {
+  char names[LUA_PROFILE_DEPTH][LUA_PROFILE_WHERE_MAX];
+  int n = 0;
+  lua_Debug ar;
+  for (int level = 0; n < LUA_PROFILE_DEPTH && lua_getstack(L, level, &ar);
+       level++) {
+    if (frameName(L, &ar, names[n], sizeof(names[n])))
+      n++;
+  }
+  if (!n)
+    return;
+
+  char frames[LUA_PROFILE_STACK_MAX];
+  size_t len = 0;
+  for (int i = n - 1; i >= 0 && len < sizeof(frames) - 1; i--) {
+    len += snprintf(frames + len, sizeof(frames) - len, i ? "%s;" : "%s",
+                    names[i]);
+  }
+
+  uint32_t hash = fnv1a(frames);
+  for (int i = 0; i < stack_count; i++) {
+    if (stacks[i].hash == hash && !strcmp(stacks[i].frames, frames)) {
+      stacks[i].samples++;
+      return;
+    }
+  }
+
+  if (stack_count == LUA_PROFILE_STACKS) {
+    dropped++;
+    return;
+  }
+
+  Stack &s = stacks[stack_count++];
+  s.hash = hash;
+  s.samples = 1;
+  strcpy(s.frames, frames);
+}
+
+static void hook(lua_State *L, lua_Debug *ar) {
+  if (!depth) {
+    // A coroutine created during a callback inherited the hook
+    lua_sethook(L, NULL, 0, 0);
+    return;
+  }
+
+  instructions += LUA_PROFILE_SAMPLE_COUNT;
+  sampleStack(L);
+}
+
+static LuaProfileEntry *findEntry(const char *where) {
+  for (int i = 0; i < entry_count; i++) {
+    if (!strcmp(entries[i].where, where))
+      return &entries[i];
+  }
+
+  if (entry_count == LUA_PROFILE_FUNCS)
+    return NULL;
+
+  LuaProfileEntry *e = &entries[entry_count++];
+  memset(e, 0, sizeof(*e));
+  strcpy(e->where, where);
+  return e;
+}
+
+int luaProfilePcall(lua_State *L, int nargs, int nresults) {
+  if (!lua_profile_enabled)
+    return luavgl_pcall(L, nargs, nresults);
+
+  char where[LUA_PROFILE_WHERE_MAX] = "?";
+  lua_Debug ar;
+  lua_pushvalue(L, -nargs - 1); // the callback
+  lua_getinfo(L, ">S", &ar);
+  if (ar.what[0] != 'C')
+    formatWhere(where, sizeof(where), &ar);
+
+  if (depth++ == 0)
+    lua_sethook(L, hook, LUA_MASKCOUNT, LUA_PROFILE_SAMPLE_COUNT);
+
+  uint32_t start_instructions = instructions;
+  uint32_t start_alloc = luaAllocStats().allocated;
+  uint32_t start = micros();
+
+  int status = luavgl_pcall(L, nargs, nresults);
+
+  uint32_t us = micros() - start;
+  if (--depth == 0)
+    lua_sethook(L, NULL, 0, 0);
+
+  LuaProfileEntry *e = findEntry(where);
+  if (!e) {
+    dropped++;
+    return status;
+  }
+
+  e->calls++;
+  e->total_us += us;
+  if (us > e->max_us)
+    e->max_us = us;
+  e->instructions += instructions - start_instructions;
+  e->alloc_bytes += luaAllocStats().allocated - start_alloc;
+  return status;
+}
+
+void luaProfileReset() {
+  entry_count = 0;
+  stack_count = 0;
+  dropped = 0;
+  instructions = 0;
+}
+
+static bool byTotalTime(const LuaProfileEntry *a, const LuaProfileEntry *b) {
+  return a->total_us > b->total_us;
+}
+
+void luaProfilePrint(int top) {
+  const LuaProfileEntry *sorted[LUA_PROFILE_FUNCS];
+  for (int i = 0; i < entry_count; i++) {
+    sorted[i] = &entries[i];
+  }
+  std::sort(sorted, sorted + entry_count, byTotalTime);
+
+  Serial.println("Lua callbacks: calls, total/max us, instructions, bytes");
+  for (int i = 0; i < entry_count && i < top; i++) {
+    const LuaProfileEntry *e = sorted[i];
+    Serial.printf("  %-32s %6lu %8lu/%6lu %9lu %8lu\n", e->where,
+                  (unsigned long)e->calls, (unsigned long)e->total_us,
+                  (unsigned long)e->max_us, (unsigned long)e->instructions,
+                  (unsigned long)e->alloc_bytes);
+  }
+  if (dropped)
+    Serial.printf("  %lu dropped, raise LUA_PROFILE_FUNCS/STACKS\n",
+                  (unsigned long)dropped);
+}
+
+bool luaProfileDump(const char *path) {
+  fs::File file = LittleFS.open(path, "w");
+  if (!file)
+    return false;
+
+  bool ok = true;
+  for (int i = 0; i < stack_count && ok; i++) {
+    char line[LUA_PROFILE_STACK_MAX + 16];
+    int len = snprintf(line, sizeof(line), "%s %lu\n", stacks[i].frames,
+                       (unsigned long)stacks[i].samples *
+                           LUA_PROFILE_SAMPLE_COUNT);
+    ok = file.write((const uint8_t *)line, len) == (size_t)len;
+  }
+  file.close();
+  return ok;
+}
+
+static int profile_start(lua_State *L) {
+  lua_profile_enabled = true;
+  return 0;
+}
+
+static int profile_stop(lua_State *L) {
+  lua_profile_enabled = false;
+  return 0;
+}
+
+static int profile_reset(lua_State *L) {
+  luaProfileReset();
+  return 0;
+}
+
+static int profile_print(lua_State *L) {
+  luaProfilePrint(luaL_optinteger(L, 1, 10));
+  return 0;
+}
+
+static int profile_dump(lua_State *L) {
+  lua_pushboolean(L, luaProfileDump(luaL_optstring(L, 1, DEFAULT_DUMP_PATH)));
+  return 1;
+}
+
+static const luaL_Reg profile_lib[] = {
+    {"start", profile_start},
+    {"stop", profile_stop},
+    {"reset", profile_reset},
+    {"print", profile_print},
+    {"dump", profile_dump},
+    {NULL, NULL}};
+
+int luaopen_profile(lua_State *L) {
+  luaL_newlib(L, profile_lib);
+  return 1;
+}
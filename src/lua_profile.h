@@ -0,0 +1,68 @@
+/**
+ * @file      lua_profile.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+
+extern "C" {
+#include "lua.h"
+}
+
+// 1: route luavgl timer, event and animation callbacks through the profiler
+#ifndef LUA_PROFILE
+#define LUA_PROFILE 0
+#endif
+
+// Callback functions accounted, by source:line
+#ifndef LUA_PROFILE_FUNCS
+#define LUA_PROFILE_FUNCS 32
+#endif
+
+// Distinct call stacks kept for the collapsed-stack dump
+#ifndef LUA_PROFILE_STACKS
+#define LUA_PROFILE_STACKS 64
+#endif
+
+// Lua instructions between two stack samples; instruction counts are
+// multiples of it
+#ifndef LUA_PROFILE_SAMPLE_COUNT
+#define LUA_PROFILE_SAMPLE_COUNT 1000
+#endif
+
+#define LUA_PROFILE_WHERE_MAX 40
+#define LUA_PROFILE_STACK_MAX 160
+#define LUA_PROFILE_DEPTH 8
+
+struct LuaProfileEntry {
+  char where[LUA_PROFILE_WHERE_MAX]; // source:line of the callback function
+  uint32_t calls;
+  uint32_t total_us; // wall time, including nested callbacks
+  uint32_t max_us;
+  uint32_t instructions; // sampled, LUA_PROFILE_SAMPLE_COUNT granularity
+  uint32_t alloc_bytes;  // bytes requested from luaAlloc
+};
+
+// Runtime switch, also set by profile.start() and profile.stop()
+extern bool lua_profile_enabled;
+
+// luavgl_pcall_t accounting each callback, see luavgl_set_pcall()
+int luaProfilePcall(lua_State *L, int nargs, int nresults);
+
+void luaProfileReset();
+
+// Print the top callbacks by total time to the serial console
+void luaProfilePrint(int top);
+
+// Write the sampled stacks as collapsed stacks ("a;b;c count" lines, counts
+// in Lua instructions), the input format of flamegraph.pl
+bool luaProfileDump(const char *path);
+
+// Open the `profile` module: profile.start(), profile.stop(),
+// profile.reset(), profile.print([top]), profile.dump([path])
+int luaopen_profile(lua_State *L);
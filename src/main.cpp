@@ -1,8 +1,17 @@
 #include "TouchDrvGT911.hpp"
+#include "i2c_bus.h"
+#include "keyboard_input.h"
+#include "lua_alloc.h"
+#include "lua_app.h"
+#include "lua_async.h"
+#include "lua_gc.h"
+#include "lua_loader.h"
+#include "scheduler.h"
+#include "touch_input.h"
 #include "utilities.h"
 #include <Arduino.h>
+#include <esp_heap_caps.h>
 #include <TFT_eSPI.h>
-#include <Ticker.h> // Include ticker for LVGL timing
 #include <Wire.h>
 #include <LittleFS.h>
 extern "C" {
@@ -19,74 +28,40 @@ extern "C" {
 #define LILYGO_KB_BRIGHTNESS_CMD 0x01
 #define LILYGO_KB_ALT_B_BRIGHTNESS_CMD 0x02
 
+// Read the keyboard when it raises BOARD_KEYBOARD_INT instead of polling it
+#ifndef KEYBOARD_USE_INT
+#define KEYBOARD_USE_INT 0
+#endif
+
+// Display flush backend selection (override from platformio.ini build_flags)
+// 1: two internal SRAM partial buffers flushed over SPI DMA
+// 0: one full-frame PSRAM buffer pushed with blocking SPI writes
+#ifndef DISPLAY_DMA_FLUSH
+#define DISPLAY_DMA_FLUSH 1
+#endif
+
+// Lines per partial render buffer in DMA mode. Must keep a strip below the
+// 16K pixel single-transaction limit of TFT_eSPI's pushImageDMA()
+#ifndef DISPLAY_DMA_BUF_LINES
+#define DISPLAY_DMA_BUF_LINES 40
+#endif
+
 // Data directory paths
-#define LUA_PATH "/lua/"
 #define SOUNDS_PATH "/sounds/"
 #define IMAGES_PATH "/images/"
 
-// Ticker for LVGL timing
-Ticker lvgl_ticker;
-
 // LVGL display and touch globals
 TFT_eSPI tft;
 TouchDrvGT911 touch;
-
-// LuaVGL state
-lua_State *L = NULL;
+static lv_indev_t *touch_indev = NULL;
+static lv_indev_t *kb_indev = NULL;
 
 // Keyboard variables
 bool keyboard_available = false;
-char last_key = 0;
 
 // Filesystem variables
 bool fs_mounted = false;
 
-// Helper functions for Lua file loading
-String readFile(const char* filename) {
-  if (!fs_mounted) {
-    Serial.println("Filesystem not mounted!");
-    return "";
-  }
-  
-  fs::File file = LittleFS.open(filename, "r");
-  if (!file) {
-    Serial.print("Failed to open file: ");
-    Serial.println(filename);
-    return "";
-  }
-  
-  String content = "";
-  while (file.available()) {
-    content += (char)file.read();
-  }
-  file.close();
-  
-  return content;
-}
-
-bool loadLuaScript(lua_State *L, const char* filename) {
-  String scriptPath = String(LUA_PATH) + filename;
-  String script = readFile(scriptPath.c_str());
-  
-  if (script.length() == 0) {
-    Serial.print("Error loading Lua script: ");
-    Serial.println(scriptPath);
-    return false;
-  }
-  
-  Serial.print("Executing Lua script: ");
-  Serial.println(scriptPath);
-  
-  if (luaL_dostring(L, script.c_str()) != 0) {
-    Serial.print("Lua error: ");
-    Serial.println(lua_tostring(L, -1));
-    lua_pop(L, 1);
-    return false;
-  }
-  
-  return true;
-}
-
 // LilyGo T-Deck control backlight chip has 16 levels of adjustment range
 // The adjustable range is 0~15, 0 is the minimum brightness, 15 is the maximum
 // brightness
@@ -114,20 +89,109 @@ void setBrightness(uint8_t value) {
   level = value;
 }
 
+// Display flush statistics, latched at the end of every refreshed frame
+struct FlushStats {
+  uint32_t frame_pixels; // pixels sent for the last refreshed frame
+  uint32_t frame_areas;  // address windows sent for the last refreshed frame
+  uint32_t frames;       // refreshed frames since boot
+  uint64_t total_pixels; // pixels sent since boot
+};
+FlushStats flush_stats = {};
+static uint32_t pending_pixels = 0;
+static uint32_t pending_areas = 0;
+
+// Debug flag for display flushes
+bool display_debug = false;
+
+static inline void count_flush(const lv_area_t *area) {
+  pending_pixels += lv_area_get_size(area);
+  pending_areas++;
+}
+
+#if DISPLAY_DMA_FLUSH
+static bool dma_in_flight = false;
+static void disp_dma_release(lv_display_t *disp);
+#endif
+
+static void disp_refr_ready_cb(lv_event_t *e) {
+#if DISPLAY_DMA_FLUSH
+  // LVGL only waits for a strip when it needs its buffer again, so the last
+  // strip of a frame would keep the SPI transaction open until the next one
+  disp_dma_release((lv_display_t *)lv_event_get_target(e));
+#endif
+
+  if (pending_areas == 0)
+    return;
+
+  if (flush_stats.frames == 0) {
+    Serial.print("First frame at ");
+    Serial.print(millis());
+    Serial.println(" ms");
+  }
+
+  flush_stats.frame_pixels = pending_pixels;
+  flush_stats.frame_areas = pending_areas;
+  flush_stats.frames++;
+  flush_stats.total_pixels += pending_pixels;
+  pending_pixels = 0;
+  pending_areas = 0;
+
+  if (display_debug) {
+    lv_glyph_cache_stats_t glyphs;
+    lv_glyph_cache_get_stats(&glyphs);
+    Serial.printf("Flushed %lu px in %lu areas, glyph cache %lu hits, "
+                  "%lu misses, %lu/%lu bytes\n",
+                  (unsigned long)flush_stats.frame_pixels,
+                  (unsigned long)flush_stats.frame_areas,
+                  (unsigned long)glyphs.hits, (unsigned long)glyphs.misses,
+                  (unsigned long)glyphs.size,
+                  (unsigned long)glyphs.max_size);
+  }
+}
+
+#if !DISPLAY_DMA_FLUSH
 // LVGL display driver
 static void disp_flush_cb(lv_display_t *disp, const lv_area_t *area,
                           uint8_t *px_map) {
   uint32_t w = (area->x2 - area->x1 + 1);
   uint32_t h = (area->y2 - area->y1 + 1);
+  count_flush(area);
   tft.startWrite();
   tft.setAddrWindow(area->x1, area->y1, w, h);
   tft.pushColors((uint16_t *)px_map, w * h, false);
   tft.endWrite();
   lv_display_flush_ready(disp);
 }
+#else
+// DMA display driver: queue the strip and return straight away so LVGL can
+// render the next strip into the other buffer while this one is sent
+static void disp_flush_dma_cb(lv_display_t *disp, const lv_area_t *area,
+                              uint8_t *px_map) {
+  uint32_t w = (area->x2 - area->x1 + 1);
+  uint32_t h = (area->y2 - area->y1 + 1);
+  count_flush(area);
+  tft.startWrite();
+  tft.pushImageDMA(area->x1, area->y1, w, h, (uint16_t const *)px_map);
+  dma_in_flight = true;
+}
 
-// Touch handling
-int16_t x[5], y[5];
+// Wait for the strip in flight and end its SPI transaction, so the bus is
+// free for the SD card and the radio again
+static void disp_dma_release(lv_display_t *disp) {
+  if (!dma_in_flight)
+    return;
+
+  tft.dmaWait();
+  tft.endWrite();
+  dma_in_flight = false;
+  lv_display_flush_ready(disp);
+}
+
+// Called by LVGL only when it needs the buffer that is still in flight.
+// TFT_eSPI owns the SPI post-transfer interrupt, so the completed transaction
+// is reaped here and the flush is reported ready to LVGL.
+static void disp_flush_wait_cb(lv_display_t *disp) { disp_dma_release(disp); }
+#endif
 
 // Debug flag for touch
 bool touch_debug = true;
@@ -138,6 +202,7 @@ void setKeyboardBrightness(uint8_t value) {
   if (!keyboard_available)
     return;
 
+  I2CBusGuard bus;
   Wire.beginTransmission(LILYGO_KB_SLAVE_ADDRESS);
   Wire.write(LILYGO_KB_BRIGHTNESS_CMD);
   Wire.write(value);
@@ -148,110 +213,81 @@ void setKeyboardDefaultBrightness(uint8_t value) {
   if (!keyboard_available)
     return;
 
+  I2CBusGuard bus;
   Wire.beginTransmission(LILYGO_KB_SLAVE_ADDRESS);
   Wire.write(LILYGO_KB_ALT_B_BRIGHTNESS_CMD);
   Wire.write(value);
   Wire.endTransmission();
 }
 
-// Keyboard state tracking variables
-static uint32_t last_key_code = 0;
-static bool key_is_new = false;
-static uint32_t last_key_time = 0;
-
-// LVGL keyboard read callback
+// Key events are queued by the keyboard task, so this never touches I2C.
+// Every queued press and release is handed to LVGL in one poll.
 static void keyboard_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
-  static bool was_pressed = false;
-  uint32_t current_time = millis();
-
-  // Read key from keyboard
-  char keyValue = 0;
-  Wire.requestFrom(LILYGO_KB_SLAVE_ADDRESS, 1);
-  if (Wire.available() > 0) {
-    keyValue = Wire.read();
-
-    if (keyValue != 0) {
-      // Check if this is a new key press or key has been held long enough for
-      // repeat
-      if (!was_pressed || (last_key_code != keyValue) ||
-          (current_time - last_key_time > 30)) {
-
-        last_key_code = keyValue;
-        last_key_time = current_time;
-        key_is_new = true;
-        was_pressed = true;
-
-        // Serial.print("Key registered: ");
-        // Serial.print(keyValue);
-        // Serial.print(" (");
-        // Serial.print((int)keyValue);
-        // Serial.println(")");
-      }
-    } else {
-      was_pressed = false;
-    }
-  }
+  static KeyEvent last = {0, 0, false};
 
-  // Report key press to LVGL
-  if (key_is_new) {
-    data->state = LV_INDEV_STATE_PRESSED;
-    key_is_new = false;
-
-    // Map special keys
-    if (last_key_code == 13) { // Enter
-      data->key = LV_KEY_ENTER;
-    } else if (last_key_code == 27) { // Escape
-      data->key = LV_KEY_ESC;
-    } else if (last_key_code == 8) { // Backspace
-      data->key = LV_KEY_BACKSPACE;
-    } else if (last_key_code == 9) { // Tab
-      data->key = LV_KEY_NEXT;
-    } else {
-      data->key = last_key_code;
-    }
+  KeyEvent event;
+  if (keyboardInputRead(event)) {
+    last = event;
+    data->continue_reading = keyboardInputPending();
 
     // Serial.print("Sending key to LVGL: ");
-    // Serial.println((char)data->key);
+    // Serial.println((char)last.key);
+  }
+
+  // Map special keys
+  if (last.key == 13) { // Enter
+    data->key = LV_KEY_ENTER;
+  } else if (last.key == 27) { // Escape
+    data->key = LV_KEY_ESC;
+  } else if (last.key == 8) { // Backspace
+    data->key = LV_KEY_BACKSPACE;
+  } else if (last.key == 9) { // Tab
+    data->key = LV_KEY_NEXT;
   } else {
-    data->state = LV_INDEV_STATE_RELEASED;
+    data->key = last.key;
   }
+
+  data->state = last.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
 }
 
+// Touch events are queued by the touch task, so this never touches I2C.
+// All queued events are handed to LVGL in one poll so none are lost.
 static void touchpad_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
-  data->state = LV_INDEV_STATE_RELEASED;
-
-  if (touch.isPressed()) {
-    uint8_t touched = touch.getPoint(x, y, touch.getSupportTouchPoint());
-    if (touched > 0) {
-      // Print touch coordinates for debugging (limit frequency to avoid
-      // flooding serial)
-      if (touch_debug && (millis() - last_touch_debug > 500)) {
-        // Serial.print("Touch detected! x=");
-        // Serial.print(x[0]);
-        // Serial.print(" y=");
-        // Serial.println(y[0]);
-        last_touch_debug = millis();
-      }
-
-      data->state = LV_INDEV_STATE_PRESSED;
-      data->point.x = x[0];
-      data->point.y = y[0];
+  static TouchEvent last = {0, 0, 0, false};
+
+  TouchEvent event;
+  if (touchInputRead(event)) {
+    last = event;
+    data->continue_reading = touchInputPending();
+
+    // Print touch coordinates for debugging (limit frequency to avoid
+    // flooding serial)
+    if (last.pressed && touch_debug && (millis() - last_touch_debug > 500)) {
+      // Serial.print("Touch detected! x=");
+      // Serial.print(last.x);
+      // Serial.print(" y=");
+      // Serial.println(last.y);
+      last_touch_debug = millis();
     }
   }
+
+  data->state = last.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+  data->point.x = last.x;
+  data->point.y = last.y;
 }
 
 // Setup LVGL
 void setupLvgl() {
-#define LVGL_BUFFER_SIZE (TFT_WIDTH * TFT_HEIGHT * sizeof(lv_color_t))
+  lv_init();
 
-  static uint8_t *buf = (uint8_t *)ps_malloc(LVGL_BUFFER_SIZE);
-  if (!buf) {
-    Serial.println("Memory allocation failed!");
-    delay(5000);
-    assert(buf);
-  }
+  // Unpacked glyphs are only read while blending, keep them in PSRAM and
+  // leave the LVGL heap to widgets and draw buffers
+  lv_glyph_cache_set_allocator(
+      [](size_t size) { return heap_caps_malloc(size, MALLOC_CAP_SPIRAM); },
+      heap_caps_free);
 
-  lv_init();
+  // Read the tick straight from the system timer instead of counting it
+  lv_tick_set_cb([]() -> uint32_t { return millis(); });
 
   // Create a default group for focusable objects
   lv_group_t *default_group = lv_group_create();
@@ -260,25 +296,70 @@ void setupLvgl() {
   // Create a display
   lv_display_t *disp = lv_display_create(TFT_HEIGHT, TFT_WIDTH);
 
+#if DISPLAY_DMA_FLUSH
+  // DMA cannot read the PSRAM framebuffer efficiently, so use two small
+  // strips in internal SRAM and let LVGL render only the dirty areas
+  uint32_t buf_size = lv_display_get_horizontal_resolution(disp) *
+                      DISPLAY_DMA_BUF_LINES *
+                      lv_color_format_get_size(lv_display_get_color_format(disp));
+
+  uint8_t *buf1 = (uint8_t *)heap_caps_malloc(
+      buf_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  uint8_t *buf2 = (uint8_t *)heap_caps_malloc(
+      buf_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  if (!buf1 || !buf2) {
+    Serial.println("Display DMA buffer allocation failed!");
+    delay(5000);
+    assert(buf1 && buf2);
+  }
+
+  tft.initDMA();
+
+  // Initialize the buffers
+  lv_display_set_buffers(disp, buf1, buf2, buf_size,
+                         LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+  lv_display_set_flush_cb(disp, disp_flush_dma_cb);
+  lv_display_set_flush_wait_cb(disp, disp_flush_wait_cb);
+#else
+#define LVGL_BUFFER_SIZE (TFT_WIDTH * TFT_HEIGHT * sizeof(lv_color_t))
+
+  static uint8_t *buf = (uint8_t *)ps_malloc(LVGL_BUFFER_SIZE);
+  if (!buf) {
+    Serial.println("Memory allocation failed!");
+    delay(5000);
+    assert(buf);
+  }
+
   // Initialize the buffer
   lv_display_set_buffers(disp, buf, NULL, LVGL_BUFFER_SIZE,
                          LV_DISPLAY_RENDER_MODE_FULL);
 
-  // Set display properties
   lv_display_set_flush_cb(disp, disp_flush_cb);
+#endif
+
+  // Set display properties
   lv_display_set_rotation(disp, LV_DISPLAY_ROTATION_0);
+  lv_display_add_event_cb(disp, disp_refr_ready_cb, LV_EVENT_REFR_READY, NULL);
 
   // Register a touchscreen input device
-  lv_indev_t *touch_indev = lv_indev_create();
+  // Input devices are read from loop() when their tasks queue events,
+  // not from a periodic LVGL timer
+  touch_indev = lv_indev_create();
   lv_indev_set_type(touch_indev, LV_INDEV_TYPE_POINTER);
   lv_indev_set_read_cb(touch_indev, touchpad_read_cb);
   lv_indev_set_display(touch_indev, disp);
+  lv_indev_set_mode(touch_indev, LV_INDEV_MODE_EVENT);
 
   // Register keyboard input device if available
   if (keyboard_available) {
-    lv_indev_t *kb_indev = lv_indev_create();
+    kb_indev = lv_indev_create();
     lv_indev_set_type(kb_indev, LV_INDEV_TYPE_KEYPAD);
     lv_indev_set_read_cb(kb_indev, keyboard_read_cb);
+    lv_indev_set_mode(kb_indev, LV_INDEV_MODE_EVENT);
+
+    // Repeat of held keys is generated by the keyboard task
+    lv_indev_set_long_press_time(kb_indev, UINT16_MAX);
 
     // Connect keyboard to the default group
     lv_indev_set_group(kb_indev, lv_group_get_default());
@@ -322,114 +403,10 @@ void createUI() {
 
 // Initialize LuaVGL
 void setupLuaVGL() {
-  // Create Lua state
-  L = luaL_newstate();
-  if (!L) {
-    Serial.println("Failed to create Lua state");
-    return;
-  }
-
-  // Open standard Lua libraries
-  luaL_openlibs(L);
-
-  // Initialize LuaVGL
-  luaL_requiref(L, "lvgl", luaopen_lvgl, 1);
-  lua_pop(L, 1);
-  
-  // Add Lua loader for require function
-  lua_getglobal(L, "package");
-  lua_getfield(L, -1, "searchers");
-  
-  // Get the length of the searchers table
-  int len = lua_rawlen(L, -1);
-  
-  // Custom loader function for the filesystem
-  lua_pushcfunction(L, [](lua_State *L) -> int {
-    const char *modname = luaL_checkstring(L, 1);
-    String filename = String(LUA_PATH) + modname + ".lua";
-    
-    String content = readFile(filename.c_str());
-    if (content.length() == 0) {
-      lua_pushfstring(L, "\n\tno file '%s' in LittleFS", filename.c_str());
-      return 1;  // Return the error message
-    }
-    
-    if (luaL_loadbuffer(L, content.c_str(), content.length(), filename.c_str()) != 0) {
-      lua_error(L);
-    }
-    
-    return 1;  // Return the loaded chunk
-  });
-  
-  // Add our loader to the searchers table
-  lua_rawseti(L, -2, len + 1);
-  lua_pop(L, 2);  // Pop package.searchers and package
-
-  // Setup print function to redirect to Serial
-  luaL_dostring(L, R"(
-    local old_print = print
-    print = function(...)
-      local args = {...}
-      local text = ""
-      for i, v in ipairs(args) do
-        text = text .. tostring(v) .. (i < #args and "\t" or "")
-      end
-      old_print(text)
-    end
-  )");
-
+  // Every app runs in its own Lua state, small blocks come from size-class
+  // slabs in internal RAM and large ones from PSRAM
+  luaAppBegin();
   Serial.println("LuaVGL environment initialized");
-  
-  // Load and run the main script
-  if (fs_mounted) {
-    if (loadLuaScript(L, "messenger.lua")) {
-      Serial.println("Messenger app loaded successfully");
-    } else {
-      Serial.println("Failed to load messenger app, using fallback");
-      
-      // Fallback to simple embedded script if the file isn't found
-      const char *fallbackScript = R"(
-        -- Fallback script when filesystem is not available
-        local root = lvgl.Object()
-        root:set { w = lvgl.HOR_RES(), h = lvgl.VER_RES() }
-        
-        root:Label {
-          text = "Filesystem Error\nMake sure to upload data files",
-          align = lvgl.ALIGN.CENTER
-        }
-        
-        return root
-      )";
-      
-      if (luaL_dostring(L, fallbackScript) != 0) {
-        Serial.print("Fallback script error: ");
-        Serial.println(lua_tostring(L, -1));
-        lua_pop(L, 1);
-      }
-    }
-  } else {
-    Serial.println("Filesystem not mounted, can't load Lua scripts");
-    
-    // Simple fallback UI when no filesystem
-    const char *fallbackScript = R"(
-      -- Fallback script when filesystem is not available
-      local root = lvgl.Object()
-      root:set { w = lvgl.HOR_RES(), h = lvgl.VER_RES() }
-      
-      root:Label {
-        text = "Filesystem Error\nMake sure to upload data files",
-        align = lvgl.ALIGN.CENTER
-      }
-      
-      return root
-    )";
-    
-    if (luaL_dostring(L, fallbackScript) != 0) {
-      Serial.print("Fallback script error: ");
-      Serial.println(lua_tostring(L, -1));
-      lua_pop(L, 1);
-    }
-  }
 }
 
 void setup() {
@@ -491,6 +468,7 @@ void setup() {
   delay(20);
 
   Wire.begin(BOARD_I2C_SDA, BOARD_I2C_SCL);
+  i2cBusInit();
 
   touch.setPins(-1, BOARD_TOUCH_INT);
   if (!touch.begin(Wire, GT911_SLAVE_ADDRESS_L)) {
@@ -520,14 +498,24 @@ void setup() {
     // Set initial keyboard brightness
     setKeyboardDefaultBrightness(127);
     setKeyboardBrightness(200);
+
+    // Read keys on a dedicated task
+#if KEYBOARD_USE_INT
+    keyboardInputBegin(LILYGO_KB_SLAVE_ADDRESS, BOARD_KEYBOARD_INT);
+#else
+    keyboardInputBegin(LILYGO_KB_SLAVE_ADDRESS, -1);
+#endif
   } else {
     Serial.println("T-Deck keyboard not found!");
   }
 
-  // LVGL tick function
-  lvgl_ticker.attach_ms(5, []() {
-    lv_tick_inc(5); // Increment LVGL tick counter every 5ms
-  });
+  // Read touch points only when the panel raises its interrupt
+  if (!touchInputBegin(touch, BOARD_TOUCH_INT)) {
+    Serial.println("Failed to start touch input!");
+  }
+
+  // Main loop sleeps until LVGL's next timer or an input event
+  schedulerBegin();
 
   // Initialize LVGL
   setupLvgl();
@@ -537,29 +525,69 @@ void setup() {
 
   // Create UI
   createUI();
+  luaAllocPrintStats();
 
   // Adjust backlight
   pinMode(BOARD_BL_PIN, OUTPUT);
   setBrightness(16);
 }
 
-void loop() {
-  // Handle LVGL tasks
-  lv_timer_handler();
-
-  // Check for touch directly from sensor (as additional test)
-  static unsigned long last_direct_check = 0;
-  if (millis() - last_direct_check > 300) {
-    if (touch.isPressed()) {
-      uint8_t touched = touch.getPoint(x, y, touch.getSupportTouchPoint());
-      if (touched > 0 && touch_debug) {
-        // Serial.print("Direct touch check: x=");
-        // Serial.print(x[0]);
-        // Serial.print(" y=");
-        // Serial.println(y[0]);
-      }
+// True while LVGL needs touch reads even without new events: to track a
+// held press and to let a released scroll coast
+static bool touch_active() {
+  return lv_indev_get_state(touch_indev) == LV_INDEV_STATE_PRESSED ||
+         lv_indev_get_scroll_obj(touch_indev) != NULL;
+}
+
+// Hand every queued input event to LVGL
+static void read_input_devices() {
+  if (touch_active() || touchInputPending()) {
+    do {
+      lv_indev_read(touch_indev);
+    } while (touchInputPending());
+  }
+
+  if (kb_indev) {
+    while (keyboardInputPending()) {
+      lv_indev_read(kb_indev);
     }
-    last_direct_check = millis();
+  }
+}
+
+void loop() {
+  // LVGL and the Lua state belong to this task while it is awake: other
+  // tasks only queue events, or take lv_lock() themselves. The draw threads
+  // never touch objects, they render the tasks lv_timer_handler() hands out
+  lv_lock();
+
+  read_input_devices();
+
+  // Switch apps when a script asked for it, then work on the current one
+  luaAppPoll();
+  lua_State *L = luaAppState();
+
+  // Resume Lua coroutines whose sleep, file read or event completed
+  uint32_t async_ms = luaAsyncPoll(L);
+
+  // Handle LVGL tasks, returns the time until the next timer is due
+  uint32_t frame_start = micros();
+  uint32_t idle_ms = lv_timer_handler();
+  luaGcFrameTime(micros() - frame_start);
+
+  bool busy = touch_active();
+  if (busy && idle_ms > LV_DEF_REFR_PERIOD) {
+    idle_ms = LV_DEF_REFR_PERIOD;
+  }
+  if (idle_ms > async_ms) {
+    idle_ms = async_ms;
+  }
+
+  // Keep the Lua collector out of frames while scrolling, and let it catch
+  // up in the idle time before the next timer
+  luaGcSetBusy(L, busy);
+  if (!busy && idle_ms > 0) {
+    uint32_t gc_ms = (luaGcIdle(L, idle_ms * 1000) + 999) / 1000;
+    idle_ms = gc_ms < idle_ms ? idle_ms - gc_ms : 0;
   }
 
   // Check keyboard directly (useful for debugging)
@@ -580,5 +608,7 @@ void loop() {
   //   last_kb_check = millis();
   // }
 
-  delay(5);
+  // Sleep until then, or until an input task wakes us
+  lv_unlock();
+  schedulerSleep(idle_ms);
 }
\ No newline at end of file
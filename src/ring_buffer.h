@@ -0,0 +1,63 @@
+/**
+ * @file      ring_buffer.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lock-free single-producer/single-consumer ring buffer.
+// One task (or ISR) pushes, one task pops; no locking is needed as long as
+// each side stays on its own end. Capacity must be a power of two.
+template <typename T, size_t Capacity> class RingBuffer {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "RingBuffer capacity must be a power of two");
+
+public:
+  // Producer side. Returns false if the buffer is full.
+  bool push(const T &item) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+      dropped_++;
+      return false;
+    }
+    items_[head & (Capacity - 1)] = item;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false if the buffer is empty.
+  bool pop(T &item) {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire))
+      return false;
+    item = items_[tail & (Capacity - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return tail_.load(std::memory_order_acquire) ==
+           head_.load(std::memory_order_acquire);
+  }
+
+  size_t size() const {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+  // Number of items rejected because the buffer was full
+  uint32_t dropped() const { return dropped_; }
+
+private:
+  T items_[Capacity];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+  uint32_t dropped_ = 0;
+};
@@ -0,0 +1,79 @@
+/**
+ * @file      scheduler.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "scheduler.h"
+
+bool scheduler_debug = false;
+
+static TaskHandle_t loop_task = NULL;
+static SchedulerStats stats = {};
+
+// Counters of the second in progress
+static uint32_t window_start = 0;
+static uint32_t wakeups = 0;
+static uint32_t event_wakeups = 0;
+static uint32_t busy_us = 0;
+static uint32_t awake_since = 0;
+
+void schedulerBegin() {
+  loop_task = xTaskGetCurrentTaskHandle();
+  window_start = millis();
+  awake_since = micros();
+}
+
+void schedulerSleep(uint32_t timeout_ms) {
+  if (timeout_ms > LOOP_MAX_SLEEP_MS)
+    timeout_ms = LOOP_MAX_SLEEP_MS;
+
+  busy_us += micros() - awake_since;
+
+  bool woken = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms)) > 0;
+
+  awake_since = micros();
+  wakeups++;
+  if (woken)
+    event_wakeups++;
+
+  uint32_t now = millis();
+  if (now - window_start >= 1000) {
+    stats.wakeups_per_sec = wakeups;
+    stats.event_wakeups = event_wakeups;
+    stats.busy_us = busy_us;
+    wakeups = 0;
+    event_wakeups = 0;
+    busy_us = 0;
+    window_start = now;
+
+    if (scheduler_debug) {
+      Serial.print("Loop wakeups/s: ");
+      Serial.print(stats.wakeups_per_sec);
+      Serial.print(" (events: ");
+      Serial.print(stats.event_wakeups);
+      Serial.print(") busy: ");
+      Serial.print(stats.busy_us / 1000);
+      Serial.println(" ms");
+    }
+  }
+}
+
+void schedulerWake() {
+  if (loop_task)
+    xTaskNotifyGive(loop_task);
+}
+
+void IRAM_ATTR schedulerWakeFromISR() {
+  if (!loop_task)
+    return;
+
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(loop_task, &woken);
+  if (woken)
+    portYIELD_FROM_ISR();
+}
+
+const SchedulerStats &schedulerStats() { return stats; }
@@ -0,0 +1,38 @@
+/**
+ * @file      scheduler.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include <Arduino.h>
+
+// Longest time the main loop sleeps, even if LVGL has nothing scheduled
+#ifndef LOOP_MAX_SLEEP_MS
+#define LOOP_MAX_SLEEP_MS 1000
+#endif
+
+struct SchedulerStats {
+  uint32_t wakeups_per_sec; // main loop iterations in the last second
+  uint32_t event_wakeups;   // of those, woken early by schedulerWake()
+  uint32_t busy_us;         // time spent awake in the last second
+};
+
+// Debug flag: print the stats once per second
+extern bool scheduler_debug;
+
+// Must be called from the main loop task
+void schedulerBegin();
+
+// Block the main loop for up to timeout_ms or until it is woken
+void schedulerSleep(uint32_t timeout_ms);
+
+// Wake the main loop early, e.g. after input, radio or audio events
+void schedulerWake();
+void schedulerWakeFromISR();
+
+// Stats of the last complete second
+const SchedulerStats &schedulerStats();
@@ -0,0 +1,96 @@
+/**
+ * @file      touch_input.cpp
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#include "touch_input.h"
+#include "i2c_bus.h"
+#include "ring_buffer.h"
+#include "scheduler.h"
+
+static TouchDrvGT911 *touch_drv = NULL;
+static TaskHandle_t touch_task = NULL;
+static RingBuffer<TouchEvent, 64> touch_events;
+
+static void IRAM_ATTR touch_isr() {
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(touch_task, &woken);
+  if (woken)
+    portYIELD_FROM_ISR();
+}
+
+static void touch_task_fn(void *param) {
+  int16_t x[5], y[5];
+  TouchEvent last = {0, 0, 0, false};
+
+  for (;;) {
+    // Sleep until the panel reports. While pressed, also wake up after a
+    // missed pulse so a lifted finger is always reported as a release.
+    ulTaskNotifyTake(pdTRUE, last.pressed
+                                 ? pdMS_TO_TICKS(TOUCH_RELEASE_TIMEOUT_MS)
+                                 : portMAX_DELAY);
+
+    uint8_t touched;
+    {
+      I2CBusGuard bus;
+      touched = touch_drv->getPoint(x, y, touch_drv->getSupportTouchPoint());
+    }
+
+    if (touched > 0) {
+      last.time = millis();
+      last.x = x[0];
+      last.y = y[0];
+      last.pressed = true;
+      touch_events.push(last);
+      schedulerWake();
+    } else if (last.pressed) {
+      // Report the release at the last known position
+      last.time = millis();
+      last.pressed = false;
+      touch_events.push(last);
+      schedulerWake();
+    }
+  }
+}
+
+bool touchInputBegin(TouchDrvGT911 &touch, int irq_pin) {
+  touch_drv = &touch;
+
+  // Follow the trigger mode configured in the panel firmware
+  int mode;
+  {
+    I2CBusGuard bus;
+    switch (touch.getInterruptMode()) {
+    case 0x00:
+      mode = RISING;
+      break;
+    case 0x01:
+      mode = FALLING;
+      break;
+    default:
+      mode = CHANGE;
+      break;
+    }
+  }
+
+  if (xTaskCreatePinnedToCore(touch_task_fn, "touch", 3072, NULL, 2,
+                              &touch_task, ARDUINO_RUNNING_CORE) != pdPASS) {
+    Serial.println("Failed to create touch task");
+    return false;
+  }
+
+  attachInterrupt(digitalPinToInterrupt(irq_pin), touch_isr, mode);
+
+  // Pick up a finger that is already down
+  xTaskNotifyGive(touch_task);
+  return true;
+}
+
+bool touchInputRead(TouchEvent &event) { return touch_events.pop(event); }
+
+bool touchInputPending() { return !touch_events.empty(); }
+
+uint32_t touchInputDropped() { return touch_events.dropped(); }
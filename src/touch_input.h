@@ -0,0 +1,38 @@
+/**
+ * @file      touch_input.h
+ * @author    MeshPunk Project
+ * @license   MIT
+ * @copyright Copyright (c) 2023
+ * @date      2023-12-03
+ *
+ */
+#pragma once
+
+#include "TouchDrvGT911.hpp"
+#include <Arduino.h>
+
+// Time without an INT pulse after which a pressed touch is re-checked
+// (the GT911 pulses INT on every report while a finger is down)
+#ifndef TOUCH_RELEASE_TIMEOUT_MS
+#define TOUCH_RELEASE_TIMEOUT_MS 40
+#endif
+
+struct TouchEvent {
+  uint32_t time; // millis() when the point was read
+  int16_t x;
+  int16_t y;
+  bool pressed;
+};
+
+// Start the interrupt driven reader. The GT911 is only read over I2C after
+// it raises irq_pin; points are queued for touchInputRead().
+bool touchInputBegin(TouchDrvGT911 &touch, int irq_pin);
+
+// Pop the oldest queued touch event. Returns false if none is pending.
+bool touchInputRead(TouchEvent &event);
+
+// True if more touch events are queued
+bool touchInputPending();
+
+// Number of events dropped because the queue was full
+uint32_t touchInputDropped();